@@ -0,0 +1,107 @@
+// benchmarks/benchmark_harness.hpp
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+/**
+ * @brief Result of one benchmark case
+ *
+ * Times are per iteration; bytes is the payload handled by one iteration and
+ * is used to report throughput when non-zero.
+ */
+struct Result {
+    std::string name;
+    std::size_t iterations = 0;
+    double meanNs = 0;
+    double minNs = 0;
+    double medianNs = 0;
+    std::size_t bytes = 0;
+};
+
+// Keeps the optimizer from discarding a computed value
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * @brief Runs a body repeatedly and collects timing samples
+ *
+ * The body is first run until a batch takes at least minBatchTime, so that
+ * short operations are timed over many calls; then `samples` batches are
+ * timed and the per-iteration mean, minimum and median are reported.
+ */
+inline Result run(const std::string& name, const std::function<void()>& body,
+                  std::size_t bytes = 0, std::size_t samples = 15,
+                  std::chrono::nanoseconds minBatchTime = std::chrono::milliseconds(20)) {
+    using Clock = std::chrono::steady_clock;
+
+    std::size_t batch = 1;
+    for (;;) {
+        auto start = Clock::now();
+        for (std::size_t i = 0; i < batch; ++i) {
+            body();
+        }
+        if (Clock::now() - start >= minBatchTime || batch >= (std::size_t{1} << 30)) {
+            break;
+        }
+        batch *= 2;
+    }
+
+    std::vector<double> perIteration;
+    perIteration.reserve(samples);
+    for (std::size_t s = 0; s < samples; ++s) {
+        auto start = Clock::now();
+        for (std::size_t i = 0; i < batch; ++i) {
+            body();
+        }
+        std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+        perIteration.push_back(elapsed.count() / static_cast<double>(batch));
+    }
+
+    Result result;
+    result.name = name;
+    result.iterations = batch * samples;
+    result.bytes = bytes;
+    double total = 0;
+    for (double ns : perIteration) {
+        total += ns;
+    }
+    result.meanNs = total / static_cast<double>(perIteration.size());
+    std::sort(perIteration.begin(), perIteration.end());
+    result.minNs = perIteration.front();
+    result.medianNs = perIteration[perIteration.size() / 2];
+    return result;
+}
+
+/**
+ * @brief Writes results as a JSON array, one object per case
+ *
+ * The format is stable so runs can be diffed or fed to a plotting script.
+ */
+inline void writeJSON(std::ostream& out, const std::vector<Result>& results) {
+    out << "[\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        out << "  {\"name\": \"" << r.name << "\""
+            << ", \"iterations\": " << r.iterations
+            << ", \"mean_ns\": " << r.meanNs
+            << ", \"min_ns\": " << r.minNs
+            << ", \"median_ns\": " << r.medianNs;
+        if (r.bytes != 0 && r.medianNs > 0) {
+            double mbPerSecond = static_cast<double>(r.bytes) / r.medianNs * 1e9 / (1024.0 * 1024.0);
+            out << ", \"bytes\": " << r.bytes << ", \"mb_per_s\": " << mbPerSecond;
+        }
+        out << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "]\n";
+}
+
+} // namespace bench
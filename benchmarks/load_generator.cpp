@@ -0,0 +1,223 @@
+// benchmarks/load_generator.cpp
+//
+// Drives requests against an in-process MockOpenAIServer and reports latency
+// percentiles and throughput as JSON.
+//
+//   load_generator [--target transport|session] [--client curl|curl-multi]
+//                  [--concurrency N] [--rate R] [--requests N]
+//                  [--latency-ms MS] [--jitter-ms MS] [--body-bytes N]
+//                  [--stream on|off] [--tool-calls N] [--unix-socket PATH]
+//
+// --rate 0 (the default) runs closed-loop: each worker sends its next request
+// as soon as the previous one completes.  A positive rate schedules requests
+// at fixed intervals and measures latency from the scheduled start, so a
+// slow client cannot hide queueing delay.  --unix-socket serves over a Unix
+// domain socket instead of loopback TCP, for comparing the two.
+#include "mock_openai_server.hpp"
+#include "http_client/curl_http_client.hpp"
+#include "http_client/curl_multi_http_client.hpp"
+#include "session/llm_session.hpp"
+#include "core/streamsource.hpp"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+struct Options {
+    std::string target = "transport";
+    std::string client = "curl-multi";
+    std::size_t concurrency = 8;
+    double rate = 0;
+    std::size_t requests = 2000;
+    bench::MockServerOptions server;
+    bool stream = false;
+};
+
+Options parseOptions(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        std::string value = argv[i + 1];
+        if (arg == "--target") {
+            options.target = value;
+        } else if (arg == "--client") {
+            options.client = value;
+        } else if (arg == "--concurrency") {
+            options.concurrency = std::max<std::size_t>(1, std::stoul(value));
+        } else if (arg == "--rate") {
+            options.rate = std::stod(value);
+        } else if (arg == "--requests") {
+            options.requests = std::stoul(value);
+        } else if (arg == "--latency-ms") {
+            options.server.latency = std::chrono::milliseconds(std::stol(value));
+        } else if (arg == "--jitter-ms") {
+            options.server.jitter = std::chrono::milliseconds(std::stol(value));
+        } else if (arg == "--body-bytes") {
+            options.server.contentBytes = std::stoul(value);
+        } else if (arg == "--stream") {
+            options.stream = value == "on" || value == "true";
+        } else if (arg == "--tool-calls") {
+            options.server.toolCalls = std::stoi(value);
+        } else if (arg == "--unix-socket") {
+            options.server.unixSocketPath = value;
+        } else {
+            throw std::runtime_error("Unknown argument: " + arg);
+        }
+    }
+    return options;
+}
+
+std::shared_ptr<http_client::IHTTPClient> makeClient(const std::string& name) {
+    if (name == "curl") {
+        return std::make_shared<http_client::CurlHTTPClient>();
+    }
+    if (name == "curl-multi") {
+        return std::make_shared<http_client::CurlMultiHTTPClient>();
+    }
+    throw std::runtime_error("Unknown client: " + name);
+}
+
+// A one-turn conversation as a request body
+std::string transportRequestBody(bool stream) {
+    return std::string(R"({"messages":[{"content":"You are terse.","role":"system"},)"
+                       R"({"content":"What is the weather in Paris?","role":"user"}],"model":"mock-gpt","stream":)") +
+           (stream ? "true" : "false") + "}";
+}
+
+// Script fed to a fresh LLMSession for every request
+std::string sessionScript(const std::string& uri, bool stream) {
+    return "#URI " + uri + "\n"
+           "#API_KEY_NAME MOCK_KEY\n"
+           "#MODEL mock-gpt\n"
+           "#TRANSLATOR openai\n"
+           "#CACHE off\n" +
+           std::string(stream ? "#STREAM on\n" : "") +
+           "#system You are terse.\n"
+           "What is the weather in Paris?\n";
+}
+
+Tool weatherTool() {
+    Tool tool;
+    tool.name = "get_weather";
+    tool.description = "Get the current weather for a location";
+    Parameter location;
+    location.name = "location";
+    location.type = "string";
+    location.required = true;
+    tool.parameters.push_back(location);
+    tool.function = [](const std::string&) { return std::string("Sunny"); };
+    return tool;
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    auto index = static_cast<std::size_t>(p / 100.0 * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        Options options = parseOptions(argc, argv);
+        spdlog::set_level(spdlog::level::warn);
+
+        bench::MockOpenAIServer server(options.server);
+        auto client = makeClient(options.client);
+        const std::string uri = server.uri();
+        const std::string body = transportRequestBody(options.stream);
+        const std::vector<std::string> headers = {"Content-Type: application/json", "Authorization: Bearer mock"};
+        const std::string script = sessionScript(uri, options.stream);
+
+        using Clock = std::chrono::steady_clock;
+        std::vector<double> latenciesMs(options.requests, 0);
+        std::atomic<std::size_t> next{0};
+        std::atomic<std::size_t> errors{0};
+        std::mutex errorMutex;
+        std::map<std::string, std::size_t> errorCounts;
+
+        auto runOne = [&]() {
+            if (options.target == "session") {
+                std::istringstream input(script);
+                StreamSource source(input);
+                std::ostringstream discard;
+                LLMSession session(client);
+                session.setOutput(discard);
+                session.setApiKeyResolver([](const std::string&) { return std::string("mock"); });
+                session.addTool(weatherTool());
+                session.processMessages(source);
+                return;
+            }
+            http_client::HTTPResponse response;
+            if (options.stream) {
+                std::size_t received = 0;
+                response = client->PostStreaming(uri, body, headers,
+                    [&received](std::string_view chunk) { received += chunk.size(); }).get();
+            } else {
+                response = client->Post(uri, body, headers).get();
+            }
+            if (response.statusCode != 200) {
+                throw std::runtime_error("HTTP " + std::to_string(response.statusCode));
+            }
+        };
+
+        const auto start = Clock::now();
+        auto worker = [&]() {
+            for (std::size_t i = next++; i < options.requests; i = next++) {
+                auto scheduled = Clock::now();
+                if (options.rate > 0) {
+                    scheduled = start + std::chrono::duration_cast<Clock::duration>(
+                        std::chrono::duration<double>(static_cast<double>(i) / options.rate));
+                    std::this_thread::sleep_until(scheduled);
+                }
+                try {
+                    runOne();
+                } catch (const std::exception& e) {
+                    ++errors;
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    ++errorCounts[e.what()];
+                }
+                latenciesMs[i] = std::chrono::duration<double, std::milli>(Clock::now() - scheduled).count();
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (std::size_t i = 0; i < options.concurrency; ++i) {
+            threads.emplace_back(worker);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        std::sort(latenciesMs.begin(), latenciesMs.end());
+        std::cout << "{\"target\": \"" << options.target << "\", \"client\": \"" << options.client << "\""
+                  << ", \"concurrency\": " << options.concurrency << ", \"rate\": " << options.rate
+                  << ", \"stream\": " << (options.stream ? "true" : "false")
+                  << ", \"unix_socket\": " << (options.server.unixSocketPath.empty() ? "false" : "true")
+                  << ", \"requests\": " << options.requests << ", \"errors\": " << errors.load()
+                  << ", \"server_requests\": " << server.requestsServed()
+                  << ", \"connections\": " << server.acceptedConnections()
+                  << ", \"seconds\": " << seconds
+                  << ", \"requests_per_s\": " << static_cast<double>(options.requests) / seconds
+                  << ", \"p50_ms\": " << percentile(latenciesMs, 50)
+                  << ", \"p90_ms\": " << percentile(latenciesMs, 90)
+                  << ", \"p99_ms\": " << percentile(latenciesMs, 99)
+                  << ", \"max_ms\": " << (latenciesMs.empty() ? 0 : latenciesMs.back()) << "}" << std::endl;
+        for (const auto& [message, count] : errorCounts) {
+            std::cerr << count << " x " << message << std::endl;
+        }
+        return errors.load() == 0 ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
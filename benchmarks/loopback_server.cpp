@@ -0,0 +1,184 @@
+// benchmarks/loopback_server.cpp
+#include "loopback_server.hpp"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+namespace bench {
+
+namespace {
+
+bool sendAll(int fd, const std::string& data) {
+    std::size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            return false;
+        }
+        sent += static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+std::string lowercase(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+} // namespace
+
+LoopbackServer::LoopbackServer(std::string unixSocketPath, Responder responder)
+    : responder_(std::move(responder)), unixSocketPath_(std::move(unixSocketPath)) {
+    if (!unixSocketPath_.empty()) {
+        sockaddr_un addr{};
+        if (unixSocketPath_.size() >= sizeof(addr.sun_path)) {
+            throw std::runtime_error("LoopbackServer: socket path too long");
+        }
+        addr.sun_family = AF_UNIX;
+        std::copy(unixSocketPath_.begin(), unixSocketPath_.end(), addr.sun_path);
+        ::unlink(unixSocketPath_.c_str());
+        listenFd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+            ::listen(listenFd_, 512) != 0) {
+            ::close(listenFd_);
+            throw std::runtime_error("LoopbackServer: unable to listen on " + unixSocketPath_);
+        }
+        acceptThread_ = std::thread([this]() { acceptLoop(); });
+        return;
+    }
+
+    listenFd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    int reuse = 1;
+    ::setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    if (::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listenFd_, 512) != 0) {
+        ::close(listenFd_);
+        throw std::runtime_error("LoopbackServer: unable to listen on loopback");
+    }
+
+    socklen_t len = sizeof(addr);
+    ::getsockname(listenFd_, reinterpret_cast<sockaddr*>(&addr), &len);
+    port_ = ntohs(addr.sin_port);
+    acceptThread_ = std::thread([this]() { acceptLoop(); });
+}
+
+LoopbackServer::~LoopbackServer() {
+    running_ = false;
+    ::shutdown(listenFd_, SHUT_RDWR);
+    ::close(listenFd_);
+    acceptThread_.join();
+    if (!unixSocketPath_.empty()) {
+        ::unlink(unixSocketPath_.c_str());
+    }
+
+    // Only sockets still in the list are open; the threads close them as
+    // they exit, which needs the lock, so they are joined without it
+    std::vector<std::thread> threads;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (int fd : clientFds_) {
+            ::shutdown(fd, SHUT_RDWR);
+        }
+        threads.swap(clientThreads_);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+std::string LoopbackServer::uri(const std::string& path) const {
+    if (!unixSocketPath_.empty()) {
+        return "unix:" + unixSocketPath_ + ":http://localhost" + path;
+    }
+    return "http://127.0.0.1:" + std::to_string(port_) + path;
+}
+
+void LoopbackServer::acceptLoop() {
+    while (running_) {
+        int fd = ::accept(listenFd_, nullptr, nullptr);
+        if (fd < 0) {
+            return;
+        }
+        if (unixSocketPath_.empty()) {
+            int noDelay = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        }
+        ++accepted_;
+        std::lock_guard<std::mutex> lock(mutex_);
+        clientFds_.push_back(fd);
+        clientThreads_.emplace_back([this, fd]() { serve(fd); });
+    }
+}
+
+void LoopbackServer::closeClient(int fd) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    clientFds_.erase(std::remove(clientFds_.begin(), clientFds_.end(), fd), clientFds_.end());
+    ::close(fd);
+}
+
+void LoopbackServer::serve(int fd) {
+    std::string buffer;
+    char chunk[16384];
+    auto receive = [&]() {
+        ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (n <= 0) {
+            return false;
+        }
+        buffer.append(chunk, static_cast<std::size_t>(n));
+        return true;
+    };
+    Send send = [fd](const std::string& data) { return sendAll(fd, data); };
+
+    while (running_) {
+        std::size_t headerEnd;
+        while ((headerEnd = buffer.find("\r\n\r\n")) == std::string::npos) {
+            if (!receive()) {
+                closeClient(fd);
+                return;
+            }
+        }
+
+        std::string head = lowercase(buffer.substr(0, headerEnd));
+        std::size_t contentLength = 0;
+        auto pos = head.find("content-length:");
+        if (pos != std::string::npos) {
+            contentLength = std::stoul(head.substr(pos + 15));
+        }
+        // curl holds back larger bodies until it sees 100 Continue
+        if (head.find("expect: 100-continue") != std::string::npos &&
+            buffer.size() < headerEnd + 4 + contentLength) {
+            sendAll(fd, "HTTP/1.1 100 Continue\r\n\r\n");
+        }
+
+        std::size_t requestEnd = headerEnd + 4 + contentLength;
+        while (buffer.size() < requestEnd) {
+            if (!receive()) {
+                closeClient(fd);
+                return;
+            }
+        }
+
+        LoopbackRequest request;
+        request.raw = buffer.substr(0, requestEnd);
+        request.bodyOffset = headerEnd + 4;
+        buffer.erase(0, requestEnd);
+        if (!responder_(request, send)) {
+            break;
+        }
+    }
+    closeClient(fd);
+}
+
+} // namespace bench
@@ -0,0 +1,73 @@
+// benchmarks/loopback_server.hpp
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace bench {
+
+/**
+ * @brief One request as received by LoopbackServer
+ */
+struct LoopbackRequest {
+    // Request line, headers and body exactly as received
+    std::string raw;
+    std::size_t bodyOffset = 0;
+
+    std::string_view body() const { return std::string_view(raw).substr(bodyOffset); }
+};
+
+/**
+ * @brief Keep-alive HTTP/1.1 server for benchmarks and tests
+ *
+ * Listens on 127.0.0.1 on an ephemeral port, or on a Unix domain socket
+ * when given a path, and serves each connection on its own thread.
+ * Requests are framed by Content-Length (with 100 Continue when curl asks
+ * for it) and handed to the responder, which writes the whole response.
+ * Each connection's socket is closed by its own thread, and leaves the
+ * list the destructor shuts down first, so a descriptor the OS has reused
+ * is never touched.
+ */
+class LoopbackServer {
+public:
+    // Writes to the connection the request came in on; false once it is gone
+    using Send = std::function<bool(const std::string& data)>;
+    // Returns false to close the connection
+    using Responder = std::function<bool(const LoopbackRequest& request, const Send& send)>;
+
+    // An empty unixSocketPath listens on loopback TCP
+    LoopbackServer(std::string unixSocketPath, Responder responder);
+    ~LoopbackServer();
+
+    LoopbackServer(const LoopbackServer&) = delete;
+    LoopbackServer& operator=(const LoopbackServer&) = delete;
+
+    // A "unix:<path>:<url>" URI when listening on a Unix domain socket
+    std::string uri(const std::string& path) const;
+
+    int acceptedConnections() const { return accepted_.load(); }
+
+private:
+    void acceptLoop();
+    void serve(int fd);
+    void closeClient(int fd);
+
+    Responder responder_;
+    std::string unixSocketPath_;
+    int listenFd_ = -1;
+    unsigned short port_ = 0;
+    std::atomic<bool> running_{true};
+    std::atomic<int> accepted_{0};
+    std::mutex mutex_;
+    // Open client sockets; each is removed under mutex_ before it is closed
+    std::vector<int> clientFds_;
+    std::vector<std::thread> clientThreads_;
+    std::thread acceptThread_;
+};
+
+} // namespace bench
@@ -0,0 +1,240 @@
+// benchmarks/microbenchmarks.cpp
+//
+// Hot paths of a conversation turn, timed in isolation:
+//   create_request/{warm,cold}/<messages>m/<tools>t
+//       OpenAITranslator::createRequest; warm reuses one translator so the
+//       serialization cache is hot, cold builds a new translator each time
+//   response_to_message/<bytes>
+//   message/{construct,copy,copy_with_tool_calls,copy_to}
+//   conversation/{heap,arena}/<messages>m
+//       build and tear down a session's worth of messages, from the global
+//       allocator or from a per-session arena (#ARENA on)
+//   tool_lookup/<tools>    ToolRegistry::find, which LLMSession does per tool call
+//   tool_arguments/{dom,typed}
+//       decode a tool call's arguments by parsing them into nlohmann::json
+//       and reading the fields out, or with decodeToolArguments
+//
+// Results are written as JSON to stdout.  An optional argument keeps only
+// the cases whose name contains it.
+#include "benchmark_harness.hpp"
+#include "translator/openai_translator.hpp"
+#include "core/typed_tool.hpp"
+#include <algorithm>
+#include <memory_resource>
+
+namespace {
+
+struct ForecastArgs {
+    std::string location;
+    int days = 0;
+    double latitude = 0;
+    double longitude = 0;
+    std::optional<std::string> unit;
+
+    static constexpr auto toolFields() {
+        return std::make_tuple(
+            toolField("location", &ForecastArgs::location),
+            toolField("days", &ForecastArgs::days),
+            toolField("latitude", &ForecastArgs::latitude),
+            toolField("longitude", &ForecastArgs::longitude),
+            toolField("unit", &ForecastArgs::unit));
+    }
+};
+
+std::vector<std::unique_ptr<Message>> makeConversation(std::size_t size) {
+    std::vector<std::unique_ptr<Message>> conversation;
+    conversation.push_back(std::make_unique<Message>(Message::Type::System));
+    conversation.back()->content = "You are a helpful assistant that answers questions about the weather.";
+    for (std::size_t i = 1; i < size; ++i) {
+        auto type = i % 2 == 1 ? Message::Type::User : Message::Type::Assistant;
+        conversation.push_back(std::make_unique<Message>(type));
+        conversation.back()->content = "Turn " + std::to_string(i) +
+            ": what is the forecast for Paris this weekend, and should I pack an umbrella?";
+    }
+    // The translator takes its request settings from the last user message
+    auto last = std::make_unique<Message>(Message::Type::User);
+    last->content = "And on Monday?";
+    RequestConfig& config = last->editConfig();
+    config.model = "gpt-4o";
+    config.temperature = 0.7;
+    config.max_tokens = 512;
+    if (size > 1) {
+        conversation.back() = std::move(last);
+    } else {
+        conversation.push_back(std::move(last));
+    }
+    return conversation;
+}
+
+std::vector<Tool> makeTools(std::size_t count) {
+    std::vector<Tool> tools;
+    tools.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        Tool tool;
+        tool.name = "tool_" + std::to_string(i);
+        tool.description = "Looks up item " + std::to_string(i) + " in the inventory service";
+        Parameter id;
+        id.name = "id";
+        id.type = "string";
+        id.description = "Identifier of the item";
+        id.required = true;
+        Parameter unit;
+        unit.name = "unit";
+        unit.type = "string";
+        unit.description = "Unit for quantities";
+        unit.enum_values = {"kg", "lb"};
+        tool.parameters = {id, unit};
+        tool.function = [](const std::string& args) { return args; };
+        tools.push_back(std::move(tool));
+    }
+    return tools;
+}
+
+std::string makeResponse(std::size_t contentBytes) {
+    std::string content;
+    while (content.size() < contentBytes) {
+        content += "The forecast is sunny with a light breeze. ";
+    }
+    return R"({"id":"chatcmpl-1","object":"chat.completion","created":1729376080,"model":"gpt-4o",)"
+           R"("choices":[{"index":0,"message":{"role":"assistant","content":")" + content +
+           R"("},"logprobs":null,"finish_reason":"stop"}],)"
+           R"("usage":{"prompt_tokens":100,"completion_tokens":50,"total_tokens":150}})";
+}
+
+Message makeAssistantWithToolCalls() {
+    Message message(Message::Type::Assistant);
+    message.content = "Let me check.";
+    auto metadata = std::make_shared<ResponseMetadata>();
+    metadata->model = "gpt-4o";
+    metadata->finish_reason = "tool_calls";
+    metadata->created = 1729376080;
+    message.metadata = std::move(metadata);
+    for (int i = 0; i < 3; ++i) {
+        message.tool_calls.emplace_back("call_" + std::to_string(i), "get_weather",
+                                        "{\"location\":\"Paris, France\"}");
+    }
+    return message;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const std::string filter = argc > 1 ? argv[1] : "";
+    std::vector<bench::Result> results;
+    auto add = [&](const std::string& name, const std::function<void()>& body, std::size_t bytes = 0) {
+        if (name.find(filter) != std::string::npos) {
+            results.push_back(bench::run(name, body, bytes));
+        }
+    };
+
+    for (std::size_t messages : {1, 10, 100, 1000}) {
+        auto conversation = makeConversation(messages);
+        for (std::size_t toolCount : {0, 10, 100, 500}) {
+            ToolRegistry tools(makeTools(toolCount));
+            std::string suffix = "/" + std::to_string(messages) + "m/" + std::to_string(toolCount) + "t";
+
+            OpenAITranslator warm;
+            std::string out;
+            warm.createRequest(conversation, tools, out);
+            add("create_request/warm" + suffix, [&]() {
+                warm.createRequest(conversation, tools, out);
+                bench::doNotOptimize(out.data());
+            }, out.size());
+
+            add("create_request/cold" + suffix, [&]() {
+                OpenAITranslator cold;
+                cold.createRequest(conversation, tools, out);
+                bench::doNotOptimize(out.data());
+            }, out.size());
+        }
+    }
+
+    OpenAITranslator translator;
+    for (std::size_t bytes : {256, 4096, 65536, 1048576}) {
+        std::string response = makeResponse(bytes);
+        add("response_to_message/" + std::to_string(bytes), [&]() {
+            bench::doNotOptimize(translator.responseToMessage(response));
+        }, response.size());
+    }
+
+    Message config(Message::Type::System);
+    RequestConfig& settings = config.editConfig();
+    settings.uri = "https://api.openai.com/v1/chat/completions";
+    settings.api_key_name = "OPENAI_API_KEY";
+    settings.model = "gpt-4o";
+    settings.temperature = 0.7;
+    settings.max_tokens = 512;
+    const Message plain = [&config] {
+        Message message(Message::Type::User);
+        message.content = "What is the forecast for Paris this weekend?";
+        config.copyTo(message);
+        return message;
+    }();
+    const Message withToolCalls = makeAssistantWithToolCalls();
+
+    add("message/construct", [&]() {
+        auto message = std::make_unique<Message>(Message::Type::User);
+        message->content = "What is the forecast for Paris this weekend?";
+        bench::doNotOptimize(message);
+    });
+    add("message/copy", [&]() {
+        auto copy = std::make_unique<Message>(plain);
+        bench::doNotOptimize(copy);
+    });
+    add("message/copy_with_tool_calls", [&]() {
+        auto copy = std::make_unique<Message>(withToolCalls);
+        bench::doNotOptimize(copy);
+    });
+    add("message/copy_to", [&]() {
+        Message target(Message::Type::User);
+        config.copyTo(target);
+        bench::doNotOptimize(target);
+    });
+
+    for (std::size_t size : {16, 128}) {
+        auto build = [size](std::pmr::memory_resource* resource) {
+            std::vector<std::unique_ptr<Message>> conversation;
+            for (std::size_t i = 0; i < size; ++i) {
+                auto message = Message::create(i % 2 == 0 ? Message::Type::User : Message::Type::Assistant, resource);
+                message->content = "Turn " + std::to_string(i) +
+                    ": what is the forecast for Paris this weekend, and should I pack an umbrella?";
+                conversation.push_back(std::move(message));
+            }
+            bench::doNotOptimize(conversation);
+        };
+        add("conversation/heap/" + std::to_string(size) + "m", [build]() { build(nullptr); });
+        add("conversation/arena/" + std::to_string(size) + "m", [build]() {
+            std::pmr::monotonic_buffer_resource arena(16 * 1024);
+            build(&arena);
+        });
+    }
+
+    for (std::size_t toolCount : {4, 32, 256}) {
+        ToolRegistry tools(makeTools(toolCount));
+        const std::string wanted = tools.entries().back()->tool.name;
+        add("tool_lookup/" + std::to_string(toolCount), [&]() {
+            bench::doNotOptimize(tools.find(wanted));
+        });
+    }
+
+    const std::string arguments =
+        R"({"location": "San Francisco, CA", "days": 5, "latitude": 37.7749, "longitude": -122.4194, "unit": "celsius"})";
+    add("tool_arguments/dom", [&]() {
+        nlohmann::json json = nlohmann::json::parse(arguments);
+        ForecastArgs args;
+        args.location = json.at("location").get<std::string>();
+        args.days = json.at("days").get<int>();
+        args.latitude = json.at("latitude").get<double>();
+        args.longitude = json.at("longitude").get<double>();
+        if (json.contains("unit")) {
+            args.unit = json["unit"].get<std::string>();
+        }
+        bench::doNotOptimize(args);
+    });
+    add("tool_arguments/typed", [&]() {
+        bench::doNotOptimize(decodeToolArguments<ForecastArgs>(arguments));
+    });
+
+    bench::writeJSON(std::cout, results);
+    return 0;
+}
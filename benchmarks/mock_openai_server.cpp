@@ -0,0 +1,122 @@
+// benchmarks/mock_openai_server.cpp
+#include "mock_openai_server.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <thread>
+
+namespace bench {
+
+namespace {
+
+std::string chunked(const std::string& data) {
+    char size[20];
+    std::snprintf(size, sizeof(size), "%zx\r\n", data.size());
+    return size + data + "\r\n";
+}
+
+// True when the last message in the request is a tool result
+bool endsWithToolResult(std::string_view body) {
+    auto tool = body.rfind("\"role\":\"tool\"");
+    auto user = body.rfind("\"role\":\"user\"");
+    return tool != std::string::npos && (user == std::string::npos || tool > user);
+}
+
+} // namespace
+
+MockOpenAIServer::MockOpenAIServer(MockServerOptions options) : options_(std::move(options)) {
+    const std::string words = "lorem ipsum dolor sit amet consectetur adipiscing elit ";
+    while (content_.size() < options_.contentBytes) {
+        content_ += words;
+    }
+    content_.resize(options_.contentBytes);
+
+    server_ = std::make_unique<LoopbackServer>(options_.unixSocketPath,
+        [this](const LoopbackRequest& request, const LoopbackServer::Send& send) {
+            ++requests_;
+            return respond(request.body(), send);
+        });
+}
+
+MockOpenAIServer::~MockOpenAIServer() = default;
+
+std::string MockOpenAIServer::uri(const std::string& path) const {
+    return server_->uri(path);
+}
+
+void MockOpenAIServer::sleepForLatency() {
+    auto delay = options_.latency;
+    if (options_.jitter.count() > 0) {
+        thread_local std::mt19937 random(std::random_device{}());
+        std::uniform_int_distribution<long long> extra(0, options_.jitter.count());
+        delay += std::chrono::milliseconds(extra(random));
+    }
+    if (delay.count() > 0) {
+        std::this_thread::sleep_for(delay);
+    }
+}
+
+std::string MockOpenAIServer::completion(bool withToolCalls) const {
+    std::string json = R"({"id":"chatcmpl-mock","object":"chat.completion","created":1729376080,"model":")" +
+                       options_.model + R"(","choices":[{"index":0,"message":{"role":"assistant","content":")";
+    if (withToolCalls) {
+        json += R"(","tool_calls":[)";
+        for (int i = 0; i < options_.toolCalls; ++i) {
+            json += i ? "," : "";
+            json += R"({"id":"call_)" + std::to_string(i) +
+                    R"(","type":"function","function":{"name":"get_weather","arguments":"{\"location\":\"Paris\"}"}})";
+        }
+        json += R"(]},"logprobs":null,"finish_reason":"tool_calls"}],)";
+    } else {
+        json += content_ + R"("},"logprobs":null,"finish_reason":"stop"}],)";
+    }
+    json += R"("usage":{"prompt_tokens":100,"completion_tokens":)" + std::to_string(content_.size() / 4) +
+            R"(,"total_tokens":)" + std::to_string(100 + content_.size() / 4) + "}}";
+    return json;
+}
+
+bool MockOpenAIServer::respond(std::string_view body, const LoopbackServer::Send& send) {
+    bool withToolCalls = options_.toolCalls > 0 && !endsWithToolResult(body);
+    sleepForLatency();
+
+    if (body.find("\"stream\":true") == std::string::npos) {
+        std::string json = completion(withToolCalls);
+        return send("HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: " +
+                           std::to_string(json.size()) + "\r\n\r\n" + json);
+    }
+
+    // Server-sent events, one HTTP chunk per event
+    if (!send("HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\nTransfer-Encoding: chunked\r\n\r\n")) {
+        return false;
+    }
+    const std::string prefix = R"(data: {"id":"chatcmpl-mock","created":1729376080,"model":")" + options_.model +
+                               R"(","choices":[{"index":0,"delta":{)";
+    std::size_t chunks = std::max<std::size_t>(1, options_.streamChunks);
+    std::size_t step = (content_.size() + chunks - 1) / chunks;
+    for (std::size_t offset = 0; offset < content_.size(); offset += step) {
+        std::string event = prefix + R"("content":")" + content_.substr(offset, step) +
+                            R"("},"finish_reason":null}]})" + "\n\n";
+        if (!send(chunked(event))) {
+            return false;
+        }
+        if (options_.chunkInterval.count() > 0) {
+            std::this_thread::sleep_for(options_.chunkInterval);
+        }
+    }
+    if (withToolCalls) {
+        for (int i = 0; i < options_.toolCalls; ++i) {
+            std::string event = prefix + R"("tool_calls":[{"index":)" + std::to_string(i) + R"(,"id":"call_)" +
+                                std::to_string(i) + R"(","function":{"name":"get_weather","arguments":"{\"location\":\"Paris\"}"}}]},"finish_reason":null}]})" +
+                                "\n\n";
+            if (!send(chunked(event))) {
+                return false;
+            }
+        }
+    }
+    std::string last = prefix + R"(},"finish_reason":")" + (withToolCalls ? "tool_calls" : "stop") +
+                       R"("}],"usage":{"prompt_tokens":100,"completion_tokens":1,"total_tokens":101}})" + "\n\n" +
+                       "data: [DONE]\n\n";
+    return send(chunked(last)) && send("0\r\n\r\n");
+}
+
+} // namespace bench
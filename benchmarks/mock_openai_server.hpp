@@ -0,0 +1,76 @@
+// benchmarks/mock_openai_server.hpp
+#pragma once
+#include "loopback_server.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace bench {
+
+/**
+ * @brief Shape of the responses produced by MockOpenAIServer
+ */
+struct MockServerOptions {
+    // Delay before the response, or before the first event when streaming,
+    // plus a uniformly distributed extra of up to jitter
+    std::chrono::milliseconds latency{0};
+    std::chrono::milliseconds jitter{0};
+
+    // Size of the assistant content in bytes
+    std::size_t contentBytes = 256;
+
+    // Tool calls returned while the conversation does not end in tool
+    // results; once it does, a plain answer is returned
+    int toolCalls = 0;
+
+    // Requests with "stream":true are answered with this many SSE content
+    // events, chunkInterval apart
+    std::size_t streamChunks = 16;
+    std::chrono::milliseconds chunkInterval{0};
+
+    std::string model = "mock-gpt";
+
+    // Listen on this Unix domain socket instead of a loopback TCP port
+    std::string unixSocketPath;
+};
+
+/**
+ * @brief In-process OpenAI-compatible chat completions server
+ *
+ * Listens on 127.0.0.1 on an ephemeral port, or on a Unix domain socket when
+ * MockServerOptions::unixSocketPath is set, and answers every POST with a
+ * synthetic chat.completion (or an SSE stream for "stream": true) shaped by
+ * MockServerOptions.  Connections are kept alive and served by one thread
+ * each, by a LoopbackServer.  Intended for benchmarks and tests; it does
+ * not validate requests.
+ */
+class MockOpenAIServer {
+public:
+    explicit MockOpenAIServer(MockServerOptions options = {});
+    ~MockOpenAIServer();
+
+    MockOpenAIServer(const MockOpenAIServer&) = delete;
+    MockOpenAIServer& operator=(const MockOpenAIServer&) = delete;
+
+    // A "unix:<path>:<url>" URI when listening on a Unix domain socket
+    std::string uri(const std::string& path = "/v1/chat/completions") const;
+
+    std::uint64_t requestsServed() const { return requests_.load(); }
+    int acceptedConnections() const { return server_->acceptedConnections(); }
+
+private:
+    bool respond(std::string_view body, const LoopbackServer::Send& send);
+    std::string completion(bool withToolCalls) const;
+    void sleepForLatency();
+
+    MockServerOptions options_;
+    std::string content_;
+    std::atomic<std::uint64_t> requests_{0};
+    // Created last and destroyed first, so no connection outlives the rest
+    std::unique_ptr<LoopbackServer> server_;
+};
+
+} // namespace bench
@@ -0,0 +1,80 @@
+// benchmarks/response_parse_benchmark.cpp
+//
+// Compares the response parsers available to OpenAITranslator on synthetic
+// chat completions of increasing size:
+//   dom       - responseToMessage(const std::string&), nlohmann DOM
+//   sax       - responseToMessage(std::istream&), nlohmann SAX handler
+//   simdjson  - SimdjsonOpenAITranslator (when built with simdjson)
+//
+// Results are written as JSON to stdout.
+#include "benchmark_harness.hpp"
+#include "translator/openai_translator.hpp"
+#ifdef COLLOQUIUM_HAS_SIMDJSON
+#include "translator/simdjson_openai_translator.hpp"
+#endif
+#include <sstream>
+
+namespace {
+
+// A completion whose content is roughly contentBytes long, with a handful of
+// tool calls and the extra fields real servers send alongside
+std::string makeResponse(std::size_t contentBytes, int toolCalls) {
+    std::string content;
+    const std::string sentence = "The quick brown fox jumps over the lazy dog. \\\"Quoted\\\" text\\n";
+    while (content.size() < contentBytes) {
+        content += sentence;
+    }
+
+    std::string json = R"({"id":"chatcmpl-AKHqx7","object":"chat.completion","created":1729376080,)"
+                       R"("model":"gpt-4o-2024-08-06","system_fingerprint":"fp_a7d06e42a7","choices":[{"index":0,"message":{"role":"assistant","content":")";
+    json += content;
+    json += R"(","refusal":null)";
+    if (toolCalls > 0) {
+        json += R"(,"tool_calls":[)";
+        for (int i = 0; i < toolCalls; ++i) {
+            if (i > 0) {
+                json += ',';
+            }
+            json += R"({"id":"call_)" + std::to_string(i) +
+                    R"(","type":"function","function":{"name":"get_weather","arguments":"{\"location\":\"Paris, France\",\"unit\":\"celsius\"}"}})";
+        }
+        json += ']';
+    }
+    json += R"(},"logprobs":null,"finish_reason":"stop"}],)"
+            R"("usage":{"prompt_tokens":1024,"completion_tokens":512,"total_tokens":1536,)"
+            R"("prompt_tokens_details":{"cached_tokens":0},"completion_tokens_details":{"reasoning_tokens":0}}})";
+    return json;
+}
+
+} // namespace
+
+int main() {
+    OpenAITranslator translator;
+#ifdef COLLOQUIUM_HAS_SIMDJSON
+    SimdjsonOpenAITranslator simdjsonTranslator;
+#endif
+
+    std::vector<bench::Result> results;
+    for (std::size_t size : {std::size_t{1} << 10, std::size_t{16} << 10, std::size_t{256} << 10, std::size_t{4} << 20}) {
+        const std::string response = makeResponse(size, 8);
+        const std::string suffix = "/" + std::to_string(size / 1024) + "KiB";
+
+        results.push_back(bench::run("dom" + suffix, [&]() {
+            bench::doNotOptimize(translator.responseToMessage(response));
+        }, response.size()));
+
+        results.push_back(bench::run("sax" + suffix, [&]() {
+            std::istringstream stream(response);
+            bench::doNotOptimize(translator.responseToMessage(stream));
+        }, response.size()));
+
+#ifdef COLLOQUIUM_HAS_SIMDJSON
+        results.push_back(bench::run("simdjson" + suffix, [&]() {
+            bench::doNotOptimize(simdjsonTranslator.responseToMessage(response));
+        }, response.size()));
+#endif
+    }
+
+    bench::writeJSON(std::cout, results);
+    return 0;
+}
@@ -5,19 +5,84 @@
 #include <iostream>
 #include <chrono>
 #include <ctime>
+#include <atomic>
+#include <new>
 
+namespace {
+std::atomic<std::uint64_t> nextMessageId{1};
 
-Message::Message(Type type) : type_(type) {
-    auto now = std::chrono::system_clock::now();
-    auto seconds_since_epoch = std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
-    created = seconds_since_epoch;
+// Precedes each Message allocation so operator delete knows where it came from
+struct alignas(std::max_align_t) AllocationHeader {
+    std::pmr::memory_resource* resource;
+    std::size_t size;
+};
+
+// resource is null for messages from the global heap
+void* withHeader(void* block, std::pmr::memory_resource* resource, std::size_t size) {
+    new (block) AllocationHeader{resource, size};
+    return static_cast<char*>(block) + sizeof(AllocationHeader);
+}
+
+} // namespace
+
+Message::InstanceId::InstanceId() : value(nextMessageId.fetch_add(1, std::memory_order_relaxed)) {}
+
+Message::InstanceId::InstanceId(const InstanceId&) : InstanceId() {}
+
+Message::InstanceId& Message::InstanceId::operator=(const InstanceId&) {
+    value = nextMessageId.fetch_add(1, std::memory_order_relaxed);
+    return *this;
+}
+
+Message::Message(Type type, const allocator_type& alloc)
+    : content(alloc), tool_calls(alloc), type_(type) {}
+
+std::unique_ptr<Message> Message::create(Type type, std::pmr::memory_resource* resource) {
+    if (!resource) {
+        return std::make_unique<Message>(type);
+    }
+    return std::unique_ptr<Message>(new (resource) Message(type, allocator_type(resource)));
+}
+
+void* Message::operator new(std::size_t size) {
+    return withHeader(::operator new(sizeof(AllocationHeader) + size), nullptr, size);
+}
+
+void* Message::operator new(std::size_t size, std::pmr::memory_resource* resource) {
+    return withHeader(resource->allocate(sizeof(AllocationHeader) + size, alignof(AllocationHeader)), resource, size);
+}
+
+void Message::operator delete(void* pointer) {
+    if (!pointer) {
+        return;
+    }
+    auto* header = reinterpret_cast<AllocationHeader*>(static_cast<char*>(pointer) - sizeof(AllocationHeader));
+    if (header->resource) {
+        header->resource->deallocate(header, sizeof(AllocationHeader) + header->size, alignof(AllocationHeader));
+    } else {
+        ::operator delete(header);
+    }
+}
+
+void Message::operator delete(void* pointer, std::pmr::memory_resource*) {
+    operator delete(pointer);
+}
+
+Message::allocator_type Message::get_allocator() const {
+    return content.get_allocator();
 }
 
 Message::Type Message::getType() const {
     return type_;
 }
 
+std::uint64_t Message::getId() const {
+    return id_.value;
+}
+
 std::string Message::to_string() {
+    const RequestConfig& cfg = getConfig();
+    const ResponseMetadata& meta = getMetadata();
 
     return std::string("") +
         "Type: " + [this]() {
@@ -30,33 +95,38 @@ std::string Message::to_string() {
                 default: return "unknown";
             }
         }() + "\n" +
-        "Content: " + content + "\n" +
-        "Created: " + std::to_string(created) + "\n" +
-        (completion_tokens.has_value() ? "Completion Tokens: " + std::to_string(completion_tokens.value()) + "\n" : "") +
-        (finish_reason.has_value() ? std::string("Finish Reason: ") + finish_reason.value() + "\n" : "") +
-        (logprobs.has_value() ? "Logprobs: " + std::to_string(logprobs.value()) + "\n" : "") +
-        (max_tokens.has_value() ? "Max Tokens: " + std::to_string(max_tokens.value()) + "\n" : "") +
-        (model.has_value() ? "Model: " + model.value() + "\n" : "") +
-        (uri.has_value() ? "URI: " + uri.value() + "\n" : "") +
-        (api_key_name.has_value() ? "API key name: " + api_key_name.value() + "\n" : "") +
-        (name.has_value() ? "Name: " + name.value() + "\n" : "") +
-        (prompt_tokens.has_value() ? "Prompt Tokens: " + std::to_string(prompt_tokens.value()) + "\n" : "") +
-        (random_seed.has_value() ? "Random Seed: " + std::to_string(random_seed.value()) + "\n" : "") +
-        (response_format_type.has_value() ? "Response Format Type: " + response_format_type.value() + "\n" : "") +
-        (stream.has_value() ? "Stream: " + std::to_string(stream.value()) + "\n" : "") +
-        (temperature.has_value() ? "Temperature: " + std::to_string(temperature.value_or(-1)) + "\n" : "") +
-        (tool_call_id.has_value() ? "Tool Call ID: " + tool_call_id.value() + "\n" : "") +
-        (tool_choice.has_value() ? "Tool Choice: " + tool_choice.value() + "\n" : "") +
-        (top_p.has_value() ? "Top P: " + std::to_string(top_p.value_or(-1)) + "\n" : "") +
-        (total_tokens.has_value() ? "Total Tokens: " + std::to_string(total_tokens.value()) + "\n" : "") +
+        "Content: " + std::string(content) + "\n" +
+        (metadata ? "Created: " + std::to_string(meta.created) + "\n" : "") +
+        (meta.completion_tokens.has_value() ? "Completion Tokens: " + std::to_string(meta.completion_tokens.value()) + "\n" : "") +
+        (meta.finish_reason.has_value() ? std::string("Finish Reason: ") + meta.finish_reason.value() + "\n" : "") +
+        (cfg.logprobs.has_value() ? "Logprobs: " + std::to_string(cfg.logprobs.value()) + "\n" : "") +
+        (cfg.max_tokens.has_value() ? "Max Tokens: " + std::to_string(cfg.max_tokens.value()) + "\n" : "") +
+        (meta.model.has_value() ? "Model: " + meta.model.value() + "\n" :
+         cfg.model.has_value() ? "Model: " + cfg.model.value() + "\n" : "") +
+        (cfg.uri.has_value() ? "URI: " + cfg.uri.value() + "\n" : "") +
+        (cfg.api_key_name.has_value() ? "API key name: " + cfg.api_key_name.value() + "\n" : "") +
+        (name.has_value() ? "Name: " + std::string(*name) + "\n" : "") +
+        (meta.prompt_tokens.has_value() ? "Prompt Tokens: " + std::to_string(meta.prompt_tokens.value()) + "\n" : "") +
+        (cfg.random_seed.has_value() ? "Random Seed: " + std::to_string(cfg.random_seed.value()) + "\n" : "") +
+        (cfg.response_format_type.has_value() ? "Response Format Type: " + cfg.response_format_type.value() + "\n" : "") +
+        (cfg.stream.has_value() ? "Stream: " + std::to_string(cfg.stream.value()) + "\n" : "") +
+        (cfg.temperature.has_value() ? "Temperature: " + std::to_string(cfg.temperature.value_or(-1)) + "\n" : "") +
+        (tool_call_id.has_value() ? "Tool Call ID: " + std::string(*tool_call_id) + "\n" : "") +
+        (cfg.tool_choice.has_value() ? "Tool Choice: " + cfg.tool_choice.value() + "\n" : "") +
+        (cfg.tools.has_value() ? "Tools: " + std::accumulate(
+            cfg.tools->begin(), cfg.tools->end(), std::string(),
+            [](std::string acc, const std::string& tool) { return acc.empty() ? tool : acc + "," + tool; }
+        ) + "\n" : "") +
+        (cfg.top_p.has_value() ? "Top P: " + std::to_string(cfg.top_p.value_or(-1)) + "\n" : "") +
+        (meta.total_tokens.has_value() ? "Total Tokens: " + std::to_string(meta.total_tokens.value()) + "\n" : "") +
         (tool_calls.size() != 0 ? "Tool Calls:\n" + std::accumulate(
             tool_calls.begin(),
             tool_calls.end(),
             std::string(""),
-            [](std::string acc, const std::map<std::string, std::string>& tool_call) {
-                for (const auto& [key, value] : tool_call) {
-                    acc += "\t" + key + ": " + value + "\n";
-                }
+            [](std::string acc, const ToolCall& tool_call) {
+                acc.append("\targuments: ").append(tool_call.arguments).append("\n");
+                acc.append("\tid: ").append(tool_call.id).append("\n");
+                acc.append("\tname: ").append(tool_call.name).append("\n");
                 return acc;
             }
         ) + "\n" +
@@ -64,23 +134,31 @@ std::string Message::to_string() {
     ;
 }
 
-void Message::copyTo(Message& other) {
-    if (uri.has_value() && !other.uri.has_value()) {
-        other.uri = uri;
-    }
-    if (api_key_name.has_value() && !other.api_key_name.has_value()) {
-        other.api_key_name = api_key_name;
-    }
-    if (temperature.has_value() && !other.temperature.has_value()) {
-        other.temperature = temperature;
+void Message::copyTo(Message& other) const {
+    if (!config || other.config == config) {
+        return;
     }
-    if (top_p.has_value() && !other.top_p.has_value()) {
-        other.top_p = top_p;
-    }
-    if (max_tokens.has_value() && !other.max_tokens.has_value()) {
-        other.max_tokens = max_tokens;
-    }
-    if (model.has_value() && !other.model.has_value()) {
-        other.model = model;
+    if (!other.config) {
+        other.config = config;
+        return;
     }
+    auto merged = std::make_shared<RequestConfig>(*other.config);
+    merged->mergeFrom(*config);
+    other.config = std::move(merged);
+}
+
+const RequestConfig& Message::getConfig() const {
+    static const RequestConfig empty;
+    return config ? *config : empty;
+}
+
+RequestConfig& Message::editConfig() {
+    auto copy = std::make_shared<RequestConfig>(getConfig());
+    config = copy;
+    return *copy;
+}
+
+const ResponseMetadata& Message::getMetadata() const {
+    static const ResponseMetadata empty;
+    return metadata ? *metadata : empty;
 }
@@ -1,44 +1,108 @@
 // src/core/message.hpp
 #pragma once
+#include "request_config.hpp"
+#include "tool_call.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
 #include <optional>
-#include <map>
 #include <vector>
 #include <string>
 
+/**
+ * @brief What the provider reported along with a response
+ */
+struct ResponseMetadata {
+    long long created = 0;
+    std::optional<std::string> finish_reason;
+    // The model that answered, which may be more specific than the one asked for
+    std::optional<std::string> model;
+    std::optional<int> prompt_tokens;
+    std::optional<int> completion_tokens;
+    std::optional<int> total_tokens;
+};
+
+/**
+ * @brief One entry of a conversation
+ *
+ * Only what every message needs is stored inline.  Request settings live in
+ * a RequestConfig shared between messages, and response metadata is
+ * allocated only for responses, so a conversation of many turns costs
+ * little more than its text.
+ *
+ * The text and tool calls are allocator-aware, so a message can be built in
+ * a memory resource such as a session's arena; see create().  Copies use the
+ * default resource, as with any pmr container.
+ */
 class Message {
 public:
     enum class Type { System, User, Assistant, ToolCall, ToolResult };
 
-    Message(Type type);
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+    Message(Type type, const allocator_type& alloc = {});
     virtual ~Message() = default;
 
+    // Allocates the message itself from resource as well as its contents;
+    // nullptr uses the heap.  Deleting it returns the memory to resource,
+    // which therefore has to outlive it.
+    static std::unique_ptr<Message> create(Type type, std::pmr::memory_resource* resource);
+
+    static void* operator new(std::size_t size);
+    static void* operator new(std::size_t size, std::pmr::memory_resource* resource);
+    static void operator delete(void* pointer);
+    static void operator delete(void* pointer, std::pmr::memory_resource* resource);
+
+    allocator_type get_allocator() const;
+
     Type getType() const;
 
+    // Identifies this instance for caches such as the translator's
+    // serialized-message cache.  Every construction, copy and assignment
+    // yields a fresh id, so a message should not be modified in place once
+    // it has been sent; replace it instead.
+    std::uint64_t getId() const;
+
     std::string to_string();
 
-    void copyTo(Message& other);
+    // Gives other this message's request settings where it has none of its
+    // own; shares the config when other has none at all
+    void copyTo(Message& other) const;
 
-    std::string content;
-    long long created;
-    std::optional<std::string> finish_reason;
-    std::optional<int> prompt_tokens;
-    std::optional<int> completion_tokens;
-    std::optional<int> total_tokens;
-    std::optional<std::string> model;
-    std::optional<std::string> uri;
-    std::optional<std::string> api_key_name;
-    std::optional<double> temperature;
-    std::optional<double> top_p;
-    std::optional<int> max_tokens;
-    std::optional<int> logprobs;
-    std::optional<bool> stream;
-    std::optional<int> random_seed;
-    std::optional<std::string> response_format_type;
-    std::optional<std::string> tool_choice;
-    std::optional<std::string> name;
-    std::optional<std::string> tool_call_id;
-    std::vector<std::map<std::string, std::string>> tool_calls;
+    // The shared settings, or an empty config when none are set
+    const RequestConfig& getConfig() const;
+
+    // Replaces the shared settings with a modified copy; meant for setting
+    // up a message before it is sent
+    RequestConfig& editConfig();
+
+    // Response metadata, or an all-empty one for messages that are not
+    // responses
+    const ResponseMetadata& getMetadata() const;
+
+    // Assign name and tool_call_id with emplace(value, get_allocator()) to
+    // keep them in the message's resource
+    std::pmr::string content;
+    std::optional<std::pmr::string> name;
+    std::optional<std::pmr::string> tool_call_id;
+    std::pmr::vector<ToolCall> tool_calls;
+
+    std::shared_ptr<const RequestConfig> config;
+    std::shared_ptr<const ResponseMetadata> metadata;
 
 protected:
     Type type_;
+
+private:
+    class InstanceId {
+    public:
+        InstanceId();
+        InstanceId(const InstanceId&);
+        InstanceId& operator=(const InstanceId&);
+
+        std::uint64_t value;
+    };
+
+    InstanceId id_;
 };
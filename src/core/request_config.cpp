@@ -0,0 +1,28 @@
+// src/core/request_config.cpp
+#include "request_config.hpp"
+
+namespace {
+
+template <typename T>
+void fill(std::optional<T>& field, const std::optional<T>& fallback) {
+    if (!field.has_value() && fallback.has_value()) {
+        field = fallback;
+    }
+}
+
+} // namespace
+
+void RequestConfig::mergeFrom(const RequestConfig& defaults) {
+    fill(uri, defaults.uri);
+    fill(api_key_name, defaults.api_key_name);
+    fill(model, defaults.model);
+    fill(temperature, defaults.temperature);
+    fill(top_p, defaults.top_p);
+    fill(max_tokens, defaults.max_tokens);
+    fill(logprobs, defaults.logprobs);
+    fill(stream, defaults.stream);
+    fill(random_seed, defaults.random_seed);
+    fill(response_format_type, defaults.response_format_type);
+    fill(tool_choice, defaults.tool_choice);
+    fill(tools, defaults.tools);
+}
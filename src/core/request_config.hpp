@@ -0,0 +1,33 @@
+// src/core/request_config.hpp
+#pragma once
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Request settings that apply to a run of messages
+ *
+ * Messages hold a std::shared_ptr<const RequestConfig>, so every message
+ * configured the same way points at one instance instead of carrying its
+ * own copy of each field.  Treat an instance as immutable once shared: to
+ * change a setting, copy it, modify the copy and point new messages at
+ * that.
+ */
+struct RequestConfig {
+    std::optional<std::string> uri;
+    std::optional<std::string> api_key_name;
+    std::optional<std::string> model;
+    std::optional<double> temperature;
+    std::optional<double> top_p;
+    std::optional<int> max_tokens;
+    std::optional<int> logprobs;
+    std::optional<bool> stream;
+    std::optional<int> random_seed;
+    std::optional<std::string> response_format_type;
+    std::optional<std::string> tool_choice;
+    // Names of the registered tools to offer; all of them when unset
+    std::optional<std::vector<std::string>> tools;
+
+    // Fills the settings unset here from defaults
+    void mergeFrom(const RequestConfig& defaults);
+};
@@ -1,6 +1,8 @@
 // src/core/tool.hpp
 #pragma once
 #include "parameter.hpp"
+#include <chrono>
+#include <cstddef>
 #include <string>
 #include <vector>
 #include <functional>
@@ -11,4 +13,10 @@ public:
     std::string description;
     std::vector<Parameter> parameters;
     std::function<std::string(const std::string&)> function;
+
+    // Maximum number of calls to this tool running at once (0 = no limit)
+    std::size_t max_concurrency = 0;
+    // How long a call may run before its result is replaced by a timeout
+    // error (0 = wait indefinitely)
+    std::chrono::milliseconds timeout{0};
 };
@@ -0,0 +1,24 @@
+// src/core/tool_call.cpp
+#include "tool_call.hpp"
+#include <utility>
+
+ToolCall::ToolCall(const allocator_type& alloc) : id(alloc), name(alloc), arguments(alloc) {}
+
+ToolCall::ToolCall(std::string_view id, std::string_view name, std::string_view arguments,
+                   const allocator_type& alloc)
+    : id(id, alloc), name(name, alloc), arguments(arguments, alloc) {}
+
+ToolCall::ToolCall(const ToolCall& other, const allocator_type& alloc)
+    : id(other.id, alloc), name(other.name, alloc), arguments(other.arguments, alloc) {}
+
+ToolCall::ToolCall(ToolCall&& other, const allocator_type& alloc)
+    : id(std::move(other.id), alloc), name(std::move(other.name), alloc),
+      arguments(std::move(other.arguments), alloc) {}
+
+bool operator==(const ToolCall& lhs, const ToolCall& rhs) {
+    return lhs.id == rhs.id && lhs.name == rhs.name && lhs.arguments == rhs.arguments;
+}
+
+bool operator!=(const ToolCall& lhs, const ToolCall& rhs) {
+    return !(lhs == rhs);
+}
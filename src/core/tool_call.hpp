@@ -0,0 +1,36 @@
+// src/core/tool_call.hpp
+#pragma once
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief A function call requested by the model
+ *
+ * Allocator-aware, so the calls of a message built in an arena stay in it.
+ * The allocator-extended constructors let std::pmr::vector<ToolCall> pass
+ * its resource down; copies without one use the default resource.
+ */
+struct ToolCall {
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+    ToolCall() = default;
+    explicit ToolCall(const allocator_type& alloc);
+    ToolCall(std::string_view id, std::string_view name, std::string_view arguments,
+             const allocator_type& alloc = {});
+
+    ToolCall(const ToolCall& other, const allocator_type& alloc = {});
+    ToolCall(ToolCall&& other) noexcept = default;
+    ToolCall(ToolCall&& other, const allocator_type& alloc);
+    ToolCall& operator=(const ToolCall& other) = default;
+    ToolCall& operator=(ToolCall&& other) = default;
+
+    std::pmr::string id;
+    std::pmr::string name;
+    // JSON text of the arguments, as the model produced it
+    std::pmr::string arguments;
+};
+
+bool operator==(const ToolCall& lhs, const ToolCall& rhs);
+bool operator!=(const ToolCall& lhs, const ToolCall& rhs);
@@ -0,0 +1,34 @@
+// src/core/tool_registry.cpp
+#include "tool_registry.hpp"
+#include <atomic>
+#include <utility>
+
+namespace {
+std::atomic<std::uint64_t> nextToolId{1};
+}
+
+ToolRegistry::ToolRegistry(std::vector<Tool> tools) {
+    for (auto& tool : tools) {
+        add(std::move(tool));
+    }
+}
+
+void ToolRegistry::add(Tool tool) {
+    std::uint64_t id = nextToolId.fetch_add(1, std::memory_order_relaxed);
+    auto it = byName_.find(tool.name);
+    if (it != byName_.end()) {
+        Entry* entry = it->second;
+        byName_.erase(it);
+        *entry = Entry{std::move(tool), id};
+        byName_.emplace(entry->tool.name, entry);
+        return;
+    }
+    Entry& entry = storage_.emplace_back(Entry{std::move(tool), id});
+    entries_.push_back(&entry);
+    byName_.emplace(entry.tool.name, &entry);
+}
+
+const ToolRegistry::Entry* ToolRegistry::find(std::string_view name) const {
+    auto it = byName_.find(name);
+    return it != byName_.end() ? it->second : nullptr;
+}
@@ -0,0 +1,53 @@
+// src/core/tool_registry.hpp
+#pragma once
+#include "tool.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief The tools offered to the model, indexed by name
+ *
+ * Registered tools are immutable and each gets an id that is never reused,
+ * so a translator can cache a tool's serialized schema by id without
+ * checking it for changes.  Adding a tool under a name that is already
+ * registered replaces it with a new id.  Tools keep their registration
+ * order, which is the order they are offered in.
+ */
+class ToolRegistry {
+public:
+    struct Entry {
+        Tool tool;
+        std::uint64_t id;
+    };
+
+    ToolRegistry() = default;
+    explicit ToolRegistry(std::vector<Tool> tools);
+
+    // The index points into the registry's own storage
+    ToolRegistry(const ToolRegistry&) = delete;
+    ToolRegistry& operator=(const ToolRegistry&) = delete;
+    ToolRegistry(ToolRegistry&&) = default;
+    ToolRegistry& operator=(ToolRegistry&&) = default;
+
+    void add(Tool tool);
+
+    // nullptr when no tool has that name
+    const Entry* find(std::string_view name) const;
+
+    // In registration order
+    const std::vector<const Entry*>& entries() const { return entries_; }
+
+    std::size_t size() const { return entries_.size(); }
+    bool empty() const { return entries_.empty(); }
+
+private:
+    // A deque so entries stay put as tools are added
+    std::deque<Entry> storage_;
+    std::vector<const Entry*> entries_;
+    // Keys view the names in storage_
+    std::unordered_map<std::string_view, Entry*> byName_;
+};
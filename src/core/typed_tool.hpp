@@ -0,0 +1,393 @@
+// src/core/typed_tool.hpp
+#pragma once
+#include "tool.hpp"
+#include "exceptions/llm_exceptions.hpp"
+#include <nlohmann/json.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/*
+Typed tool bindings.  An argument struct lists its fields once, and the
+tool's parameters and argument decoding are both derived from that list:
+
+struct ConvertArgs {
+    double fahrenheit = 0;
+    std::optional<int> precision;
+
+    static constexpr auto toolFields() {
+        return std::make_tuple(
+            toolField("fahrenheit", &ConvertArgs::fahrenheit, "The temperature in Fahrenheit"),
+            toolField("precision", &ConvertArgs::precision, "Decimal places"));
+    }
+};
+
+Tool tool = makeTypedTool<ConvertArgs>("fahrenheit_to_celsius", "Converts Fahrenheit to Celsius",
+    [](const ConvertArgs& args) { return std::to_string((args.fahrenheit - 32) * 5 / 9); });
+
+Fields may be bool, integers, floating point, std::string, or std::optional
+of those; optional fields are the ones the model may leave out.  Anything
+else, or two fields with the same name, fails to compile.
+*/
+
+/**
+ * @brief One field of a tool's argument struct, as listed by toolFields()
+ */
+template <typename Struct, typename Member>
+struct ToolField {
+    const char* name;
+    Member Struct::*member;
+    const char* description;
+};
+
+template <typename Struct, typename Member>
+constexpr ToolField<Struct, Member> toolField(const char* name, Member Struct::*member,
+                                              const char* description = "") {
+    return {name, member, description};
+}
+
+namespace typed_tool_detail {
+
+template <typename T>
+struct Unwrap {
+    using type = T;
+    static constexpr bool optional = false;
+};
+
+template <typename T>
+struct Unwrap<std::optional<T>> {
+    using type = T;
+    static constexpr bool optional = true;
+};
+
+// JSON schema type of a field, or nullptr when it is not supported
+template <typename T>
+constexpr const char* schemaType() {
+    using Value = typename Unwrap<T>::type;
+    if constexpr (std::is_same_v<Value, bool>) {
+        return "boolean";
+    } else if constexpr (std::is_integral_v<Value>) {
+        return "integer";
+    } else if constexpr (std::is_floating_point_v<Value>) {
+        return "number";
+    } else if constexpr (std::is_same_v<Value, std::string>) {
+        return "string";
+    } else {
+        return nullptr;
+    }
+}
+
+constexpr bool sameName(const char* a, const char* b) {
+    while (*a != '\0' && *a == *b) {
+        ++a;
+        ++b;
+    }
+    return *a == *b;
+}
+
+template <typename Fields, std::size_t... I>
+constexpr bool fieldsValid(const Fields& fields, std::index_sequence<I...>) {
+    constexpr std::size_t count = sizeof...(I);
+    const std::array<const char*, count> names = {std::get<I>(fields).name...};
+    for (std::size_t i = 0; i < count; ++i) {
+        for (std::size_t j = i + 1; j < count; ++j) {
+            if (sameName(names[i], names[j])) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template <typename Field>
+struct MemberOf;
+
+template <typename Struct, typename Member>
+struct MemberOf<ToolField<Struct, Member>> {
+    using type = Member;
+};
+
+template <typename... Fields>
+constexpr bool typesSupported(const std::tuple<Fields...>*) {
+    return ((schemaType<typename MemberOf<Fields>::type>() != nullptr) && ...);
+}
+
+template <typename Args>
+constexpr auto fieldsOf() {
+    using Fields = decltype(Args::toolFields());
+    static_assert(typesSupported(static_cast<const Fields*>(nullptr)),
+                  "Tool argument fields must be bool, an integer, floating point, std::string "
+                  "or std::optional of one of those");
+    static_assert(fieldsValid(Args::toolFields(), std::make_index_sequence<std::tuple_size_v<Fields>>()),
+                  "Tool argument field names must be unique");
+    return Args::toolFields();
+}
+
+/**
+ * @brief SAX handler that writes a JSON object's members straight into Args
+ *
+ * Keys that name no field are skipped along with their values, so extra
+ * arguments from the model do no harm.
+ */
+template <typename Args>
+class ArgumentsHandler : public nlohmann::json_sax<nlohmann::json> {
+public:
+    static constexpr auto fields = fieldsOf<Args>();
+    static constexpr std::size_t fieldCount = std::tuple_size_v<std::remove_const_t<decltype(fields)>>;
+
+    explicit ArgumentsHandler(Args& args) : args_(args) {}
+
+    bool null() override { return assign(nullptr); }
+    bool boolean(bool val) override { return assign(val); }
+    bool number_integer(number_integer_t val) override { return assign(val); }
+    bool number_unsigned(number_unsigned_t val) override { return assign(val); }
+    bool number_float(number_float_t val, const string_t&) override { return assign(val); }
+    bool string(string_t& val) override { return assign(std::move(val)); }
+    bool binary(binary_t&) override { return assign(nullptr); }
+
+    bool start_object(std::size_t) override {
+        if (depth_ == 1 && field_) {
+            return fail("an object");
+        }
+        ++depth_;
+        return true;
+    }
+
+    bool key(string_t& val) override {
+        if (depth_ == 1) {
+            field_ = indexOf(val);
+        }
+        return true;
+    }
+
+    bool end_object() override {
+        --depth_;
+        if (depth_ == 1) {
+            field_.reset();
+        }
+        return true;
+    }
+
+    bool start_array(std::size_t) override {
+        if (depth_ == 0) {
+            error_ = "arguments must be a JSON object";
+            return false;
+        }
+        if (depth_ == 1 && field_) {
+            return fail("an array");
+        }
+        ++depth_;
+        return true;
+    }
+
+    bool end_array() override {
+        --depth_;
+        if (depth_ == 1) {
+            field_.reset();
+        }
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex) override {
+        error_ = ex.what();
+        return false;
+    }
+
+    // Throws llm::LLMException if the parse failed or a required field is missing
+    void finish() {
+        if (!error_.empty()) {
+            throw llm::LLMException(error_);
+        }
+        checkRequired(std::make_index_sequence<fieldCount>());
+    }
+
+private:
+    template <std::size_t... I>
+    static std::optional<std::size_t> indexOfImpl(const std::string& name, std::index_sequence<I...>) {
+        std::optional<std::size_t> index;
+        ((name == std::get<I>(fields).name ? (index = I, true) : false) || ...);
+        return index;
+    }
+
+    static std::optional<std::size_t> indexOf(const std::string& name) {
+        return indexOfImpl(name, std::make_index_sequence<fieldCount>());
+    }
+
+    template <typename Value>
+    bool assign(Value&& value) {
+        if (depth_ == 0) {
+            error_ = "arguments must be a JSON object";
+            return false;
+        }
+        if (depth_ != 1 || !field_) {
+            return true;
+        }
+        bool ok = assignTo(*field_, std::forward<Value>(value), std::make_index_sequence<fieldCount>());
+        seen_[*field_] = true;
+        field_.reset();
+        return ok;
+    }
+
+    template <typename Value, std::size_t... I>
+    bool assignTo(std::size_t index, Value&& value, std::index_sequence<I...>) {
+        bool ok = true;
+        ((index == I ? (ok = set(args_.*(std::get<I>(fields).member), std::forward<Value>(value), I), true)
+                     : false) || ...);
+        return ok;
+    }
+
+    template <typename Target, typename Value>
+    bool set(Target& target, Value&& value, std::size_t index) {
+        using Decayed = std::decay_t<Value>;
+        if constexpr (Unwrap<Target>::optional) {
+            if constexpr (std::is_same_v<Decayed, std::nullptr_t>) {
+                target.reset();
+                return true;
+            } else {
+                return set(target.emplace(), std::forward<Value>(value), index);
+            }
+        } else if constexpr (std::is_same_v<Target, bool>) {
+            if constexpr (std::is_same_v<Decayed, bool>) {
+                target = value;
+                return true;
+            }
+        } else if constexpr (std::is_integral_v<Target>) {
+            if constexpr (std::is_integral_v<Decayed> && !std::is_same_v<Decayed, bool>) {
+                using Limits = std::numeric_limits<Target>;
+                bool inRange;
+                if constexpr (std::is_signed_v<Decayed>) {
+                    inRange = value < 0 ? static_cast<std::int64_t>(value) >= static_cast<std::int64_t>(Limits::min())
+                                        : static_cast<std::uint64_t>(value) <= static_cast<std::uint64_t>(Limits::max());
+                } else {
+                    inRange = static_cast<std::uint64_t>(value) <= static_cast<std::uint64_t>(Limits::max());
+                }
+                if (!inRange) {
+                    return fail("out of range", index);
+                }
+                target = static_cast<Target>(value);
+                return true;
+            }
+        } else if constexpr (std::is_floating_point_v<Target>) {
+            if constexpr (std::is_arithmetic_v<Decayed> && !std::is_same_v<Decayed, bool>) {
+                target = static_cast<Target>(value);
+                return true;
+            }
+        } else if constexpr (std::is_same_v<Target, std::string>) {
+            if constexpr (std::is_same_v<Decayed, std::string>) {
+                target = std::forward<Value>(value);
+                return true;
+            }
+        }
+        return fail(std::string("not of type ") + schemaType<Target>(), index);
+    }
+
+    bool fail(const char* what) {
+        error_ = std::string("field \"") + fieldName(*field_) + "\" is " + what;
+        return false;
+    }
+
+    bool fail(const std::string& what, std::size_t index) {
+        error_ = std::string("field \"") + fieldName(index) + "\" is " + what;
+        return false;
+    }
+
+    template <std::size_t... I>
+    static const char* fieldNameImpl(std::size_t index, std::index_sequence<I...>) {
+        const char* name = "";
+        ((index == I ? (name = std::get<I>(fields).name, true) : false) || ...);
+        return name;
+    }
+
+    static const char* fieldName(std::size_t index) {
+        return fieldNameImpl(index, std::make_index_sequence<fieldCount>());
+    }
+
+    template <std::size_t... I>
+    void checkRequired(std::index_sequence<I...>) const {
+        (checkRequired<I>(), ...);
+    }
+
+    template <std::size_t I>
+    void checkRequired() const {
+        using Member = typename MemberOf<std::remove_const_t<std::tuple_element_t<I, std::remove_const_t<decltype(fields)>>>>::type;
+        if (!Unwrap<Member>::optional && !seen_[I]) {
+            throw llm::LLMException(std::string("missing field \"") + std::get<I>(fields).name + "\"");
+        }
+    }
+
+    Args& args_;
+    std::size_t depth_ = 0;
+    // The field whose value comes next, if the current key names one
+    std::optional<std::size_t> field_;
+    std::array<bool, fieldCount> seen_{};
+    std::string error_;
+};
+
+template <typename Fields, std::size_t... I>
+std::vector<Parameter> parametersOf(const Fields& fields, std::index_sequence<I...>) {
+    std::vector<Parameter> parameters;
+    parameters.reserve(sizeof...(I));
+    auto add = [&parameters](const auto& field) {
+        using Member = typename MemberOf<std::decay_t<decltype(field)>>::type;
+        Parameter parameter;
+        parameter.name = field.name;
+        parameter.type = schemaType<Member>();
+        parameter.description = field.description;
+        parameter.required = !Unwrap<Member>::optional;
+        parameters.push_back(std::move(parameter));
+    };
+    (add(std::get<I>(fields)), ...);
+    return parameters;
+}
+
+} // namespace typed_tool_detail
+
+// The Parameter list described by Args::toolFields()
+template <typename Args>
+std::vector<Parameter> toolParameters() {
+    constexpr auto fields = typed_tool_detail::fieldsOf<Args>();
+    return typed_tool_detail::parametersOf(
+        fields, std::make_index_sequence<std::tuple_size_v<std::remove_const_t<decltype(fields)>>>());
+}
+
+// Parses a tool call's arguments into Args in a single pass, without
+// building a JSON document.  Throws llm::LLMException when the JSON is
+// malformed, is not an object, or lacks a required field, or when a field
+// has the wrong type.
+template <typename Args>
+Args decodeToolArguments(const std::string& json) {
+    Args args{};
+    typed_tool_detail::ArgumentsHandler<Args> handler(args);
+    nlohmann::json::sax_parse(json, &handler);
+    handler.finish();
+    return args;
+}
+
+// A Tool whose function receives decoded arguments.  Arguments that don't
+// decode are answered with an error message instead of calling function,
+// so the model can correct itself.
+template <typename Args, typename Function>
+Tool makeTypedTool(std::string name, std::string description, Function function) {
+    static_assert(std::is_invocable_r_v<std::string, Function&, const Args&>,
+                  "A typed tool's function takes const Args& and returns a std::string");
+    Tool tool;
+    tool.name = std::move(name);
+    tool.description = std::move(description);
+    tool.parameters = toolParameters<Args>();
+    tool.function = [toolName = tool.name, function = std::move(function)](const std::string& json) -> std::string {
+        Args args;
+        try {
+            args = decodeToolArguments<Args>(json);
+        } catch (const llm::LLMException& e) {
+            return "Error: invalid arguments for tool " + toolName + ": " + e.what();
+        }
+        return function(args);
+    };
+    return tool;
+}
@@ -0,0 +1,45 @@
+#ifndef HTTP_CLIENT_CACHING_HTTP_CLIENT_HPP
+#define HTTP_CLIENT_CACHING_HTTP_CLIENT_HPP
+
+#include "http_client/ihttp_client.hpp"
+#include "http_client/response_cache.hpp"
+#include <memory>
+
+namespace http_client {
+
+/**
+ * @brief IHTTPClient decorator that answers repeated POSTs from a ResponseCache
+ *
+ * Only requests marked RequestOptions::idempotent are cached; the caller
+ * marks them when the response is deterministic (a fixed seed or zero
+ * temperature).  Everything else, and every non-POST method, goes straight
+ * to the wrapped client.  Only 2xx responses are stored.
+ *
+ * On a miss the request is dispatched immediately and the response is
+ * stored as soon as it arrives, whether or not the returned future is read.
+ */
+class CachingHTTPClient : public IHTTPClient {
+public:
+    CachingHTTPClient(std::shared_ptr<IHTTPClient> inner, std::shared_ptr<ResponseCache> cache);
+
+    std::future<HTTPResponse> Get(const std::string& uri, const std::vector<std::string>& headers = {}) override;
+    std::future<HTTPResponse> Put(const std::string& uri, const std::string& body, const std::vector<std::string>& headers = {}) override;
+    std::future<HTTPResponse> Post(const std::string& uri, const std::string& body, const std::vector<std::string>& headers = {}, const RequestOptions& options = {}) override;
+    std::future<HTTPResponse> Patch(const std::string& uri, const std::string& body, const std::vector<std::string>& headers = {}) override;
+    std::future<HTTPResponse> Delete(const std::string& uri, const std::vector<std::string>& headers = {}) override;
+
+    void SetTimeout(std::chrono::milliseconds timeout) override;
+    std::chrono::milliseconds GetTimeout() const override;
+
+    std::future<HTTPResponse> PostStreaming(const std::string& uri, const std::string& body, const std::vector<std::string>& headers, BodyChunkHandler onChunk, const RequestOptions& options = {}) override;
+
+    const std::shared_ptr<ResponseCache>& GetCache() const { return m_cache; }
+
+private:
+    std::shared_ptr<IHTTPClient> m_inner;
+    std::shared_ptr<ResponseCache> m_cache;
+};
+
+} // namespace http_client
+
+#endif // HTTP_CLIENT_CACHING_HTTP_CLIENT_HPP
@@ -0,0 +1,83 @@
+#ifndef HTTP_CLIENT_CASSETTE_HPP
+#define HTTP_CLIENT_CASSETTE_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace http_client {
+
+/**
+ * @brief One recorded request/response exchange
+ *
+ * Views point into the memory owned by the CassetteReader that produced
+ * them (or into caller-owned strings when writing).
+ */
+struct CassetteRecord {
+    std::string_view method;
+    std::string_view uri;
+    std::string_view requestBody;
+    std::vector<std::string_view> requestHeaders;
+    int statusCode = 0;
+    std::vector<std::string_view> responseHeaders;
+    std::string_view responseBody;
+    // From dispatch to the first body byte, and to completion
+    std::chrono::microseconds timeToFirstByte{0};
+    std::chrono::microseconds totalTime{0};
+};
+
+/**
+ * @brief Appends records to a cassette file
+ *
+ * File layout: the 8-byte magic "CQCASS1\n" followed by records, each a
+ * sequence of length-prefixed strings (uint32 length, then bytes) and
+ * little-endian integers in the order of CassetteRecord's fields.
+ * Credential headers (Authorization, api-key, x-api-key) are never written.
+ * Every record is flushed as it is written, so a crashed run keeps what it
+ * recorded.  Thread-safe.
+ */
+class CassetteWriter {
+public:
+    explicit CassetteWriter(const std::string& path);
+
+    void Write(const CassetteRecord& record);
+
+    static bool IsCredentialHeader(std::string_view header);
+
+private:
+    std::mutex m_mutex;
+    std::ofstream m_out;
+};
+
+/**
+ * @brief Memory-maps a cassette and indexes its records
+ *
+ * Opening parses only the record boundaries; bodies are not copied.
+ * Throws llm::HTTPException if the file is missing or not a cassette.  A
+ * partial record at the end, as left by a crashed recording, is dropped
+ * with a warning.
+ */
+class CassetteReader {
+public:
+    explicit CassetteReader(const std::string& path);
+    ~CassetteReader();
+
+    CassetteReader(const CassetteReader&) = delete;
+    CassetteReader& operator=(const CassetteReader&) = delete;
+
+    const std::vector<CassetteRecord>& Records() const { return m_records; }
+
+private:
+    void* m_data = nullptr;
+    std::size_t m_size = 0;
+    std::vector<CassetteRecord> m_records;
+};
+
+} // namespace http_client
+
+#endif // HTTP_CLIENT_CASSETTE_HPP
@@ -0,0 +1,61 @@
+#ifndef HTTP_CLIENT_CHUNK_STREAM_HPP
+#define HTTP_CLIENT_CHUNK_STREAM_HPP
+
+#include "http_client/ihttp_client.hpp"
+#include <condition_variable>
+#include <deque>
+#include <istream>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <string_view>
+
+namespace http_client {
+
+/**
+ * @brief Stream buffer fed by body chunks from another thread
+ *
+ * Reads block until the producer appends more data or closes the buffer,
+ * so a consumer can parse a response while it is still being received.
+ */
+class ChunkStreamBuffer : public std::streambuf {
+public:
+    // Append a chunk; an empty chunk closes the buffer
+    void Append(std::string_view chunk);
+    void Close();
+
+protected:
+    int_type underflow() override;
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<std::string> m_chunks;
+    std::string m_current;
+    bool m_closed = false;
+};
+
+/**
+ * @brief std::istream over a ChunkStreamBuffer
+ *
+ * Pass Handler() to IHTTPClient::PostStreaming and read the response body
+ * from this stream on the calling thread.  The stream must outlive the
+ * transfer.
+ */
+class ChunkStream : public std::istream {
+public:
+    ChunkStream();
+
+    ChunkStream(const ChunkStream&) = delete;
+    ChunkStream& operator=(const ChunkStream&) = delete;
+
+    void Append(std::string_view chunk);
+    BodyChunkHandler Handler();
+
+private:
+    ChunkStreamBuffer m_buffer;
+};
+
+} // namespace http_client
+
+#endif // HTTP_CLIENT_CHUNK_STREAM_HPP
@@ -0,0 +1,45 @@
+#ifndef HTTP_CLIENT_CONNECTION_POOL_HPP
+#define HTTP_CLIENT_CONNECTION_POOL_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace http_client {
+
+/**
+ * @brief Connection and handle pooling limits for CurlMultiHTTPClient
+ */
+struct ConnectionPoolOptions {
+    // Upper bound on simultaneous connections to a single host; extra
+    // transfers queue until a connection frees up.  0 means unlimited.
+    long maxConnectionsPerHost = 8;
+
+    // Upper bound on simultaneous connections overall.  0 means unlimited.
+    long maxTotalConnections = 64;
+
+    // Number of idle connections kept open for reuse.
+    long maxCachedConnections = 32;
+
+    // Idle connections older than this are closed instead of reused.
+    std::chrono::seconds maxIdleTime{60};
+
+    // Number of finished easy handles kept around for the next request.
+    std::size_t maxPooledHandles = 64;
+
+    // Negotiate HTTP/2 over TLS and multiplex concurrent requests to the
+    // same host over one connection.
+    bool enableHTTP2Multiplexing = false;
+};
+
+/**
+ * @brief Counters describing how requests obtained their connection
+ */
+struct ConnectionStats {
+    std::uint64_t newConnections = 0;
+    std::uint64_t reusedConnections = 0;
+};
+
+} // namespace http_client
+
+#endif // HTTP_CLIENT_CONNECTION_POOL_HPP
@@ -14,16 +14,22 @@ public:
 
     std::future<HTTPResponse> Get(const std::string& uri, const std::vector<std::string>& headers = {}) override;
     std::future<HTTPResponse> Put(const std::string& uri, const std::string& body, const std::vector<std::string>& headers = {}) override;
-    std::future<HTTPResponse> Post(const std::string& uri, const std::string& body, const std::vector<std::string>& headers = {}) override;
+    std::future<HTTPResponse> Post(const std::string& uri, const std::string& body, const std::vector<std::string>& headers = {}, const RequestOptions& options = {}) override;
     std::future<HTTPResponse> Patch(const std::string& uri, const std::string& body, const std::vector<std::string>& headers = {}) override;
     std::future<HTTPResponse> Delete(const std::string& uri, const std::vector<std::string>& headers = {}) override;
 
     void SetTimeout(std::chrono::milliseconds timeout) override;
     std::chrono::milliseconds GetTimeout() const override;
 
+    std::future<HTTPResponse> PostStreaming(const std::string& uri, const std::string& body, const std::vector<std::string>& headers, BodyChunkHandler onChunk, const RequestOptions& options = {}) override;
+
 private:
-    std::future<HTTPResponse> PerformRequest(const std::string& method, const std::string& uri, const std::string& body, const std::vector<std::string>& headers);
+    struct StreamingBody;
+
+    std::future<HTTPResponse> PerformRequest(const std::string& method, const std::string& uri, const std::string& body, const std::vector<std::string>& headers, BodyChunkHandler onChunk = nullptr, const RequestOptions& options = {});
     static size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* s);
+    static int ProgressCallback(void* clientp, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal, curl_off_t ulnow);
+    static size_t StreamingWriteCallback(void* contents, size_t size, size_t nmemb, StreamingBody* s);
 
     CURL* m_curl;
     std::chrono::milliseconds m_timeout;
@@ -0,0 +1,80 @@
+#ifndef HTTP_CLIENT_CURL_MULTI_HTTP_CLIENT_HPP
+#define HTTP_CLIENT_CURL_MULTI_HTTP_CLIENT_HPP
+
+#include "http_client/ihttp_client.hpp"
+#include "http_client/connection_pool.hpp"
+#include <curl/curl.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace http_client {
+
+/**
+ * @brief IHTTPClient backed by a single curl_multi event loop
+ *
+ * Every request is handed to one I/O thread that drives all transfers
+ * through curl_multi, so any number of requests can be in flight at once
+ * without a thread per request.  Futures are fulfilled from the I/O thread
+ * when the corresponding transfer completes.
+ *
+ * Connections are kept alive in the multi handle's connection cache and
+ * finished easy handles are pooled, so repeated requests to the same host
+ * skip the TCP and TLS handshakes.  See ConnectionPoolOptions for limits.
+ */
+class CurlMultiHTTPClient : public IHTTPClient {
+public:
+    explicit CurlMultiHTTPClient(ConnectionPoolOptions options = {});
+    ~CurlMultiHTTPClient() override;
+
+    CurlMultiHTTPClient(const CurlMultiHTTPClient&) = delete;
+    CurlMultiHTTPClient& operator=(const CurlMultiHTTPClient&) = delete;
+
+    std::future<HTTPResponse> Get(const std::string& uri, const std::vector<std::string>& headers = {}) override;
+    std::future<HTTPResponse> Put(const std::string& uri, const std::string& body, const std::vector<std::string>& headers = {}) override;
+    std::future<HTTPResponse> Post(const std::string& uri, const std::string& body, const std::vector<std::string>& headers = {}, const RequestOptions& options = {}) override;
+    std::future<HTTPResponse> Patch(const std::string& uri, const std::string& body, const std::vector<std::string>& headers = {}) override;
+    std::future<HTTPResponse> Delete(const std::string& uri, const std::vector<std::string>& headers = {}) override;
+
+    void SetTimeout(std::chrono::milliseconds timeout) override;
+    std::chrono::milliseconds GetTimeout() const override;
+
+    std::future<HTTPResponse> PostStreaming(const std::string& uri, const std::string& body, const std::vector<std::string>& headers, BodyChunkHandler onChunk, const RequestOptions& options = {}) override;
+
+    ConnectionStats GetConnectionStats() const;
+
+private:
+    struct Transfer;
+
+    std::future<HTTPResponse> PerformRequest(const std::string& method, const std::string& uri, const std::string& body, const std::vector<std::string>& headers, BodyChunkHandler onChunk = nullptr, const RequestOptions& options = {});
+    void EventLoop();
+    void AddPendingTransfers();
+    void ReapCompletedTransfers();
+    void AbortCancelledTransfers();
+    CURL* AcquireHandle();
+    void ReleaseHandle(CURL* easy);
+    void FailAll(std::unordered_map<CURL*, std::unique_ptr<Transfer>>& transfers, const std::string& reason);
+    static size_t WriteCallback(void* contents, size_t size, size_t nmemb, void* userdata);
+
+    CURLM* m_multi;
+    ConnectionPoolOptions m_options;
+    std::chrono::milliseconds m_timeout;
+    mutable std::mutex m_mutex;
+    std::unordered_map<CURL*, std::unique_ptr<Transfer>> m_pending;
+    std::vector<CURL*> m_idleHandles;
+
+    std::atomic<std::uint64_t> m_newConnections;
+    std::atomic<std::uint64_t> m_reusedConnections;
+
+    // Only touched by the I/O thread
+    std::unordered_map<CURL*, std::unique_ptr<Transfer>> m_active;
+
+    std::atomic<bool> m_running;
+    std::thread m_ioThread;
+};
+
+} // namespace http_client
+
+#endif // HTTP_CLIENT_CURL_MULTI_HTTP_CLIENT_HPP
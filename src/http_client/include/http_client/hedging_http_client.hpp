@@ -0,0 +1,78 @@
+#ifndef HTTP_CLIENT_HEDGING_HTTP_CLIENT_HPP
+#define HTTP_CLIENT_HEDGING_HTTP_CLIENT_HPP
+
+#include "http_client/ihttp_client.hpp"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+namespace http_client {
+
+struct HedgingOptions {
+    // A duplicate is sent once a request has taken longer than this
+    // percentile of recent latencies
+    double percentile = 0.95;
+    // Number of recent latencies the percentile is taken over
+    std::size_t window = 256;
+    // Until this many latencies are known, initialDelay is used instead;
+    // a zero initialDelay means no hedging until then
+    std::size_t minSamples = 20;
+    std::chrono::milliseconds initialDelay{0};
+    std::chrono::milliseconds minDelay{10};
+    // Hedges allowed per eligible request, so a slow provider is not
+    // answered with double the load
+    double maxHedgeFraction = 0.1;
+};
+
+struct HedgingStats {
+    std::uint64_t eligible = 0;
+    std::uint64_t hedgesSent = 0;
+    // Hedges that answered before the original request
+    std::uint64_t hedgesWon = 0;
+    std::chrono::milliseconds currentDelay{0};
+};
+
+/**
+ * @brief IHTTPClient decorator that duplicates slow idempotent POSTs
+ *
+ * Only POSTs marked RequestOptions::idempotent are hedged; the session
+ * marks deterministic requests (a fixed seed or zero temperature).
+ * When such a request has not answered within the configured percentile of
+ * recent latency, one identical request is sent and the first 2xx response
+ * to arrive wins.  A transport error or non-2xx answer is only returned if
+ * the other request fails too, and only 2xx latencies feed the percentile.
+ * The losing request is cancelled through its own CancellationToken;
+ * cancelling the caller's token cancels both.
+ *
+ * Streaming requests pass straight through: their chunks go to the caller
+ * as they arrive, so there is nothing to race.  The original request is
+ * dispatched immediately and the hedge timer runs on a worker thread, so
+ * the hedge is sent on time whether or not the returned future is read.
+ */
+class HedgingHTTPClient : public IHTTPClient {
+public:
+    explicit HedgingHTTPClient(std::shared_ptr<IHTTPClient> inner, HedgingOptions options = {});
+
+    std::future<HTTPResponse> Get(const std::string& uri, const std::vector<std::string>& headers = {}) override;
+    std::future<HTTPResponse> Put(const std::string& uri, const std::string& body, const std::vector<std::string>& headers = {}) override;
+    std::future<HTTPResponse> Post(const std::string& uri, const std::string& body, const std::vector<std::string>& headers = {}, const RequestOptions& options = {}) override;
+    std::future<HTTPResponse> Patch(const std::string& uri, const std::string& body, const std::vector<std::string>& headers = {}) override;
+    std::future<HTTPResponse> Delete(const std::string& uri, const std::vector<std::string>& headers = {}) override;
+
+    void SetTimeout(std::chrono::milliseconds timeout) override;
+    std::chrono::milliseconds GetTimeout() const override;
+
+    std::future<HTTPResponse> PostStreaming(const std::string& uri, const std::string& body, const std::vector<std::string>& headers, BodyChunkHandler onChunk, const RequestOptions& options = {}) override;
+
+    HedgingStats GetStats() const;
+
+private:
+    struct Tracker;
+
+    std::shared_ptr<IHTTPClient> m_inner;
+    std::shared_ptr<Tracker> m_tracker;
+};
+
+} // namespace http_client
+
+#endif // HTTP_CLIENT_HEDGING_HTTP_CLIENT_HPP
@@ -1,17 +1,66 @@
 #ifndef HTTP_CLIENT_HTTP_RESPONSE_HPP
 #define HTTP_CLIENT_HTTP_RESPONSE_HPP
 
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace http_client {
 
+/**
+ * @brief Where the time of one transfer went, as reported by curl
+ *
+ * Phases are measured from the start of the transfer and are cumulative, as
+ * curl reports them: timeToFirstByte includes DNS, connect and TLS.  Phases
+ * that did not happen (a reused connection, plain HTTP) are zero.  Responses
+ * that did not touch the network, e.g. cache hits, carry all zeros.
+ */
+struct TransferTiming {
+    std::chrono::microseconds nameLookup{0};
+    std::chrono::microseconds connect{0};
+    std::chrono::microseconds tlsHandshake{0};
+    std::chrono::microseconds timeToFirstByte{0};
+    std::chrono::microseconds total{0};
+    std::uint64_t bytesUploaded = 0;
+    std::uint64_t bytesDownloaded = 0;
+    bool connectionReused = false;
+};
+
 struct HTTPResponse {
     int statusCode;
     std::vector<std::string> headers;
     std::string body;
+    TransferTiming timing;
 };
 
+// Value of the first "Name: value" header whose name matches (ASCII
+// case-insensitive), with surrounding whitespace removed
+inline std::optional<std::string_view> FindHeader(const std::vector<std::string>& headers, std::string_view name) {
+    for (const auto& header : headers) {
+        std::string_view line(header);
+        if (line.size() <= name.size() || line[name.size()] != ':' ||
+            !std::equal(name.begin(), name.end(), line.begin(), [](char a, char b) {
+                return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+            })) {
+            continue;
+        }
+        std::string_view value = line.substr(name.size() + 1);
+        while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+            value.remove_prefix(1);
+        }
+        while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+            value.remove_suffix(1);
+        }
+        return value;
+    }
+    return std::nullopt;
+}
+
 } // namespace http_client
 
 #endif // HTTP_CLIENT_HTTP_RESPONSE_HPP
@@ -2,25 +2,65 @@
 #define HTTP_CLIENT_IHTTP_CLIENT_HPP
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <functional>
 #include <future>
 #include <chrono>
 #include "http_response.hpp"
+#include "request_options.hpp"
 
 namespace http_client {
 
+// Receives the response body piece by piece as it arrives.  An empty chunk
+// marks the end of the body.
+using BodyChunkHandler = std::function<void(std::string_view chunk)>;
+
 class IHTTPClient {
 public:
     virtual ~IHTTPClient() = default;
 
     virtual std::future<HTTPResponse> Get(const std::string& uri, const std::vector<std::string>& headers = {}) = 0;
     virtual std::future<HTTPResponse> Put(const std::string& uri, const std::string& body, const std::vector<std::string>& headers = {}) = 0;
-    virtual std::future<HTTPResponse> Post(const std::string& uri, const std::string& body, const std::vector<std::string>& headers = {}) = 0;
+    // options carries a per-request deadline and cancellation token; a
+    // request that is cancelled or runs out of time fails with
+    // llm::HTTPException and releases its connection
+    virtual std::future<HTTPResponse> Post(const std::string& uri, const std::string& body, const std::vector<std::string>& headers = {}, const RequestOptions& options = {}) = 0;
     virtual std::future<HTTPResponse> Patch(const std::string& uri, const std::string& body, const std::vector<std::string>& headers = {}) = 0;
     virtual std::future<HTTPResponse> Delete(const std::string& uri, const std::vector<std::string>& headers = {}) = 0;
 
     virtual void SetTimeout(std::chrono::milliseconds timeout) = 0;
     virtual std::chrono::milliseconds GetTimeout() const = 0;
+
+    /**
+     * @brief POST whose successful (2xx) response body is delivered through onChunk
+     *
+     * For 2xx responses HTTPResponse::body is left empty; any other status is
+     * buffered into HTTPResponse::body as usual.  onChunk is called with an
+     * empty chunk exactly once when the transfer ends, whether or not it
+     * succeeded, and before the returned future becomes ready.
+     *
+     * The default implementation buffers the whole response via Post and
+     * hands it over in a single chunk.
+     */
+    virtual std::future<HTTPResponse> PostStreaming(const std::string& uri, const std::string& body, const std::vector<std::string>& headers, BodyChunkHandler onChunk, const RequestOptions& options = {}) {
+        std::promise<HTTPResponse> promise;
+        try {
+            HTTPResponse response = Post(uri, body, headers, options).get();
+            if (response.statusCode >= 200 && response.statusCode < 300) {
+                if (!response.body.empty()) {
+                    onChunk(response.body);
+                }
+                response.body.clear();
+            }
+            onChunk({});
+            promise.set_value(std::move(response));
+        } catch (...) {
+            onChunk({});
+            promise.set_exception(std::current_exception());
+        }
+        return promise.get_future();
+    }
 };
 
 } // namespace http_client
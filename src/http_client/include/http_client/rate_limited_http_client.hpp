@@ -0,0 +1,93 @@
+#ifndef HTTP_CLIENT_RATE_LIMITED_HTTP_CLIENT_HPP
+#define HTTP_CLIENT_RATE_LIMITED_HTTP_CLIENT_HPP
+
+#include "http_client/ihttp_client.hpp"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace http_client {
+
+struct RateLimitOptions {
+    // Starting limits for every endpoint; 0 leaves a limit open until the
+    // server announces one in its x-ratelimit-limit-* headers
+    double requestsPerMinute = 0;
+    double tokensPerMinute = 0;
+    // Retries after a 429 or 5xx before the response is handed back as is
+    int maxRetries = 4;
+    std::chrono::milliseconds baseBackoff{500};
+    std::chrono::milliseconds maxBackoff{30000};
+};
+
+struct RateLimitStats {
+    std::uint64_t requests = 0;
+    // Requests that had to wait for capacity before being sent
+    std::uint64_t throttled = 0;
+    std::uint64_t retries = 0;
+};
+
+/**
+ * @brief IHTTPClient decorator that paces requests per endpoint and retries 429/5xx
+ *
+ * Each endpoint (scheme, host and port of the URI) gets two token buckets:
+ * requests per minute and tokens per minute, a request costing its estimated
+ * prompt size plus any max_tokens it asks for.  The buckets start from
+ * RateLimitOptions and follow the server's x-ratelimit-limit-*,
+ * x-ratelimit-remaining-* and x-ratelimit-reset-* headers; Retry-After on a
+ * 429 pauses the whole endpoint.  Requests wait for capacity instead of
+ * failing.
+ *
+ * 429, 500, 502, 503 and 504 responses are retried with exponential backoff
+ * and full jitter, honouring Retry-After when it is longer.  Transport
+ * errors are passed through untouched.  Waiting for capacity or a retry
+ * stops as soon as the request is cancelled or its deadline passes.
+ *
+ * A request that finds capacity is dispatched immediately; one that has to
+ * wait, and every retry, is sent by a worker thread as soon as capacity
+ * allows, whether or not the returned future is being read.  Streaming
+ * requests complete on a worker thread so the caller can consume chunks
+ * meanwhile; onChunk sees only the final attempt's body and the end marker
+ * exactly once.
+ */
+class RateLimitedHTTPClient : public IHTTPClient {
+public:
+    explicit RateLimitedHTTPClient(std::shared_ptr<IHTTPClient> inner, RateLimitOptions options = {});
+
+    std::future<HTTPResponse> Get(const std::string& uri, const std::vector<std::string>& headers = {}) override;
+    std::future<HTTPResponse> Put(const std::string& uri, const std::string& body, const std::vector<std::string>& headers = {}) override;
+    std::future<HTTPResponse> Post(const std::string& uri, const std::string& body, const std::vector<std::string>& headers = {}, const RequestOptions& options = {}) override;
+    std::future<HTTPResponse> Patch(const std::string& uri, const std::string& body, const std::vector<std::string>& headers = {}) override;
+    std::future<HTTPResponse> Delete(const std::string& uri, const std::vector<std::string>& headers = {}) override;
+
+    void SetTimeout(std::chrono::milliseconds timeout) override;
+    std::chrono::milliseconds GetTimeout() const override;
+
+    std::future<HTTPResponse> PostStreaming(const std::string& uri, const std::string& body, const std::vector<std::string>& headers, BodyChunkHandler onChunk, const RequestOptions& options = {}) override;
+
+    RateLimitStats GetStats() const;
+
+    // "scheme://host:port" of a URI, or "unix:<path>" for a Unix socket URI;
+    // requests to the same endpoint share limits
+    static std::string EndpointFor(const std::string& uri);
+    // Roughly four bytes per token for the body, plus its max_tokens if any
+    static double EstimateTokens(const std::string& body);
+    // Durations as rate-limit headers write them: "20ms", "1.5s", "6m0s",
+    // "1h2m", or a bare number of seconds
+    static std::optional<std::chrono::milliseconds> ParseDuration(std::string_view text);
+
+private:
+    struct Limiter;
+    using Attempt = std::function<std::future<HTTPResponse>()>;
+
+    std::future<HTTPResponse> Send(const std::string& uri, double tokens, Attempt attempt, const RequestOptions& options = {});
+
+    std::shared_ptr<IHTTPClient> m_inner;
+    std::shared_ptr<Limiter> m_limiter;
+};
+
+} // namespace http_client
+
+#endif // HTTP_CLIENT_RATE_LIMITED_HTTP_CLIENT_HPP
@@ -0,0 +1,47 @@
+#ifndef HTTP_CLIENT_RECORDING_HTTP_CLIENT_HPP
+#define HTTP_CLIENT_RECORDING_HTTP_CLIENT_HPP
+
+#include "http_client/ihttp_client.hpp"
+#include "http_client/cassette.hpp"
+#include <functional>
+#include <memory>
+
+namespace http_client {
+
+/**
+ * @brief IHTTPClient decorator that writes every exchange to a cassette
+ *
+ * Requests are forwarded to the wrapped client unchanged.  Each completed
+ * exchange is appended to the cassette together with its time to first
+ * byte and total time, measured from dispatch, as soon as the wrapped
+ * client completes it, whether or not the response is ever read.
+ * Credential headers are not recorded.  A request that fails in the
+ * transport (the future throws) is not recorded.
+ */
+class RecordingHTTPClient : public IHTTPClient {
+public:
+    RecordingHTTPClient(std::shared_ptr<IHTTPClient> inner, const std::string& cassettePath);
+
+    std::future<HTTPResponse> Get(const std::string& uri, const std::vector<std::string>& headers = {}) override;
+    std::future<HTTPResponse> Put(const std::string& uri, const std::string& body, const std::vector<std::string>& headers = {}) override;
+    std::future<HTTPResponse> Post(const std::string& uri, const std::string& body, const std::vector<std::string>& headers = {}, const RequestOptions& options = {}) override;
+    std::future<HTTPResponse> Patch(const std::string& uri, const std::string& body, const std::vector<std::string>& headers = {}) override;
+    std::future<HTTPResponse> Delete(const std::string& uri, const std::vector<std::string>& headers = {}) override;
+
+    void SetTimeout(std::chrono::milliseconds timeout) override;
+    std::chrono::milliseconds GetTimeout() const override;
+
+    std::future<HTTPResponse> PostStreaming(const std::string& uri, const std::string& body, const std::vector<std::string>& headers, BodyChunkHandler onChunk, const RequestOptions& options = {}) override;
+
+private:
+    std::future<HTTPResponse> Record(const std::string& method, const std::string& uri, const std::string& body,
+                                     const std::vector<std::string>& headers,
+                                     const std::function<std::future<HTTPResponse>()>& dispatch);
+
+    std::shared_ptr<IHTTPClient> m_inner;
+    std::shared_ptr<CassetteWriter> m_writer;
+};
+
+} // namespace http_client
+
+#endif // HTTP_CLIENT_RECORDING_HTTP_CLIENT_HPP
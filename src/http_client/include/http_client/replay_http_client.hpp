@@ -0,0 +1,76 @@
+#ifndef HTTP_CLIENT_REPLAY_HTTP_CLIENT_HPP
+#define HTTP_CLIENT_REPLAY_HTTP_CLIENT_HPP
+
+#include "http_client/ihttp_client.hpp"
+#include "http_client/cassette.hpp"
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+namespace http_client {
+
+/**
+ * @brief IHTTPClient that answers from a recorded cassette, offline
+ *
+ * Requests are matched on method, URI and exact body; headers are ignored,
+ * so no credentials are needed.  When the same request was recorded
+ * several times the recordings are served in order, and the last one is
+ * repeated once they run out.  An unmatched request fails with
+ * llm::HTTPException.
+ *
+ * With replayLatency set, responses become ready after the recorded total
+ * time and streamed bodies start after the recorded time to first byte.
+ */
+class ReplayHTTPClient : public IHTTPClient {
+public:
+    explicit ReplayHTTPClient(const std::string& cassettePath, bool replayLatency = false);
+
+    std::future<HTTPResponse> Get(const std::string& uri, const std::vector<std::string>& headers = {}) override;
+    std::future<HTTPResponse> Put(const std::string& uri, const std::string& body, const std::vector<std::string>& headers = {}) override;
+    std::future<HTTPResponse> Post(const std::string& uri, const std::string& body, const std::vector<std::string>& headers = {}, const RequestOptions& options = {}) override;
+    std::future<HTTPResponse> Patch(const std::string& uri, const std::string& body, const std::vector<std::string>& headers = {}) override;
+    std::future<HTTPResponse> Delete(const std::string& uri, const std::vector<std::string>& headers = {}) override;
+
+    void SetTimeout(std::chrono::milliseconds timeout) override;
+    std::chrono::milliseconds GetTimeout() const override;
+
+    std::future<HTTPResponse> PostStreaming(const std::string& uri, const std::string& body, const std::vector<std::string>& headers, BodyChunkHandler onChunk, const RequestOptions& options = {}) override;
+
+    std::size_t RecordCount() const { return m_cassette.Records().size(); }
+
+private:
+    // Views into the mapped cassette, or into the request being matched
+    struct RequestKey {
+        std::string_view method;
+        std::string_view uri;
+        std::string_view body;
+
+        bool operator==(const RequestKey& other) const {
+            return method == other.method && uri == other.uri && body == other.body;
+        }
+    };
+
+    struct RequestKeyHash {
+        std::size_t operator()(const RequestKey& key) const;
+    };
+
+    struct Recordings {
+        std::vector<const CassetteRecord*> records;
+        std::size_t next = 0;
+    };
+
+    const CassetteRecord& Match(std::string_view method, std::string_view uri, std::string_view body);
+    std::future<HTTPResponse> Replay(std::string_view method, const std::string& uri, std::string_view body, const RequestOptions& options = {});
+    static HTTPResponse ToResponse(const CassetteRecord& record);
+
+    CassetteReader m_cassette;
+    bool m_replayLatency;
+    std::chrono::milliseconds m_timeout;
+    std::mutex m_mutex;
+    std::unordered_map<RequestKey, Recordings, RequestKeyHash> m_index;
+};
+
+} // namespace http_client
+
+#endif // HTTP_CLIENT_REPLAY_HTTP_CLIENT_HPP
@@ -0,0 +1,62 @@
+#ifndef HTTP_CLIENT_REQUEST_OPTIONS_HPP
+#define HTTP_CLIENT_REQUEST_OPTIONS_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+
+namespace http_client {
+
+/**
+ * @brief Shared flag that aborts the requests it is passed to
+ *
+ * Copies share state, so the token handed to a request can be cancelled
+ * from any thread through any copy.  Cancelling is permanent.
+ */
+class CancellationToken {
+public:
+    CancellationToken();
+
+    void Cancel() const;
+    bool IsCancelled() const;
+
+    // Runs callback once when the token is cancelled, or straight away if it
+    // already is.  Callbacks run under the token's lock: keep them short and
+    // do not touch the token from them.  Returns an id for Unregister.
+    std::uint64_t OnCancel(std::function<void()> callback) const;
+    // After this returns the callback is not running and will not run
+    void Unregister(std::uint64_t id) const;
+
+private:
+    struct State;
+    std::shared_ptr<State> m_state;
+};
+
+struct RequestOptions {
+    // The response must have arrived by then; tighter than SetTimeout wins
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+    std::optional<CancellationToken> cancellation;
+    // Repeating the request gets the same answer, so decorators may serve it
+    // from a cache or send it twice (hedging).  Never sent to the server.
+    bool idempotent = false;
+
+    bool IsCancelled() const { return cancellation && cancellation->IsCancelled(); }
+    bool IsExpired() const { return deadline && std::chrono::steady_clock::now() >= *deadline; }
+
+    // Time left before the deadline, capped at timeout (zero meaning none).
+    // Never zero when there is a deadline, so it suits CURLOPT_TIMEOUT_MS.
+    std::chrono::milliseconds TimeLeft(std::chrono::milliseconds timeout) const;
+
+    // Throws llm::HTTPException if the request is cancelled or past its deadline
+    void ThrowIfDone() const;
+
+    // Sleeps until then, but throws as ThrowIfDone as soon as the request is
+    // cancelled or its deadline passes
+    void SleepUntil(std::chrono::steady_clock::time_point until) const;
+};
+
+} // namespace http_client
+
+#endif // HTTP_CLIENT_REQUEST_OPTIONS_HPP
@@ -0,0 +1,101 @@
+#ifndef HTTP_CLIENT_RESPONSE_CACHE_HPP
+#define HTTP_CLIENT_RESPONSE_CACHE_HPP
+
+#include "http_client/http_response.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace http_client {
+
+/**
+ * @brief Limits for ResponseCache
+ */
+struct ResponseCacheOptions {
+    // In-memory tier; the least recently used entry is evicted first
+    std::size_t maxEntries = 1024;
+    std::size_t maxMemoryBytes = 64 * 1024 * 1024;
+
+    // Entries older than this are treated as missing.  0 means no expiry.
+    std::chrono::seconds ttl{24 * 60 * 60};
+
+    // Optional on-disk tier, one file per entry; survives restarts
+    std::optional<std::string> diskDirectory;
+    // When exceeded, the oldest files are removed
+    std::uintmax_t maxDiskBytes = 1024ull * 1024 * 1024;
+};
+
+struct ResponseCacheStats {
+    std::uint64_t hits = 0;
+    std::uint64_t diskHits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t stores = 0;
+    std::uint64_t evictions = 0;
+};
+
+/**
+ * @brief Content-addressed store of HTTP responses
+ *
+ * Entries are keyed by KeyFor(uri, body), a hash of the request target and
+ * its exact body bytes, so requests serialized the same way share an entry.
+ * Lookups check memory first, then disk, promoting disk hits into memory.
+ * Both tiers also hold the request itself, which must match before the
+ * entry is served; unreadable entries are misses.  Thread-safe, and file
+ * IO is done without holding the lock.
+ */
+class ResponseCache {
+public:
+    explicit ResponseCache(ResponseCacheOptions options = {});
+
+    ResponseCache(const ResponseCache&) = delete;
+    ResponseCache& operator=(const ResponseCache&) = delete;
+
+    // 64-bit FNV-1a over uri and body, plus the body length, as hex
+    static std::string KeyFor(std::string_view uri, std::string_view body);
+
+    std::optional<HTTPResponse> Lookup(std::string_view uri, std::string_view body);
+    void Store(std::string_view uri, std::string_view body, const HTTPResponse& response);
+    void Clear();
+
+    ResponseCacheStats GetStats() const;
+
+private:
+    using Clock = std::chrono::system_clock;
+
+    struct Entry {
+        std::string key;
+        std::string uri;
+        std::string body;
+        HTTPResponse response;
+        Clock::time_point storedAt;
+        std::size_t bytes;
+    };
+
+    bool Expired(Clock::time_point storedAt) const;
+    void InsertInMemory(const std::string& key, std::string_view uri, std::string_view body, HTTPResponse response,
+                        Clock::time_point storedAt);
+    std::optional<HTTPResponse> ReadFromDisk(const std::string& key, std::string_view uri, std::string_view body,
+                                             Clock::time_point& storedAt) const;
+    void WriteToDisk(const std::string& key, std::string_view uri, std::string_view body,
+                     const HTTPResponse& response, Clock::time_point storedAt);
+    void TrimDisk();
+
+    ResponseCacheOptions m_options;
+    mutable std::mutex m_mutex;
+    // Front is most recently used
+    std::list<Entry> m_lru;
+    std::unordered_map<std::string, std::list<Entry>::iterator> m_index;
+    std::size_t m_memoryBytes = 0;
+    std::uintmax_t m_diskBytes = 0;
+    ResponseCacheStats m_stats;
+};
+
+} // namespace http_client
+
+#endif // HTTP_CLIENT_RESPONSE_CACHE_HPP
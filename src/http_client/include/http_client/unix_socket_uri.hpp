@@ -0,0 +1,44 @@
+#ifndef HTTP_CLIENT_UNIX_SOCKET_URI_HPP
+#define HTTP_CLIENT_UNIX_SOCKET_URI_HPP
+
+#include "exceptions/llm_exceptions.hpp"
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace http_client {
+
+// A request sent over a Unix domain socket: the URL's host only goes into
+// the Host header, the connection is made to socketPath
+struct UnixSocketUri {
+    std::string socketPath;
+    std::string url;
+};
+
+// Splits "unix:<socket path>:<url>", e.g.
+// "unix:/run/llm.sock:http://localhost/v1/chat/completions".  The path ends
+// at the last ":http://" or ":https://", so it may itself contain colons.
+// Any other URI is an ordinary TCP URL and yields nullopt.  A "unix:" URI
+// without a socket path or URL throws llm::HTTPException rather than
+// being sent over TCP.
+inline std::optional<UnixSocketUri> ParseUnixSocketUri(std::string_view uri) {
+    constexpr std::string_view kPrefix = "unix:";
+    if (uri.substr(0, kPrefix.size()) != kPrefix) {
+        return std::nullopt;
+    }
+    auto split = uri.rfind(":http://");
+    auto secure = uri.rfind(":https://");
+    if (split == std::string_view::npos || (secure != std::string_view::npos && secure > split)) {
+        split = secure;
+    }
+    if (split == std::string_view::npos || split <= kPrefix.size()) {
+        throw llm::HTTPException("Malformed Unix socket URI (expected unix:<socket path>:<url>): " +
+                                 std::string(uri));
+    }
+    return UnixSocketUri{std::string(uri.substr(kPrefix.size(), split - kPrefix.size())),
+                         std::string(uri.substr(split + 1))};
+}
+
+} // namespace http_client
+
+#endif // HTTP_CLIENT_UNIX_SOCKET_URI_HPP
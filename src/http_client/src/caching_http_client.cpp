@@ -0,0 +1,100 @@
+#include "http_client/caching_http_client.hpp"
+#include "when_ready.hpp"
+
+namespace http_client {
+
+namespace {
+
+std::future<HTTPResponse> Ready(HTTPResponse response) {
+    std::promise<HTTPResponse> promise;
+    promise.set_value(std::move(response));
+    return promise.get_future();
+}
+
+bool IsSuccess(const HTTPResponse& response) {
+    return response.statusCode >= 200 && response.statusCode < 300;
+}
+
+} // namespace
+
+CachingHTTPClient::CachingHTTPClient(std::shared_ptr<IHTTPClient> inner, std::shared_ptr<ResponseCache> cache)
+    : m_inner(std::move(inner)), m_cache(std::move(cache)) {}
+
+std::future<HTTPResponse> CachingHTTPClient::Get(const std::string& uri, const std::vector<std::string>& headers) {
+    return m_inner->Get(uri, headers);
+}
+
+std::future<HTTPResponse> CachingHTTPClient::Put(const std::string& uri, const std::string& body, const std::vector<std::string>& headers) {
+    return m_inner->Put(uri, body, headers);
+}
+
+std::future<HTTPResponse> CachingHTTPClient::Post(const std::string& uri, const std::string& body, const std::vector<std::string>& headers, const RequestOptions& options) {
+    if (!options.idempotent) {
+        return m_inner->Post(uri, body, headers, options);
+    }
+
+    if (auto cached = m_cache->Lookup(uri, body)) {
+        cached->timing = {};
+        return Ready(std::move(*cached));
+    }
+
+    // Stored as soon as the response arrives, whether or not the caller reads it
+    return WhenReady(m_inner->Post(uri, body, headers, options),
+        [cache = m_cache, uri, body](HTTPResponse response) {
+            if (IsSuccess(response)) {
+                cache->Store(uri, body, response);
+            }
+            return response;
+        });
+}
+
+std::future<HTTPResponse> CachingHTTPClient::Patch(const std::string& uri, const std::string& body, const std::vector<std::string>& headers) {
+    return m_inner->Patch(uri, body, headers);
+}
+
+std::future<HTTPResponse> CachingHTTPClient::Delete(const std::string& uri, const std::vector<std::string>& headers) {
+    return m_inner->Delete(uri, headers);
+}
+
+void CachingHTTPClient::SetTimeout(std::chrono::milliseconds timeout) {
+    m_inner->SetTimeout(timeout);
+}
+
+std::chrono::milliseconds CachingHTTPClient::GetTimeout() const {
+    return m_inner->GetTimeout();
+}
+
+std::future<HTTPResponse> CachingHTTPClient::PostStreaming(const std::string& uri, const std::string& body, const std::vector<std::string>& headers, BodyChunkHandler onChunk, const RequestOptions& options) {
+    if (!options.idempotent) {
+        return m_inner->PostStreaming(uri, body, headers, std::move(onChunk), options);
+    }
+
+    if (auto cached = m_cache->Lookup(uri, body)) {
+        if (!cached->body.empty()) {
+            onChunk(cached->body);
+        }
+        onChunk({});
+        cached->body.clear();
+        cached->timing = {};
+        return Ready(std::move(*cached));
+    }
+
+    // Keep a copy of the streamed body so the complete response can be stored
+    auto captured = std::make_shared<std::string>();
+    auto pending = m_inner->PostStreaming(uri, body, headers,
+        [captured, onChunk = std::move(onChunk)](std::string_view chunk) {
+            captured->append(chunk);
+            onChunk(chunk);
+        }, options);
+    return WhenReady(std::move(pending),
+        [cache = m_cache, uri, body, captured](HTTPResponse response) {
+            if (IsSuccess(response)) {
+                HTTPResponse stored = response;
+                stored.body = std::move(*captured);
+                cache->Store(uri, body, stored);
+            }
+            return response;
+        });
+}
+
+} // namespace http_client
@@ -0,0 +1,181 @@
+#include "http_client/cassette.hpp"
+#include "exceptions/llm_exceptions.hpp"
+#include <spdlog/spdlog.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace http_client {
+
+namespace {
+
+constexpr char kMagic[] = "CQCASS1\n";
+constexpr std::size_t kMagicSize = sizeof(kMagic) - 1;
+
+template <typename T>
+void WriteInteger(std::ostream& out, T value) {
+    unsigned char bytes[sizeof(T)];
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        bytes[i] = static_cast<unsigned char>(static_cast<std::uint64_t>(value) >> (8 * i));
+    }
+    out.write(reinterpret_cast<const char*>(bytes), sizeof(T));
+}
+
+void WriteString(std::ostream& out, std::string_view value) {
+    WriteInteger<std::uint32_t>(out, static_cast<std::uint32_t>(value.size()));
+    out.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+void WriteStrings(std::ostream& out, const std::vector<std::string_view>& values) {
+    WriteInteger<std::uint32_t>(out, static_cast<std::uint32_t>(values.size()));
+    for (auto value : values) {
+        WriteString(out, value);
+    }
+}
+
+// Bounds-checked cursor over the mapped file
+class Cursor {
+public:
+    Cursor(const char* data, std::size_t size) : m_data(data), m_size(size) {}
+
+    bool AtEnd() const { return m_offset == m_size; }
+
+    template <typename T>
+    T Integer() {
+        Require(sizeof(T));
+        std::uint64_t value = 0;
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            value |= static_cast<std::uint64_t>(static_cast<unsigned char>(m_data[m_offset + i])) << (8 * i);
+        }
+        m_offset += sizeof(T);
+        return static_cast<T>(value);
+    }
+
+    std::string_view String() {
+        auto size = Integer<std::uint32_t>();
+        Require(size);
+        std::string_view value(m_data + m_offset, size);
+        m_offset += size;
+        return value;
+    }
+
+    std::vector<std::string_view> Strings() {
+        auto count = Integer<std::uint32_t>();
+        std::vector<std::string_view> values;
+        values.reserve(std::min<std::size_t>(count, 64));
+        for (std::uint32_t i = 0; i < count; ++i) {
+            values.push_back(String());
+        }
+        return values;
+    }
+
+private:
+    void Require(std::size_t bytes) const {
+        if (m_size - m_offset < bytes) {
+            throw llm::HTTPException("Truncated cassette record");
+        }
+    }
+
+    const char* m_data;
+    std::size_t m_size;
+    std::size_t m_offset = 0;
+};
+
+} // namespace
+
+CassetteWriter::CassetteWriter(const std::string& path)
+    : m_out(path, std::ios::binary | std::ios::trunc) {
+    if (!m_out) {
+        throw llm::HTTPException("Unable to create cassette: " + path);
+    }
+    m_out.write(kMagic, kMagicSize);
+    m_out.flush();
+}
+
+bool CassetteWriter::IsCredentialHeader(std::string_view header) {
+    auto colon = header.find(':');
+    std::string name(header.substr(0, colon));
+    std::transform(name.begin(), name.end(), name.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return name == "authorization" || name == "api-key" || name == "x-api-key";
+}
+
+void CassetteWriter::Write(const CassetteRecord& record) {
+    std::vector<std::string_view> requestHeaders;
+    for (auto header : record.requestHeaders) {
+        if (!IsCredentialHeader(header)) {
+            requestHeaders.push_back(header);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    WriteString(m_out, record.method);
+    WriteString(m_out, record.uri);
+    WriteString(m_out, record.requestBody);
+    WriteStrings(m_out, requestHeaders);
+    WriteInteger<std::int32_t>(m_out, record.statusCode);
+    WriteStrings(m_out, record.responseHeaders);
+    WriteString(m_out, record.responseBody);
+    WriteInteger<std::int64_t>(m_out, record.timeToFirstByte.count());
+    WriteInteger<std::int64_t>(m_out, record.totalTime.count());
+    m_out.flush();
+}
+
+CassetteReader::CassetteReader(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw llm::HTTPException("Unable to open cassette: " + path);
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < kMagicSize) {
+        ::close(fd);
+        throw llm::HTTPException("Not a cassette: " + path);
+    }
+    m_size = static_cast<std::size_t>(info.st_size);
+    m_data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (m_data == MAP_FAILED) {
+        m_data = nullptr;
+        throw llm::HTTPException("Unable to map cassette: " + path);
+    }
+
+    const char* bytes = static_cast<const char*>(m_data);
+    if (std::memcmp(bytes, kMagic, kMagicSize) != 0) {
+        ::munmap(m_data, m_size);
+        throw llm::HTTPException("Not a cassette: " + path);
+    }
+
+    // Records are flushed one at a time, so a crashed recording can end in
+    // a partial record; everything before it is still usable
+    Cursor cursor(bytes + kMagicSize, m_size - kMagicSize);
+    while (!cursor.AtEnd()) {
+        try {
+            CassetteRecord record;
+            record.method = cursor.String();
+            record.uri = cursor.String();
+            record.requestBody = cursor.String();
+            record.requestHeaders = cursor.Strings();
+            record.statusCode = cursor.Integer<std::int32_t>();
+            record.responseHeaders = cursor.Strings();
+            record.responseBody = cursor.String();
+            record.timeToFirstByte = std::chrono::microseconds(cursor.Integer<std::int64_t>());
+            record.totalTime = std::chrono::microseconds(cursor.Integer<std::int64_t>());
+            m_records.push_back(std::move(record));
+        } catch (const llm::HTTPException& e) {
+            spdlog::warn("{} after {} records in cassette {}; ignoring the rest", e.what(), m_records.size(), path);
+            break;
+        }
+    }
+}
+
+CassetteReader::~CassetteReader() {
+    if (m_data) {
+        ::munmap(m_data, m_size);
+    }
+}
+
+} // namespace http_client
@@ -0,0 +1,57 @@
+#include "http_client/chunk_stream.hpp"
+
+namespace http_client {
+
+void ChunkStreamBuffer::Append(std::string_view chunk) {
+    if (chunk.empty()) {
+        Close();
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_chunks.emplace_back(chunk);
+    }
+    m_cv.notify_one();
+}
+
+void ChunkStreamBuffer::Close() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+    }
+    m_cv.notify_one();
+}
+
+ChunkStreamBuffer::int_type ChunkStreamBuffer::underflow() {
+    if (gptr() < egptr()) {
+        return traits_type::to_int_type(*gptr());
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this]() { return !m_chunks.empty() || m_closed; });
+    if (m_chunks.empty()) {
+        return traits_type::eof();
+    }
+
+    m_current = std::move(m_chunks.front());
+    m_chunks.pop_front();
+    lock.unlock();
+
+    char* begin = m_current.data();
+    setg(begin, begin, begin + m_current.size());
+    return traits_type::to_int_type(*gptr());
+}
+
+ChunkStream::ChunkStream() : std::istream(nullptr) {
+    rdbuf(&m_buffer);
+}
+
+void ChunkStream::Append(std::string_view chunk) {
+    m_buffer.Append(chunk);
+}
+
+BodyChunkHandler ChunkStream::Handler() {
+    return [this](std::string_view chunk) { m_buffer.Append(chunk); };
+}
+
+} // namespace http_client
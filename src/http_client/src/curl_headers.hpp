@@ -0,0 +1,38 @@
+#ifndef HTTP_CLIENT_CURL_HEADERS_HPP
+#define HTTP_CLIENT_CURL_HEADERS_HPP
+
+#include <curl/curl.h>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace http_client {
+
+// CURLOPT_HEADERFUNCTION callback; userdata is a std::vector<std::string>.
+// Stores "Name: value" lines without the trailing CRLF.  A status line starts
+// a new header block (redirects, "100 Continue"), so only the headers of the
+// final response are kept.
+inline size_t CollectHeaderLine(char* buffer, size_t size, size_t nitems, void* userdata) {
+    auto* headers = static_cast<std::vector<std::string>*>(userdata);
+    size_t length = size * nitems;
+
+    std::string_view line(buffer, length);
+    while (!line.empty() && (line.back() == '\r' || line.back() == '\n')) {
+        line.remove_suffix(1);
+    }
+    try {
+        if (line.rfind("HTTP/", 0) == 0) {
+            headers->clear();
+        } else if (!line.empty()) {
+            headers->emplace_back(line);
+        }
+    } catch (std::bad_alloc&) {
+        return 0;
+    }
+    return length;
+}
+
+} // namespace http_client
+
+#endif // HTTP_CLIENT_CURL_HEADERS_HPP
@@ -1,14 +1,25 @@
 #include "http_client/curl_http_client.hpp"
 #include "exceptions/llm_exceptions.hpp"
+#include "curl_headers.hpp"
+#include "curl_target.hpp"
+#include "curl_timing.hpp"
 #include <spdlog/spdlog.h>
 #include <sstream>
 #include <thread>
 #include <iostream>
 #include <iterator>
 #include <algorithm>
+#include <optional>
 
 namespace http_client {
 
+struct CurlHTTPClient::StreamingBody {
+    CURL* curl;
+    BodyChunkHandler onChunk;
+    std::string* bufferedBody;
+    std::optional<bool> streamBody;
+};
+
 CurlHTTPClient::CurlHTTPClient() : m_timeout(30000) {
     m_curl = curl_easy_init();
     if (!m_curl) {
@@ -30,13 +41,13 @@ std::future<HTTPResponse> CurlHTTPClient::Put(const std::string& uri, const std:
     return PerformRequest("PUT", uri, body, headers);
 }
 
-std::future<HTTPResponse> CurlHTTPClient::Post(const std::string& uri, const std::string& body, const std::vector<std::string>& headers) {
+std::future<HTTPResponse> CurlHTTPClient::Post(const std::string& uri, const std::string& body, const std::vector<std::string>& headers, const RequestOptions& options) {
     spdlog::debug("CurlHTTPClient::POST");
     for (const auto& header : headers) {
         spdlog::debug(header);
     };
     spdlog::debug("Body: {}", body);
-    return PerformRequest("POST", uri, body, headers);
+    return PerformRequest("POST", uri, body, headers, nullptr, options);
 }
 
 std::future<HTTPResponse> CurlHTTPClient::Patch(const std::string& uri, const std::string& body, const std::vector<std::string>& headers) {
@@ -57,13 +68,37 @@ std::chrono::milliseconds CurlHTTPClient::GetTimeout() const {
     return m_timeout;
 }
 
-std::future<HTTPResponse> CurlHTTPClient::PerformRequest(const std::string& method, const std::string& uri, const std::string& body, const std::vector<std::string>& headers) {
-    return std::async(std::launch::async, [this, method, uri, body, headers]() {
+std::future<HTTPResponse> CurlHTTPClient::PostStreaming(const std::string& uri, const std::string& body, const std::vector<std::string>& headers, BodyChunkHandler onChunk, const RequestOptions& options) {
+    return PerformRequest("POST", uri, body, headers, std::move(onChunk), options);
+}
+
+std::future<HTTPResponse> CurlHTTPClient::PerformRequest(const std::string& method, const std::string& uri, const std::string& body, const std::vector<std::string>& headers, BodyChunkHandler onChunk, const RequestOptions& options) {
+    return std::async(std::launch::async, [this, method, uri, body, headers, onChunk, options]() {
         std::lock_guard<std::mutex> lock(m_mutex);
 
+        // It may have been cancelled while waiting for the handle
+        if (options.IsCancelled() || options.IsExpired()) {
+            if (onChunk) {
+                onChunk({});
+            }
+            options.ThrowIfDone();
+        }
+
         curl_easy_reset(m_curl);
-        curl_easy_setopt(m_curl, CURLOPT_URL, uri.c_str());
-        curl_easy_setopt(m_curl, CURLOPT_TIMEOUT_MS, static_cast<long>(m_timeout.count()));
+        try {
+            SetTarget(m_curl, uri);
+        } catch (const llm::HTTPException&) {
+            if (onChunk) {
+                onChunk({});
+            }
+            throw;
+        }
+        curl_easy_setopt(m_curl, CURLOPT_TIMEOUT_MS, static_cast<long>(options.TimeLeft(m_timeout).count()));
+        if (options.cancellation) {
+            curl_easy_setopt(m_curl, CURLOPT_NOPROGRESS, 0L);
+            curl_easy_setopt(m_curl, CURLOPT_XFERINFOFUNCTION, ProgressCallback);
+            curl_easy_setopt(m_curl, CURLOPT_XFERINFODATA, &*options.cancellation);
+        }
 
         struct curl_slist* curl_headers = nullptr;
         for (const auto& header : headers) {
@@ -71,9 +106,19 @@ std::future<HTTPResponse> CurlHTTPClient::PerformRequest(const std::string& meth
         }
         curl_easy_setopt(m_curl, CURLOPT_HTTPHEADER, curl_headers);
 
+        std::vector<std::string> response_headers;
+        curl_easy_setopt(m_curl, CURLOPT_HEADERFUNCTION, CollectHeaderLine);
+        curl_easy_setopt(m_curl, CURLOPT_HEADERDATA, &response_headers);
+
         std::string response_body;
-        curl_easy_setopt(m_curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-        curl_easy_setopt(m_curl, CURLOPT_WRITEDATA, &response_body);
+        StreamingBody streamingBody{m_curl, onChunk, &response_body, std::nullopt};
+        if (onChunk) {
+            curl_easy_setopt(m_curl, CURLOPT_WRITEFUNCTION, StreamingWriteCallback);
+            curl_easy_setopt(m_curl, CURLOPT_WRITEDATA, &streamingBody);
+        } else {
+            curl_easy_setopt(m_curl, CURLOPT_WRITEFUNCTION, WriteCallback);
+            curl_easy_setopt(m_curl, CURLOPT_WRITEDATA, &response_body);
+        }
 
         if (method != "GET") {
             curl_easy_setopt(m_curl, CURLOPT_CUSTOMREQUEST, method.c_str());
@@ -88,7 +133,14 @@ std::future<HTTPResponse> CurlHTTPClient::PerformRequest(const std::string& meth
             curl_slist_free_all(curl_headers);
         }
 
+        if (onChunk) {
+            onChunk({});
+        }
+
         if (res != CURLE_OK) {
+            if (res == CURLE_ABORTED_BY_CALLBACK || res == CURLE_OPERATION_TIMEDOUT) {
+                options.ThrowIfDone();
+            }
             throw llm::HTTPException(curl_easy_strerror(res));
         }
 
@@ -97,7 +149,9 @@ std::future<HTTPResponse> CurlHTTPClient::PerformRequest(const std::string& meth
 
         HTTPResponse response;
         response.statusCode = static_cast<int>(status_code);
+        response.headers = std::move(response_headers);
         response.body = response_body;
+        response.timing = CollectTransferTiming(m_curl);
 
         return response;
     });
@@ -113,4 +167,30 @@ size_t CurlHTTPClient::WriteCallback(void* contents, size_t size, size_t nmemb,
     return newLength;
 }
 
+int CurlHTTPClient::ProgressCallback(void* clientp, curl_off_t, curl_off_t, curl_off_t, curl_off_t) {
+    // Non-zero aborts the transfer with CURLE_ABORTED_BY_CALLBACK
+    return static_cast<const CancellationToken*>(clientp)->IsCancelled() ? 1 : 0;
+}
+
+size_t CurlHTTPClient::StreamingWriteCallback(void* contents, size_t size, size_t nmemb, StreamingBody* s) {
+    size_t newLength = size * nmemb;
+    if (!s->streamBody.has_value()) {
+        long status_code = 0;
+        curl_easy_getinfo(s->curl, CURLINFO_RESPONSE_CODE, &status_code);
+        s->streamBody = status_code >= 200 && status_code < 300;
+    }
+    if (!*s->streamBody) {
+        return WriteCallback(contents, size, nmemb, s->bufferedBody);
+    }
+    try {
+        if (newLength > 0) {
+            s->onChunk(std::string_view(static_cast<char*>(contents), newLength));
+        }
+    } catch (std::exception& e) {
+        spdlog::error("Response body handler failed: {}", e.what());
+        return 0;
+    }
+    return newLength;
+}
+
 } // namespace http_client
@@ -0,0 +1,380 @@
+#include "http_client/curl_multi_http_client.hpp"
+#include "exceptions/llm_exceptions.hpp"
+#include "curl_headers.hpp"
+#include "curl_target.hpp"
+#include "curl_timing.hpp"
+#include <spdlog/spdlog.h>
+#include <optional>
+
+namespace http_client {
+
+struct CurlMultiHTTPClient::Transfer {
+    CURL* easy = nullptr;
+    struct curl_slist* headers = nullptr;
+    std::string method;
+    std::string body;
+    std::vector<std::string> responseHeaders;
+    std::string responseBody;
+    std::promise<HTTPResponse> promise;
+
+    // Set for streaming requests; see IHTTPClient::PostStreaming
+    BodyChunkHandler onChunk;
+    std::optional<bool> streamBody;
+
+    RequestOptions options;
+    // Wakes the I/O thread when options.cancellation fires
+    std::uint64_t cancelRegistration = 0;
+
+    void Finish(HTTPResponse response) {
+        if (onChunk) {
+            onChunk({});
+        }
+        promise.set_value(std::move(response));
+    }
+
+    void Fail(const std::string& reason) {
+        if (onChunk) {
+            onChunk({});
+        }
+        promise.set_exception(std::make_exception_ptr(llm::HTTPException(reason)));
+    }
+
+    // Fails the request if it was cancelled or is past its deadline
+    bool FailIfDone() {
+        try {
+            options.ThrowIfDone();
+            return false;
+        } catch (const llm::HTTPException& e) {
+            Fail(e.what());
+            return true;
+        }
+    }
+
+    ~Transfer() {
+        if (cancelRegistration != 0) {
+            options.cancellation->Unregister(cancelRegistration);
+        }
+        if (headers) {
+            curl_slist_free_all(headers);
+        }
+        if (easy) {
+            curl_easy_cleanup(easy);
+        }
+    }
+};
+
+CurlMultiHTTPClient::CurlMultiHTTPClient(ConnectionPoolOptions options)
+    : m_options(options), m_timeout(30000), m_newConnections(0), m_reusedConnections(0), m_running(true) {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    m_multi = curl_multi_init();
+    if (!m_multi) {
+        curl_global_cleanup();
+        throw llm::HTTPException("Failed to initialize libcurl multi handle");
+    }
+
+    curl_multi_setopt(m_multi, CURLMOPT_MAX_HOST_CONNECTIONS, m_options.maxConnectionsPerHost);
+    curl_multi_setopt(m_multi, CURLMOPT_MAX_TOTAL_CONNECTIONS, m_options.maxTotalConnections);
+    curl_multi_setopt(m_multi, CURLMOPT_MAXCONNECTS, m_options.maxCachedConnections);
+    curl_multi_setopt(m_multi, CURLMOPT_PIPELINING,
+        m_options.enableHTTP2Multiplexing ? CURLPIPE_MULTIPLEX : CURLPIPE_NOTHING);
+
+    m_ioThread = std::thread(&CurlMultiHTTPClient::EventLoop, this);
+}
+
+CurlMultiHTTPClient::~CurlMultiHTTPClient() {
+    m_running = false;
+    curl_multi_wakeup(m_multi);
+    if (m_ioThread.joinable()) {
+        m_ioThread.join();
+    }
+
+    for (auto& [easy, transfer] : m_active) {
+        curl_multi_remove_handle(m_multi, easy);
+    }
+    FailAll(m_active, "HTTP client shut down before the request completed");
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        FailAll(m_pending, "HTTP client shut down before the request was sent");
+        for (CURL* easy : m_idleHandles) {
+            curl_easy_cleanup(easy);
+        }
+        m_idleHandles.clear();
+    }
+
+    curl_multi_cleanup(m_multi);
+    curl_global_cleanup();
+}
+
+std::future<HTTPResponse> CurlMultiHTTPClient::Get(const std::string& uri, const std::vector<std::string>& headers) {
+    return PerformRequest("GET", uri, "", headers);
+}
+
+std::future<HTTPResponse> CurlMultiHTTPClient::Put(const std::string& uri, const std::string& body, const std::vector<std::string>& headers) {
+    return PerformRequest("PUT", uri, body, headers);
+}
+
+std::future<HTTPResponse> CurlMultiHTTPClient::Post(const std::string& uri, const std::string& body, const std::vector<std::string>& headers, const RequestOptions& options) {
+    spdlog::debug("CurlMultiHTTPClient::POST");
+    spdlog::debug("Body: {}", body);
+    return PerformRequest("POST", uri, body, headers, nullptr, options);
+}
+
+std::future<HTTPResponse> CurlMultiHTTPClient::PostStreaming(const std::string& uri, const std::string& body, const std::vector<std::string>& headers, BodyChunkHandler onChunk, const RequestOptions& options) {
+    spdlog::debug("CurlMultiHTTPClient::POST (streaming)");
+    spdlog::debug("Body: {}", body);
+    return PerformRequest("POST", uri, body, headers, std::move(onChunk), options);
+}
+
+std::future<HTTPResponse> CurlMultiHTTPClient::Patch(const std::string& uri, const std::string& body, const std::vector<std::string>& headers) {
+    return PerformRequest("PATCH", uri, body, headers);
+}
+
+std::future<HTTPResponse> CurlMultiHTTPClient::Delete(const std::string& uri, const std::vector<std::string>& headers) {
+    return PerformRequest("DELETE", uri, "", headers);
+}
+
+void CurlMultiHTTPClient::SetTimeout(std::chrono::milliseconds timeout) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_timeout = timeout;
+}
+
+std::chrono::milliseconds CurlMultiHTTPClient::GetTimeout() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_timeout;
+}
+
+ConnectionStats CurlMultiHTTPClient::GetConnectionStats() const {
+    ConnectionStats stats;
+    stats.newConnections = m_newConnections.load();
+    stats.reusedConnections = m_reusedConnections.load();
+    return stats;
+}
+
+std::future<HTTPResponse> CurlMultiHTTPClient::PerformRequest(const std::string& method, const std::string& uri, const std::string& body, const std::vector<std::string>& headers, BodyChunkHandler onChunk, const RequestOptions& options) {
+    auto transfer = std::make_unique<Transfer>();
+    transfer->onChunk = std::move(onChunk);
+    transfer->options = options;
+    auto future = transfer->promise.get_future();
+    if (transfer->FailIfDone()) {
+        return future;
+    }
+    try {
+        ParseUnixSocketUri(uri);
+    } catch (const llm::HTTPException& e) {
+        transfer->Fail(e.what());
+        return future;
+    }
+
+    transfer->easy = AcquireHandle();
+    transfer->method = method;
+    transfer->body = body;
+
+    CURL* easy = transfer->easy;
+    SetTarget(easy, uri);
+    curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(easy, CURLOPT_TIMEOUT_MS, static_cast<long>(options.TimeLeft(GetTimeout()).count()));
+    curl_easy_setopt(easy, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(easy, CURLOPT_MAXAGE_CONN, static_cast<long>(m_options.maxIdleTime.count()));
+    if (m_options.enableHTTP2Multiplexing) {
+        curl_easy_setopt(easy, CURLOPT_HTTP_VERSION, static_cast<long>(CURL_HTTP_VERSION_2TLS));
+        // Wait for an existing connection to become multiplexable instead of
+        // opening a new one
+        curl_easy_setopt(easy, CURLOPT_PIPEWAIT, 1L);
+    }
+
+    for (const auto& header : headers) {
+        transfer->headers = curl_slist_append(transfer->headers, header.c_str());
+    }
+    curl_easy_setopt(easy, CURLOPT_HTTPHEADER, transfer->headers);
+
+    curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, WriteCallback);
+    curl_easy_setopt(easy, CURLOPT_WRITEDATA, transfer.get());
+    curl_easy_setopt(easy, CURLOPT_HEADERFUNCTION, CollectHeaderLine);
+    curl_easy_setopt(easy, CURLOPT_HEADERDATA, &transfer->responseHeaders);
+
+    if (method != "GET") {
+        curl_easy_setopt(easy, CURLOPT_CUSTOMREQUEST, transfer->method.c_str());
+        if (!transfer->body.empty()) {
+            curl_easy_setopt(easy, CURLOPT_POSTFIELDSIZE, static_cast<long>(transfer->body.size()));
+            curl_easy_setopt(easy, CURLOPT_POSTFIELDS, transfer->body.c_str());
+        }
+    }
+
+    if (options.cancellation) {
+        transfer->cancelRegistration = options.cancellation->OnCancel([multi = m_multi]() {
+            curl_multi_wakeup(multi);
+        });
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending.emplace(easy, std::move(transfer));
+    }
+    curl_multi_wakeup(m_multi);
+    return future;
+}
+
+void CurlMultiHTTPClient::EventLoop() {
+    while (m_running) {
+        AddPendingTransfers();
+
+        int stillRunning = 0;
+        CURLMcode mc = curl_multi_perform(m_multi, &stillRunning);
+        if (mc != CURLM_OK) {
+            spdlog::error("curl_multi_perform failed: {}", curl_multi_strerror(mc));
+        }
+
+        ReapCompletedTransfers();
+        AbortCancelledTransfers();
+
+        mc = curl_multi_poll(m_multi, nullptr, 0, 1000, nullptr);
+        if (mc != CURLM_OK) {
+            spdlog::error("curl_multi_poll failed: {}", curl_multi_strerror(mc));
+        }
+    }
+}
+
+void CurlMultiHTTPClient::AddPendingTransfers() {
+    std::unordered_map<CURL*, std::unique_ptr<Transfer>> pending;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        pending.swap(m_pending);
+    }
+
+    for (auto& [easy, transfer] : pending) {
+        CURLMcode mc = curl_multi_add_handle(m_multi, easy);
+        if (mc != CURLM_OK) {
+            transfer->Fail(curl_multi_strerror(mc));
+            continue;
+        }
+        m_active.emplace(easy, std::move(transfer));
+    }
+}
+
+void CurlMultiHTTPClient::ReapCompletedTransfers() {
+    int messagesLeft = 0;
+    while (CURLMsg* msg = curl_multi_info_read(m_multi, &messagesLeft)) {
+        if (msg->msg != CURLMSG_DONE) {
+            continue;
+        }
+
+        CURL* easy = msg->easy_handle;
+        CURLcode result = msg->data.result;
+        curl_multi_remove_handle(m_multi, easy);
+
+        auto it = m_active.find(easy);
+        if (it == m_active.end()) {
+            continue;
+        }
+        std::unique_ptr<Transfer> transfer = std::move(it->second);
+        m_active.erase(it);
+
+        if (result != CURLE_OK) {
+            if (result != CURLE_OPERATION_TIMEDOUT || !transfer->FailIfDone()) {
+                transfer->Fail(curl_easy_strerror(result));
+            }
+            continue;
+        }
+
+        long connects = 0;
+        curl_easy_getinfo(easy, CURLINFO_NUM_CONNECTS, &connects);
+        if (connects == 0) {
+            ++m_reusedConnections;
+        } else {
+            m_newConnections += static_cast<std::uint64_t>(connects);
+        }
+
+        long status_code;
+        curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &status_code);
+
+        HTTPResponse response;
+        response.statusCode = static_cast<int>(status_code);
+        response.headers = std::move(transfer->responseHeaders);
+        response.body = std::move(transfer->responseBody);
+        response.timing = CollectTransferTiming(easy);
+        transfer->Finish(std::move(response));
+
+        ReleaseHandle(transfer->easy);
+        transfer->easy = nullptr;
+    }
+}
+
+void CurlMultiHTTPClient::AbortCancelledTransfers() {
+    for (auto it = m_active.begin(); it != m_active.end();) {
+        if (!it->second->options.IsCancelled()) {
+            ++it;
+            continue;
+        }
+        // Removing a handle mid-transfer closes its connection
+        curl_multi_remove_handle(m_multi, it->first);
+        std::unique_ptr<Transfer> transfer = std::move(it->second);
+        it = m_active.erase(it);
+
+        transfer->FailIfDone();
+        ReleaseHandle(transfer->easy);
+        transfer->easy = nullptr;
+    }
+}
+
+CURL* CurlMultiHTTPClient::AcquireHandle() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_idleHandles.empty()) {
+            CURL* easy = m_idleHandles.back();
+            m_idleHandles.pop_back();
+            return easy;
+        }
+    }
+
+    CURL* easy = curl_easy_init();
+    if (!easy) {
+        throw llm::HTTPException("Failed to initialize libcurl");
+    }
+    return easy;
+}
+
+void CurlMultiHTTPClient::ReleaseHandle(CURL* easy) {
+    curl_easy_reset(easy);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_idleHandles.size() < m_options.maxPooledHandles) {
+            m_idleHandles.push_back(easy);
+            return;
+        }
+    }
+    curl_easy_cleanup(easy);
+}
+
+void CurlMultiHTTPClient::FailAll(std::unordered_map<CURL*, std::unique_ptr<Transfer>>& transfers, const std::string& reason) {
+    for (auto& [easy, transfer] : transfers) {
+        transfer->Fail(reason);
+    }
+    transfers.clear();
+}
+
+size_t CurlMultiHTTPClient::WriteCallback(void* contents, size_t size, size_t nmemb, void* userdata) {
+    auto* transfer = static_cast<Transfer*>(userdata);
+    size_t newLength = size * nmemb;
+
+    if (transfer->onChunk && !transfer->streamBody.has_value()) {
+        long status_code = 0;
+        curl_easy_getinfo(transfer->easy, CURLINFO_RESPONSE_CODE, &status_code);
+        transfer->streamBody = status_code >= 200 && status_code < 300;
+    }
+
+    try {
+        if (transfer->streamBody.value_or(false)) {
+            if (newLength > 0) {
+                transfer->onChunk(std::string_view(static_cast<char*>(contents), newLength));
+            }
+        } else {
+            transfer->responseBody.append((char*)contents, newLength);
+        }
+    } catch (std::exception& e) {
+        spdlog::error("Response body handler failed: {}", e.what());
+        return 0;
+    }
+    return newLength;
+}
+
+} // namespace http_client
@@ -0,0 +1,27 @@
+#ifndef HTTP_CLIENT_CURL_TARGET_HPP
+#define HTTP_CLIENT_CURL_TARGET_HPP
+
+#include "http_client/unix_socket_uri.hpp"
+#include <curl/curl.h>
+#include <string>
+
+namespace http_client {
+
+// Points an easy handle at uri.  "unix:<path>:<url>" connects to a local
+// Unix domain socket, skipping name resolution and the TCP stack; curl only
+// reuses such a connection for the same socket path.  TCP connections set
+// TCP_NODELAY so small request bodies are not held back by Nagle's
+// algorithm, which matters most on loopback where the round trip is short.
+inline void SetTarget(CURL* easy, const std::string& uri) {
+    if (auto socket = ParseUnixSocketUri(uri)) {
+        curl_easy_setopt(easy, CURLOPT_UNIX_SOCKET_PATH, socket->socketPath.c_str());
+        curl_easy_setopt(easy, CURLOPT_URL, socket->url.c_str());
+    } else {
+        curl_easy_setopt(easy, CURLOPT_URL, uri.c_str());
+        curl_easy_setopt(easy, CURLOPT_TCP_NODELAY, 1L);
+    }
+}
+
+} // namespace http_client
+
+#endif // HTTP_CLIENT_CURL_TARGET_HPP
@@ -0,0 +1,39 @@
+#ifndef HTTP_CLIENT_CURL_TIMING_HPP
+#define HTTP_CLIENT_CURL_TIMING_HPP
+
+#include "http_client/http_response.hpp"
+#include <curl/curl.h>
+
+namespace http_client {
+
+// Reads the timing breakdown of a finished transfer from its easy handle
+inline TransferTiming CollectTransferTiming(CURL* easy) {
+    auto microseconds = [easy](CURLINFO info) {
+        curl_off_t value = 0;
+        curl_easy_getinfo(easy, info, &value);
+        return std::chrono::microseconds(value);
+    };
+
+    TransferTiming timing;
+    timing.nameLookup = microseconds(CURLINFO_NAMELOOKUP_TIME_T);
+    timing.connect = microseconds(CURLINFO_CONNECT_TIME_T);
+    timing.tlsHandshake = microseconds(CURLINFO_APPCONNECT_TIME_T);
+    timing.timeToFirstByte = microseconds(CURLINFO_STARTTRANSFER_TIME_T);
+    timing.total = microseconds(CURLINFO_TOTAL_TIME_T);
+
+    curl_off_t uploaded = 0;
+    curl_off_t downloaded = 0;
+    curl_easy_getinfo(easy, CURLINFO_SIZE_UPLOAD_T, &uploaded);
+    curl_easy_getinfo(easy, CURLINFO_SIZE_DOWNLOAD_T, &downloaded);
+    timing.bytesUploaded = static_cast<std::uint64_t>(uploaded);
+    timing.bytesDownloaded = static_cast<std::uint64_t>(downloaded);
+
+    long connects = 0;
+    curl_easy_getinfo(easy, CURLINFO_NUM_CONNECTS, &connects);
+    timing.connectionReused = connects == 0;
+    return timing;
+}
+
+} // namespace http_client
+
+#endif // HTTP_CLIENT_CURL_TIMING_HPP
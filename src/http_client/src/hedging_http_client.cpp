@@ -0,0 +1,268 @@
+#include "http_client/hedging_http_client.hpp"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace http_client {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// The two requests of a hedged pair report here; the first 2xx answer wins
+struct Race {
+    std::mutex mutex;
+    std::condition_variable done;
+    std::optional<HTTPResponse> response;
+    // Kept in case neither request answers with a 2xx
+    std::optional<HTTPResponse> rejected;
+    std::exception_ptr error;
+    int outstanding = 2;
+    bool finished = false;
+    bool hedgeWon = false;
+};
+
+bool IsSuccess(const HTTPResponse& response) {
+    return response.statusCode >= 200 && response.statusCode < 300;
+}
+
+// Gives one attempt its own token, so it can be cancelled alone, that still
+// fires when the caller's token does
+class LinkedCancellation {
+public:
+    explicit LinkedCancellation(const RequestOptions& parent) : m_parent(parent.cancellation), m_options(parent) {
+        m_options.cancellation = CancellationToken();
+        if (m_parent) {
+            m_registration = m_parent->OnCancel([token = *m_options.cancellation]() { token.Cancel(); });
+        }
+    }
+
+    ~LinkedCancellation() {
+        if (m_registration != 0) {
+            m_parent->Unregister(m_registration);
+        }
+    }
+
+    LinkedCancellation(const LinkedCancellation&) = delete;
+    LinkedCancellation& operator=(const LinkedCancellation&) = delete;
+
+    const RequestOptions& Options() const { return m_options; }
+    void Cancel() const { m_options.cancellation->Cancel(); }
+
+private:
+    std::optional<CancellationToken> m_parent;
+    RequestOptions m_options;
+    std::uint64_t m_registration = 0;
+};
+
+// Prefer the transport's own transfer time, which leaves out the wait for
+// a watcher thread to be scheduled
+Clock::duration Latency(const HTTPResponse& response, Clock::duration measured) {
+    if (response.timing.total.count() > 0) {
+        return response.timing.total;
+    }
+    return measured;
+}
+
+} // namespace
+
+struct HedgingHTTPClient::Tracker {
+    HedgingOptions options;
+    mutable std::mutex mutex;
+    // Ring buffer of recent latencies
+    std::vector<Clock::duration> latencies;
+    std::size_t next = 0;
+    HedgingStats stats;
+
+    explicit Tracker(HedgingOptions trackerOptions) : options(trackerOptions) {}
+
+    void Record(Clock::duration latency) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (latencies.size() < options.window) {
+            latencies.push_back(latency);
+        } else if (!latencies.empty()) {
+            latencies[next] = latency;
+            next = (next + 1) % latencies.size();
+        }
+    }
+
+    std::optional<Clock::duration> Delay() {
+        std::lock_guard<std::mutex> lock(mutex);
+        Clock::duration delay;
+        if (latencies.size() < std::max<std::size_t>(options.minSamples, 1)) {
+            if (options.initialDelay.count() <= 0) {
+                return std::nullopt;
+            }
+            delay = options.initialDelay;
+        } else {
+            auto sorted = latencies;
+            auto rank = std::min(sorted.size() - 1, static_cast<std::size_t>(options.percentile * sorted.size()));
+            std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+            delay = std::max<Clock::duration>(sorted[rank], options.minDelay);
+        }
+        stats.currentDelay = std::chrono::duration_cast<std::chrono::milliseconds>(delay);
+        return delay;
+    }
+
+    bool TakeHedge() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (static_cast<double>(stats.hedgesSent) >= 1 + options.maxHedgeFraction * static_cast<double>(stats.eligible)) {
+            return false;
+        }
+        ++stats.hedgesSent;
+        return true;
+    }
+};
+
+HedgingHTTPClient::HedgingHTTPClient(std::shared_ptr<IHTTPClient> inner, HedgingOptions options)
+    : m_inner(std::move(inner)), m_tracker(std::make_shared<Tracker>(options)) {}
+
+std::future<HTTPResponse> HedgingHTTPClient::Get(const std::string& uri, const std::vector<std::string>& headers) {
+    return m_inner->Get(uri, headers);
+}
+
+std::future<HTTPResponse> HedgingHTTPClient::Put(const std::string& uri, const std::string& body, const std::vector<std::string>& headers) {
+    return m_inner->Put(uri, body, headers);
+}
+
+std::future<HTTPResponse> HedgingHTTPClient::Post(const std::string& uri, const std::string& body, const std::vector<std::string>& headers, const RequestOptions& options) {
+    if (!options.idempotent) {
+        return m_inner->Post(uri, body, headers, options);
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_tracker->mutex);
+        ++m_tracker->stats.eligible;
+    }
+
+    auto start = Clock::now();
+    auto primaryCancellation = std::make_unique<LinkedCancellation>(options);
+    auto primary = m_inner->Post(uri, body, headers, primaryCancellation->Options());
+    auto hedged =
+        [tracker = m_tracker, inner = m_inner, uri, body, headers, options, start,
+         primaryCancellation = std::move(primaryCancellation), primary = std::move(primary)]() mutable {
+            // Deferred inner futures cannot be timed, so they are never hedged
+            auto delay = tracker->Delay();
+            if (!delay || primary.wait_until(start + *delay) != std::future_status::timeout ||
+                !tracker->TakeHedge()) {
+                HTTPResponse response = primary.get();
+                if (IsSuccess(response)) {
+                    tracker->Record(Latency(response, Clock::now() - start));
+                }
+                return response;
+            }
+
+            spdlog::debug("Hedging request to {} after {} ms", uri,
+                          std::chrono::duration_cast<std::chrono::milliseconds>(*delay).count());
+            auto hedgeStart = Clock::now();
+            LinkedCancellation hedgeCancellation(options);
+            auto hedge = inner->Post(uri, body, headers, hedgeCancellation.Options());
+
+            // One watcher per request; the loser's finishes on its own
+            auto race = std::make_shared<Race>();
+            auto watch = [&tracker, &race](std::future<HTTPResponse> future, Clock::time_point sent, bool isHedge) {
+                std::thread([tracker, race, future = std::move(future), sent, isHedge]() mutable {
+                    std::optional<HTTPResponse> response;
+                    std::exception_ptr error;
+                    try {
+                        response = future.get();
+                        // Error latencies (a fast 429, say) would drag the percentile down
+                        if (IsSuccess(*response)) {
+                            tracker->Record(Latency(*response, Clock::now() - sent));
+                        }
+                    } catch (...) {
+                        error = std::current_exception();
+                    }
+                    {
+                        std::lock_guard<std::mutex> lock(race->mutex);
+                        --race->outstanding;
+                        if (!race->finished) {
+                            if (response && IsSuccess(*response)) {
+                                race->response = std::move(response);
+                                race->hedgeWon = isHedge;
+                                race->finished = true;
+                            } else {
+                                // Like a transport error, a non-2xx answer only counts
+                                // once the other request has failed too
+                                if (response && !race->rejected) {
+                                    race->rejected = std::move(response);
+                                } else if (error && !race->error) {
+                                    race->error = error;
+                                }
+                                race->finished = race->outstanding == 0;
+                            }
+                        }
+                    }
+                    race->done.notify_all();
+                }).detach();
+            };
+            watch(std::move(primary), start, false);
+            watch(std::move(hedge), hedgeStart, true);
+
+            std::unique_lock<std::mutex> lock(race->mutex);
+            race->done.wait(lock, [&race]() { return race->finished; });
+            if (!race->response) {
+                // Neither answered with a 2xx; an HTTP answer beats a transport error
+                if (race->rejected) {
+                    return std::move(*race->rejected);
+                }
+                std::rethrow_exception(race->error);
+            }
+            HTTPResponse response = std::move(*race->response);
+            bool hedgeWon = race->hedgeWon;
+            lock.unlock();
+
+            // Abort the loser so it stops holding a connection
+            if (hedgeWon) {
+                primaryCancellation->Cancel();
+                std::lock_guard<std::mutex> statsLock(tracker->mutex);
+                ++tracker->stats.hedgesWon;
+            } else {
+                hedgeCancellation.Cancel();
+            }
+            return response;
+        };
+
+    // The hedge timer runs on its own thread, so the hedge goes out on time
+    // whether or not the caller is reading the future yet
+    std::promise<HTTPResponse> promise;
+    auto result = promise.get_future();
+    std::thread([hedged = std::move(hedged), promise = std::move(promise)]() mutable {
+        try {
+            promise.set_value(hedged());
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+        }
+    }).detach();
+    return result;
+}
+
+std::future<HTTPResponse> HedgingHTTPClient::Patch(const std::string& uri, const std::string& body, const std::vector<std::string>& headers) {
+    return m_inner->Patch(uri, body, headers);
+}
+
+std::future<HTTPResponse> HedgingHTTPClient::Delete(const std::string& uri, const std::vector<std::string>& headers) {
+    return m_inner->Delete(uri, headers);
+}
+
+void HedgingHTTPClient::SetTimeout(std::chrono::milliseconds timeout) {
+    m_inner->SetTimeout(timeout);
+}
+
+std::chrono::milliseconds HedgingHTTPClient::GetTimeout() const {
+    return m_inner->GetTimeout();
+}
+
+std::future<HTTPResponse> HedgingHTTPClient::PostStreaming(const std::string& uri, const std::string& body, const std::vector<std::string>& headers, BodyChunkHandler onChunk, const RequestOptions& options) {
+    return m_inner->PostStreaming(uri, body, headers, std::move(onChunk), options);
+}
+
+HedgingStats HedgingHTTPClient::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_tracker->mutex);
+    return m_tracker->stats;
+}
+
+} // namespace http_client
@@ -0,0 +1,386 @@
+#include "http_client/rate_limited_http_client.hpp"
+#include "http_client/unix_socket_uri.hpp"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <mutex>
+#include <random>
+#include <unordered_map>
+
+namespace http_client {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+bool IsRetryable(int statusCode) {
+    return statusCode == 429 || statusCode == 500 || statusCode == 502 ||
+           statusCode == 503 || statusCode == 504;
+}
+
+std::optional<double> ParseNumber(std::string_view text) {
+    std::string value(text);
+    char* end = nullptr;
+    double number = std::strtod(value.c_str(), &end);
+    if (value.empty() || end != value.c_str() + value.size() || number < 0) {
+        return std::nullopt;
+    }
+    return number;
+}
+
+/**
+ * Token bucket holding up to one minute's worth of a limit and refilling
+ * continuously.  A capacity of zero means unlimited.
+ */
+struct Bucket {
+    double capacity = 0;
+    double available = 0;
+    Clock::time_point updated = Clock::now();
+
+    void Refill(Clock::time_point now) {
+        if (capacity > 0) {
+            double elapsed = std::chrono::duration<double>(now - updated).count();
+            available = std::min(capacity, available + elapsed * capacity / 60.0);
+        }
+        updated = now;
+    }
+
+    void SetCapacity(double perMinute) {
+        if (perMinute <= 0 || perMinute == capacity) {
+            return;
+        }
+        available = capacity == 0 ? perMinute : std::min(available, perMinute);
+        capacity = perMinute;
+    }
+
+    // How long until amount is available; requests larger than the whole
+    // bucket go through once it is full
+    Clock::duration Shortfall(double amount) const {
+        if (capacity <= 0) {
+            return Clock::duration::zero();
+        }
+        amount = std::min(amount, capacity);
+        if (available >= amount) {
+            return Clock::duration::zero();
+        }
+        return std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>((amount - available) * 60.0 / capacity));
+    }
+
+    void Take(double amount) {
+        if (capacity > 0) {
+            available -= amount;
+        }
+    }
+};
+
+struct Endpoint {
+    Bucket requests;
+    Bucket tokens;
+    Clock::time_point pausedUntil;
+};
+
+std::optional<std::chrono::milliseconds> RetryAfter(const HTTPResponse& response) {
+    if (auto milliseconds = FindHeader(response.headers, "retry-after-ms")) {
+        if (auto value = ParseNumber(*milliseconds)) {
+            return std::chrono::milliseconds(static_cast<long long>(*value));
+        }
+    }
+    // HTTP-date values are not supported and fall back to plain backoff
+    if (auto seconds = FindHeader(response.headers, "retry-after")) {
+        return RateLimitedHTTPClient::ParseDuration(*seconds);
+    }
+    return std::nullopt;
+}
+
+} // namespace
+
+struct RateLimitedHTTPClient::Limiter {
+    RateLimitOptions options;
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, Endpoint> endpoints;
+    std::mt19937_64 random{std::random_device{}()};
+    RateLimitStats stats;
+
+    explicit Limiter(RateLimitOptions limiterOptions) : options(limiterOptions) {}
+
+    // Caller holds mutex
+    Endpoint& EndpointNamed(const std::string& name) {
+        auto [it, inserted] = endpoints.try_emplace(name);
+        if (inserted) {
+            it->second.requests.SetCapacity(options.requestsPerMinute);
+            it->second.tokens.SetCapacity(options.tokensPerMinute);
+        }
+        return it->second;
+    }
+
+    // Takes capacity for one request if there is enough; otherwise returns
+    // how long to wait before asking again
+    Clock::duration TryAcquire(const std::string& name, double tokens) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto now = Clock::now();
+        Endpoint& endpoint = EndpointNamed(name);
+        endpoint.requests.Refill(now);
+        endpoint.tokens.Refill(now);
+
+        auto wait = std::max({endpoint.pausedUntil - now,
+                              endpoint.requests.Shortfall(1),
+                              endpoint.tokens.Shortfall(tokens)});
+        if (wait > Clock::duration::zero()) {
+            return wait;
+        }
+        endpoint.requests.Take(1);
+        endpoint.tokens.Take(tokens);
+        return Clock::duration::zero();
+    }
+
+    void Acquire(const std::string& name, double tokens, const RequestOptions& requestOptions) {
+        bool throttled = false;
+        for (auto wait = TryAcquire(name, tokens); wait > Clock::duration::zero(); wait = TryAcquire(name, tokens)) {
+            if (!throttled) {
+                throttled = true;
+                std::lock_guard<std::mutex> lock(mutex);
+                ++stats.throttled;
+            }
+            requestOptions.SleepUntil(Clock::now() + wait);
+        }
+    }
+
+    // Brings the endpoint's buckets in line with what the server reports
+    void Observe(const std::string& name, const HTTPResponse& response) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto now = Clock::now();
+        Endpoint& endpoint = EndpointNamed(name);
+
+        auto adapt = [&](Bucket& bucket, const std::string& kind) {
+            if (auto limit = FindHeader(response.headers, "x-ratelimit-limit-" + kind)) {
+                if (auto value = ParseNumber(*limit)) {
+                    bucket.SetCapacity(*value);
+                }
+            }
+            auto remaining = FindHeader(response.headers, "x-ratelimit-remaining-" + kind);
+            auto value = remaining ? ParseNumber(*remaining) : std::nullopt;
+            if (!value) {
+                return;
+            }
+            bucket.Refill(now);
+            bucket.available = std::min(bucket.available, *value);
+            if (*value < 1) {
+                auto reset = FindHeader(response.headers, "x-ratelimit-reset-" + kind);
+                if (auto delay = reset ? ParseDuration(*reset) : std::nullopt) {
+                    endpoint.pausedUntil = std::max(endpoint.pausedUntil, now + *delay);
+                }
+            }
+        };
+        adapt(endpoint.requests, "requests");
+        adapt(endpoint.tokens, "tokens");
+
+        if (response.statusCode == 429) {
+            if (auto delay = RetryAfter(response)) {
+                endpoint.pausedUntil = std::max(endpoint.pausedUntil, now + *delay);
+            }
+        }
+    }
+
+    // Full jitter over an exponentially growing window, but never sooner
+    // than the server asked for
+    std::chrono::milliseconds Backoff(int retry, const HTTPResponse& response) {
+        auto window = options.baseBackoff * (1LL << std::min(retry, 20));
+        window = std::min<std::chrono::milliseconds>(window, options.maxBackoff);
+
+        std::chrono::milliseconds delay;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::uniform_int_distribution<long long> jitter(0, window.count());
+            delay = std::chrono::milliseconds(jitter(random));
+            ++stats.retries;
+        }
+        if (auto retryAfter = RetryAfter(response)) {
+            delay = std::max(delay, *retryAfter);
+        }
+        return delay;
+    }
+
+    HTTPResponse Complete(const std::string& name, double tokens, const Attempt& attempt,
+                          std::optional<std::future<HTTPResponse>> pending, const RequestOptions& requestOptions) {
+        for (int retry = 0;; ++retry) {
+            if (!pending) {
+                Acquire(name, tokens, requestOptions);
+                pending = attempt();
+            }
+            HTTPResponse response = pending->get();
+            pending.reset();
+
+            Observe(name, response);
+            if (!IsRetryable(response.statusCode) || retry >= options.maxRetries) {
+                return response;
+            }
+            auto delay = Backoff(retry, response);
+            spdlog::warn("HTTP {} from {}, retrying in {} ms", response.statusCode, name, delay.count());
+            requestOptions.SleepUntil(Clock::now() + delay);
+        }
+    }
+};
+
+RateLimitedHTTPClient::RateLimitedHTTPClient(std::shared_ptr<IHTTPClient> inner, RateLimitOptions options)
+    : m_inner(std::move(inner)), m_limiter(std::make_shared<Limiter>(options)) {}
+
+std::string RateLimitedHTTPClient::EndpointFor(const std::string& uri) {
+    try {
+        if (auto socket = ParseUnixSocketUri(uri)) {
+            return "unix:" + socket->socketPath;
+        }
+    } catch (const llm::HTTPException&) {
+        // The transport rejects it; it is its own endpoint until then
+        return uri;
+    }
+    auto scheme = uri.find("://");
+    auto authority = scheme == std::string::npos ? 0 : scheme + 3;
+    return uri.substr(0, uri.find('/', authority));
+}
+
+double RateLimitedHTTPClient::EstimateTokens(const std::string& body) {
+    double tokens = static_cast<double>(body.size()) / 4.0;
+
+    static constexpr std::string_view kMaxTokens = "\"max_tokens\"";
+    auto pos = body.find(kMaxTokens);
+    if (pos != std::string::npos) {
+        pos = body.find_first_not_of(" \t\r\n:", pos + kMaxTokens.size());
+        if (pos != std::string::npos) {
+            tokens += std::strtod(body.c_str() + pos, nullptr);
+        }
+    }
+    return tokens;
+}
+
+std::optional<std::chrono::milliseconds> RateLimitedHTTPClient::ParseDuration(std::string_view text) {
+    while (!text.empty() && text.front() == ' ') {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && text.back() == ' ') {
+        text.remove_suffix(1);
+    }
+    if (text.empty()) {
+        return std::nullopt;
+    }
+
+    std::string value(text);
+    const char* cursor = value.c_str();
+    const char* end = cursor + value.size();
+    double total = 0;
+    while (cursor < end) {
+        if (!std::isdigit(static_cast<unsigned char>(*cursor)) && *cursor != '.') {
+            return std::nullopt;
+        }
+        char* next = nullptr;
+        double number = std::strtod(cursor, &next);
+        if (next == cursor) {
+            return std::nullopt;
+        }
+        cursor = next;
+
+        double scale;
+        if (cursor == end) {
+            scale = 1000;
+        } else if (end - cursor >= 2 && cursor[0] == 'm' && cursor[1] == 's') {
+            scale = 1;
+            cursor += 2;
+        } else if (*cursor == 's') {
+            scale = 1000;
+            ++cursor;
+        } else if (*cursor == 'm') {
+            scale = 60 * 1000;
+            ++cursor;
+        } else if (*cursor == 'h') {
+            scale = 60 * 60 * 1000;
+            ++cursor;
+        } else {
+            return std::nullopt;
+        }
+        total += number * scale;
+    }
+    return std::chrono::milliseconds(static_cast<long long>(total));
+}
+
+RateLimitStats RateLimitedHTTPClient::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_limiter->mutex);
+    return m_limiter->stats;
+}
+
+std::future<HTTPResponse> RateLimitedHTTPClient::Send(const std::string& uri, double tokens, Attempt attempt, const RequestOptions& options) {
+    std::string endpoint = EndpointFor(uri);
+    {
+        std::lock_guard<std::mutex> lock(m_limiter->mutex);
+        ++m_limiter->stats.requests;
+    }
+
+    // Dispatch now when there is capacity.  Otherwise a worker waits for
+    // it, so the request goes out on time whether or not the caller is
+    // reading the future, and waiting on it with a timeout works.
+    std::optional<std::future<HTTPResponse>> pending;
+    if (m_limiter->TryAcquire(endpoint, tokens) == Clock::duration::zero()) {
+        pending = attempt();
+    }
+    return std::async(std::launch::async,
+        [limiter = m_limiter, endpoint = std::move(endpoint), tokens, attempt = std::move(attempt),
+         pending = std::move(pending), options]() mutable {
+            return limiter->Complete(endpoint, tokens, attempt, std::move(pending), options);
+        });
+}
+
+std::future<HTTPResponse> RateLimitedHTTPClient::Get(const std::string& uri, const std::vector<std::string>& headers) {
+    return Send(uri, 0, [inner = m_inner, uri, headers]() { return inner->Get(uri, headers); });
+}
+
+std::future<HTTPResponse> RateLimitedHTTPClient::Put(const std::string& uri, const std::string& body, const std::vector<std::string>& headers) {
+    return Send(uri, EstimateTokens(body), [inner = m_inner, uri, body, headers]() { return inner->Put(uri, body, headers); });
+}
+
+std::future<HTTPResponse> RateLimitedHTTPClient::Post(const std::string& uri, const std::string& body, const std::vector<std::string>& headers, const RequestOptions& options) {
+    return Send(uri, EstimateTokens(body), [inner = m_inner, uri, body, headers, options]() {
+        return inner->Post(uri, body, headers, options);
+    }, options);
+}
+
+std::future<HTTPResponse> RateLimitedHTTPClient::Patch(const std::string& uri, const std::string& body, const std::vector<std::string>& headers) {
+    return Send(uri, EstimateTokens(body), [inner = m_inner, uri, body, headers]() { return inner->Patch(uri, body, headers); });
+}
+
+std::future<HTTPResponse> RateLimitedHTTPClient::Delete(const std::string& uri, const std::vector<std::string>& headers) {
+    return Send(uri, 0, [inner = m_inner, uri, headers]() { return inner->Delete(uri, headers); });
+}
+
+void RateLimitedHTTPClient::SetTimeout(std::chrono::milliseconds timeout) {
+    m_inner->SetTimeout(timeout);
+}
+
+std::chrono::milliseconds RateLimitedHTTPClient::GetTimeout() const {
+    return m_inner->GetTimeout();
+}
+
+std::future<HTTPResponse> RateLimitedHTTPClient::PostStreaming(const std::string& uri, const std::string& body, const std::vector<std::string>& headers, BodyChunkHandler onChunk, const RequestOptions& options) {
+    // Every attempt ends with its own empty chunk; only the last one is passed on
+    auto handler = std::make_shared<BodyChunkHandler>(std::move(onChunk));
+    auto pending = Send(uri, EstimateTokens(body), [inner = m_inner, uri, body, headers, handler, options]() {
+        return inner->PostStreaming(uri, body, headers, [handler](std::string_view chunk) {
+            if (!chunk.empty()) {
+                (*handler)(chunk);
+            }
+        }, options);
+    }, options);
+
+    // Send one end marker once the last attempt has finished
+    return std::async(std::launch::async, [pending = std::move(pending), handler]() mutable {
+        try {
+            HTTPResponse response = pending.get();
+            (*handler)({});
+            return response;
+        } catch (...) {
+            (*handler)({});
+            throw;
+        }
+    });
+}
+
+} // namespace http_client
@@ -0,0 +1,111 @@
+#include "http_client/recording_http_client.hpp"
+#include "when_ready.hpp"
+
+namespace http_client {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::chrono::microseconds Since(Clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+}
+
+CassetteRecord MakeRecord(const std::string& method, const std::string& uri, const std::string& body,
+                          const std::vector<std::string>& headers, const HTTPResponse& response,
+                          std::string_view responseBody) {
+    CassetteRecord record;
+    record.method = method;
+    record.uri = uri;
+    record.requestBody = body;
+    record.requestHeaders.assign(headers.begin(), headers.end());
+    record.statusCode = response.statusCode;
+    record.responseHeaders.assign(response.headers.begin(), response.headers.end());
+    record.responseBody = responseBody;
+    return record;
+}
+
+} // namespace
+
+RecordingHTTPClient::RecordingHTTPClient(std::shared_ptr<IHTTPClient> inner, const std::string& cassettePath)
+    : m_inner(std::move(inner)), m_writer(std::make_shared<CassetteWriter>(cassettePath)) {}
+
+std::future<HTTPResponse> RecordingHTTPClient::Record(const std::string& method, const std::string& uri,
+                                                      const std::string& body, const std::vector<std::string>& headers,
+                                                      const std::function<std::future<HTTPResponse>()>& dispatch) {
+    // Buffered responses have no separate first byte; both times are the
+    // time until the caller could see the response
+    auto start = Clock::now();
+    return WhenReady(dispatch(),
+        [writer = m_writer, method, uri, body, headers, start](HTTPResponse response) {
+            auto elapsed = Since(start);
+            CassetteRecord record = MakeRecord(method, uri, body, headers, response, response.body);
+            record.timeToFirstByte = elapsed;
+            record.totalTime = elapsed;
+            writer->Write(record);
+            return response;
+        });
+}
+
+std::future<HTTPResponse> RecordingHTTPClient::Get(const std::string& uri, const std::vector<std::string>& headers) {
+    return Record("GET", uri, {}, headers, [&]() { return m_inner->Get(uri, headers); });
+}
+
+std::future<HTTPResponse> RecordingHTTPClient::Put(const std::string& uri, const std::string& body, const std::vector<std::string>& headers) {
+    return Record("PUT", uri, body, headers, [&]() { return m_inner->Put(uri, body, headers); });
+}
+
+std::future<HTTPResponse> RecordingHTTPClient::Post(const std::string& uri, const std::string& body, const std::vector<std::string>& headers, const RequestOptions& options) {
+    return Record("POST", uri, body, headers, [&]() { return m_inner->Post(uri, body, headers, options); });
+}
+
+std::future<HTTPResponse> RecordingHTTPClient::Patch(const std::string& uri, const std::string& body, const std::vector<std::string>& headers) {
+    return Record("PATCH", uri, body, headers, [&]() { return m_inner->Patch(uri, body, headers); });
+}
+
+std::future<HTTPResponse> RecordingHTTPClient::Delete(const std::string& uri, const std::vector<std::string>& headers) {
+    return Record("DELETE", uri, {}, headers, [&]() { return m_inner->Delete(uri, headers); });
+}
+
+void RecordingHTTPClient::SetTimeout(std::chrono::milliseconds timeout) {
+    m_inner->SetTimeout(timeout);
+}
+
+std::chrono::milliseconds RecordingHTTPClient::GetTimeout() const {
+    return m_inner->GetTimeout();
+}
+
+std::future<HTTPResponse> RecordingHTTPClient::PostStreaming(const std::string& uri, const std::string& body, const std::vector<std::string>& headers, BodyChunkHandler onChunk, const RequestOptions& options) {
+    // The chunk handler runs on the transport's thread; the capture is only
+    // read after the future is ready, which happens after the final chunk
+    struct Capture {
+        std::string body;
+        std::chrono::microseconds timeToFirstByte{-1};
+    };
+    auto capture = std::make_shared<Capture>();
+    auto start = Clock::now();
+
+    auto pending = m_inner->PostStreaming(uri, body, headers,
+        [capture, start, onChunk = std::move(onChunk)](std::string_view chunk) {
+            if (!chunk.empty() && capture->timeToFirstByte.count() < 0) {
+                capture->timeToFirstByte = Since(start);
+            }
+            capture->body.append(chunk);
+            onChunk(chunk);
+        }, options);
+
+    return WhenReady(std::move(pending),
+        [writer = m_writer, uri, body, headers, start, capture](HTTPResponse response) {
+            auto elapsed = Since(start);
+            // Non-2xx bodies are buffered into the response rather than streamed
+            std::string_view recordedBody = response.body.empty() ? std::string_view(capture->body)
+                                                                  : std::string_view(response.body);
+            CassetteRecord record = MakeRecord("POST", uri, body, headers, response, recordedBody);
+            record.timeToFirstByte = capture->timeToFirstByte.count() < 0 ? elapsed : capture->timeToFirstByte;
+            record.totalTime = elapsed;
+            writer->Write(record);
+            return response;
+        });
+}
+
+} // namespace http_client
@@ -0,0 +1,156 @@
+#include "http_client/replay_http_client.hpp"
+#include "exceptions/llm_exceptions.hpp"
+
+namespace http_client {
+
+namespace {
+
+bool IsSuccess(int statusCode) {
+    return statusCode >= 200 && statusCode < 300;
+}
+
+} // namespace
+
+std::size_t ReplayHTTPClient::RequestKeyHash::operator()(const RequestKey& key) const {
+    std::hash<std::string_view> hash;
+    std::size_t seed = hash(key.method);
+    for (std::string_view part : {key.uri, key.body}) {
+        seed ^= hash(part) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+    }
+    return seed;
+}
+
+ReplayHTTPClient::ReplayHTTPClient(const std::string& cassettePath, bool replayLatency)
+    : m_cassette(cassettePath), m_replayLatency(replayLatency), m_timeout(30000) {
+    for (const auto& record : m_cassette.Records()) {
+        // Keyed on views into the mapping, so request bodies are not copied
+        m_index[RequestKey{record.method, record.uri, record.requestBody}].records.push_back(&record);
+    }
+}
+
+const CassetteRecord& ReplayHTTPClient::Match(std::string_view method, std::string_view uri, std::string_view body) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_index.find(RequestKey{method, uri, body});
+    if (it == m_index.end()) {
+        throw llm::HTTPException("No recorded response for " + std::string(method) + " " + std::string(uri));
+    }
+    Recordings& recordings = it->second;
+    const CassetteRecord* record = recordings.records[recordings.next];
+    if (recordings.next + 1 < recordings.records.size()) {
+        ++recordings.next;
+    }
+    return *record;
+}
+
+HTTPResponse ReplayHTTPClient::ToResponse(const CassetteRecord& record) {
+    HTTPResponse response;
+    response.statusCode = record.statusCode;
+    response.headers.assign(record.responseHeaders.begin(), record.responseHeaders.end());
+    response.body = std::string(record.responseBody);
+    // Only the end-to-end times are recorded; phases stay zero
+    response.timing.timeToFirstByte = record.timeToFirstByte;
+    response.timing.total = record.totalTime;
+    response.timing.bytesUploaded = record.requestBody.size();
+    response.timing.bytesDownloaded = record.responseBody.size();
+    return response;
+}
+
+std::future<HTTPResponse> ReplayHTTPClient::Replay(std::string_view method, const std::string& uri, std::string_view body, const RequestOptions& options) {
+    std::promise<HTTPResponse> promise;
+    try {
+        options.ThrowIfDone();
+        const CassetteRecord& record = Match(method, uri, body);
+        if (m_replayLatency) {
+            // Ready at the recorded time after dispatch.  A real future, so
+            // callers can wait on it with a timeout like any transport's.
+            auto readyAt = std::chrono::steady_clock::now() + record.totalTime;
+            return std::async(std::launch::async, [&record, readyAt, options]() {
+                options.SleepUntil(readyAt);
+                return ToResponse(record);
+            });
+        }
+        promise.set_value(ToResponse(record));
+    } catch (...) {
+        promise.set_exception(std::current_exception());
+    }
+    return promise.get_future();
+}
+
+std::future<HTTPResponse> ReplayHTTPClient::Get(const std::string& uri, const std::vector<std::string>&) {
+    return Replay("GET", uri, {});
+}
+
+std::future<HTTPResponse> ReplayHTTPClient::Put(const std::string& uri, const std::string& body, const std::vector<std::string>&) {
+    return Replay("PUT", uri, body);
+}
+
+std::future<HTTPResponse> ReplayHTTPClient::Post(const std::string& uri, const std::string& body, const std::vector<std::string>&, const RequestOptions& options) {
+    return Replay("POST", uri, body, options);
+}
+
+std::future<HTTPResponse> ReplayHTTPClient::Patch(const std::string& uri, const std::string& body, const std::vector<std::string>&) {
+    return Replay("PATCH", uri, body);
+}
+
+std::future<HTTPResponse> ReplayHTTPClient::Delete(const std::string& uri, const std::vector<std::string>&) {
+    return Replay("DELETE", uri, {});
+}
+
+void ReplayHTTPClient::SetTimeout(std::chrono::milliseconds timeout) {
+    m_timeout = timeout;
+}
+
+std::chrono::milliseconds ReplayHTTPClient::GetTimeout() const {
+    return m_timeout;
+}
+
+std::future<HTTPResponse> ReplayHTTPClient::PostStreaming(const std::string& uri, const std::string& body, const std::vector<std::string>&, BodyChunkHandler onChunk, const RequestOptions& options) {
+    const CassetteRecord* record = nullptr;
+    try {
+        options.ThrowIfDone();
+        record = &Match("POST", uri, body);
+    } catch (...) {
+        onChunk({});
+        std::promise<HTTPResponse> promise;
+        promise.set_exception(std::current_exception());
+        return promise.get_future();
+    }
+
+    // Follows the PostStreaming contract: 2xx bodies go to onChunk, then
+    // the end marker, then the response.  Cancelling or passing the
+    // deadline ends a paced delivery early.
+    auto deliver = [record, onChunk = std::move(onChunk), options](bool paced) {
+        auto start = std::chrono::steady_clock::now();
+        HTTPResponse response = ToResponse(*record);
+        try {
+            if (IsSuccess(response.statusCode)) {
+                if (paced) {
+                    options.SleepUntil(start + record->timeToFirstByte);
+                }
+                if (!response.body.empty()) {
+                    onChunk(response.body);
+                }
+                response.body.clear();
+            }
+            if (paced) {
+                options.SleepUntil(start + record->totalTime);
+            }
+        } catch (...) {
+            onChunk({});
+            throw;
+        }
+        onChunk({});
+        return response;
+    };
+
+    // Callers may read the body before waiting on the future, so paced
+    // delivery needs its own thread
+    if (m_replayLatency) {
+        return std::async(std::launch::async, std::move(deliver), true);
+    }
+    std::promise<HTTPResponse> promise;
+    promise.set_value(deliver(false));
+    return promise.get_future();
+}
+
+} // namespace http_client
@@ -0,0 +1,96 @@
+#include "http_client/request_options.hpp"
+#include "exceptions/llm_exceptions.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace http_client {
+
+struct CancellationToken::State {
+    std::atomic<bool> cancelled{false};
+    std::mutex mutex;
+    std::unordered_map<std::uint64_t, std::function<void()>> callbacks;
+    std::uint64_t nextId = 1;
+};
+
+CancellationToken::CancellationToken() : m_state(std::make_shared<State>()) {}
+
+void CancellationToken::Cancel() const {
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    if (m_state->cancelled.exchange(true)) {
+        return;
+    }
+    for (auto& [id, callback] : m_state->callbacks) {
+        callback();
+    }
+    m_state->callbacks.clear();
+}
+
+bool CancellationToken::IsCancelled() const {
+    return m_state->cancelled.load();
+}
+
+std::uint64_t CancellationToken::OnCancel(std::function<void()> callback) const {
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    if (m_state->cancelled) {
+        callback();
+        return 0;
+    }
+    std::uint64_t id = m_state->nextId++;
+    m_state->callbacks.emplace(id, std::move(callback));
+    return id;
+}
+
+void CancellationToken::Unregister(std::uint64_t id) const {
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    m_state->callbacks.erase(id);
+}
+
+std::chrono::milliseconds RequestOptions::TimeLeft(std::chrono::milliseconds timeout) const {
+    if (!deadline) {
+        return timeout;
+    }
+    auto left = std::max(std::chrono::ceil<std::chrono::milliseconds>(*deadline - std::chrono::steady_clock::now()),
+                         std::chrono::milliseconds(1));
+    return timeout.count() > 0 ? std::min(left, timeout) : left;
+}
+
+void RequestOptions::ThrowIfDone() const {
+    if (IsCancelled()) {
+        throw llm::HTTPException("Request cancelled");
+    }
+    if (IsExpired()) {
+        throw llm::HTTPException("Request deadline exceeded");
+    }
+}
+
+void RequestOptions::SleepUntil(std::chrono::steady_clock::time_point until) const {
+    if (deadline && *deadline < until) {
+        until = *deadline;
+    }
+    if (!cancellation) {
+        std::this_thread::sleep_until(until);
+    } else {
+        std::mutex mutex;
+        std::condition_variable wake;
+        bool cancelled = false;
+        auto id = cancellation->OnCancel([&]() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                cancelled = true;
+            }
+            wake.notify_all();
+        });
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait_until(lock, until, [&cancelled]() { return cancelled; });
+        }
+        cancellation->Unregister(id);
+    }
+    ThrowIfDone();
+}
+
+} // namespace http_client
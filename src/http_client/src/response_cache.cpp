@@ -0,0 +1,338 @@
+#include "http_client/response_cache.hpp"
+#include <spdlog/spdlog.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace http_client {
+
+namespace {
+
+// Version 2 added the request URI and body
+constexpr char kDiskMagic[] = "CQRC2\n";
+constexpr std::size_t kDiskMagicSize = sizeof(kDiskMagic) - 1;
+
+// Distinguishes temporary files written concurrently by one process
+std::atomic<std::uint64_t> temporaryCounter{0};
+
+std::size_t EntryBytes(std::string_view uri, std::string_view body, const HTTPResponse& response) {
+    std::size_t bytes = uri.size() + body.size() + response.body.size();
+    for (const auto& header : response.headers) {
+        bytes += header.size();
+    }
+    return bytes;
+}
+
+template <typename T>
+void WritePod(std::ostream& out, T value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void WriteString(std::ostream& out, std::string_view value) {
+    WritePod<std::uint64_t>(out, value.size());
+    out.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+// Bounds-checked reads from an entry loaded into memory, so a corrupt or
+// truncated file is a miss rather than a huge allocation
+class EntryReader {
+public:
+    explicit EntryReader(std::string_view data) : m_data(data) {}
+
+    std::size_t Remaining() const { return m_data.size(); }
+
+    template <typename T>
+    bool Pod(T& value) {
+        if (m_data.size() < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, m_data.data(), sizeof(T));
+        m_data.remove_prefix(sizeof(T));
+        return true;
+    }
+
+    bool String(std::string_view& value) {
+        std::uint64_t size = 0;
+        if (!Pod(size) || size > m_data.size()) {
+            return false;
+        }
+        value = m_data.substr(0, size);
+        m_data.remove_prefix(size);
+        return true;
+    }
+
+private:
+    std::string_view m_data;
+};
+
+std::optional<std::string> ReadFile(const std::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        return std::nullopt;
+    }
+    auto size = in.tellg();
+    if (size < 0) {
+        return std::nullopt;
+    }
+    std::string data(static_cast<std::size_t>(size), '\0');
+    in.seekg(0);
+    if (!in.read(data.data(), size)) {
+        return std::nullopt;
+    }
+    return data;
+}
+
+} // namespace
+
+ResponseCache::ResponseCache(ResponseCacheOptions options) : m_options(std::move(options)) {
+    if (m_options.diskDirectory) {
+        std::filesystem::create_directories(*m_options.diskDirectory);
+        for (const auto& entry : std::filesystem::directory_iterator(*m_options.diskDirectory)) {
+            if (entry.is_regular_file()) {
+                m_diskBytes += entry.file_size();
+            }
+        }
+    }
+}
+
+std::string ResponseCache::KeyFor(std::string_view uri, std::string_view body) {
+    std::uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](std::string_view bytes) {
+        for (unsigned char byte : bytes) {
+            hash ^= byte;
+            hash *= 1099511628211ull;
+        }
+    };
+    mix(uri);
+    mix(std::string_view("\n", 1));
+    mix(body);
+
+    char key[40];
+    std::snprintf(key, sizeof(key), "%016llx-%llx",
+                  static_cast<unsigned long long>(hash), static_cast<unsigned long long>(body.size()));
+    return key;
+}
+
+bool ResponseCache::Expired(Clock::time_point storedAt) const {
+    return m_options.ttl.count() != 0 && Clock::now() - storedAt > m_options.ttl;
+}
+
+std::optional<HTTPResponse> ResponseCache::Lookup(std::string_view uri, std::string_view body) {
+    std::string key = KeyFor(uri, body);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_index.find(key);
+        // The key is only a hash; a different request that collides with it
+        // is not served, and leaves the entry in place
+        if (it != m_index.end() && it->second->uri == uri && it->second->body == body) {
+            if (!Expired(it->second->storedAt)) {
+                m_lru.splice(m_lru.begin(), m_lru, it->second);
+                ++m_stats.hits;
+                return it->second->response;
+            }
+            m_memoryBytes -= it->second->bytes;
+            m_lru.erase(it->second);
+            m_index.erase(it);
+        }
+    }
+
+    // File IO happens without the lock so other lookups aren't held up
+    Clock::time_point storedAt;
+    std::optional<HTTPResponse> response;
+    if (m_options.diskDirectory) {
+        response = ReadFromDisk(key, uri, body, storedAt);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (response && !Expired(storedAt)) {
+        ++m_stats.hits;
+        ++m_stats.diskHits;
+        InsertInMemory(key, uri, body, *response, storedAt);
+        return response;
+    }
+    ++m_stats.misses;
+    return std::nullopt;
+}
+
+void ResponseCache::Store(std::string_view uri, std::string_view body, const HTTPResponse& response) {
+    std::string key = KeyFor(uri, body);
+    auto now = Clock::now();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_stats.stores;
+        InsertInMemory(key, uri, body, response, now);
+    }
+    if (m_options.diskDirectory) {
+        WriteToDisk(key, uri, body, response, now);
+    }
+}
+
+void ResponseCache::Clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_lru.clear();
+    m_index.clear();
+    m_memoryBytes = 0;
+}
+
+ResponseCacheStats ResponseCache::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void ResponseCache::InsertInMemory(const std::string& key, std::string_view uri, std::string_view body,
+                                   HTTPResponse response, Clock::time_point storedAt) {
+    auto existing = m_index.find(key);
+    if (existing != m_index.end()) {
+        m_memoryBytes -= existing->second->bytes;
+        m_lru.erase(existing->second);
+        m_index.erase(existing);
+    }
+
+    std::size_t bytes = EntryBytes(uri, body, response);
+    if (bytes > m_options.maxMemoryBytes || m_options.maxEntries == 0) {
+        return;
+    }
+    m_lru.push_front(Entry{key, std::string(uri), std::string(body), std::move(response), storedAt, bytes});
+    m_index[key] = m_lru.begin();
+    m_memoryBytes += bytes;
+
+    while (m_lru.size() > m_options.maxEntries || m_memoryBytes > m_options.maxMemoryBytes) {
+        m_memoryBytes -= m_lru.back().bytes;
+        m_index.erase(m_lru.back().key);
+        m_lru.pop_back();
+        ++m_stats.evictions;
+    }
+}
+
+std::optional<HTTPResponse> ResponseCache::ReadFromDisk(const std::string& key, std::string_view uri,
+                                                        std::string_view body, Clock::time_point& storedAt) const {
+    auto data = ReadFile(std::filesystem::path(*m_options.diskDirectory) / key);
+    if (!data) {
+        return std::nullopt;
+    }
+
+    std::string_view storedUri;
+    std::string_view storedBody;
+    std::int64_t storedSeconds = 0;
+    std::int32_t statusCode = 0;
+    std::uint64_t headerCount = 0;
+    if (std::string_view(*data).substr(0, kDiskMagicSize) != std::string_view(kDiskMagic, kDiskMagicSize)) {
+        spdlog::warn("Ignoring unreadable cache entry {}", key);
+        return std::nullopt;
+    }
+    EntryReader reader(std::string_view(*data).substr(kDiskMagicSize));
+    // Each header takes at least its 8-byte length
+    if (!reader.Pod(storedSeconds) || !reader.Pod(statusCode) || !reader.String(storedUri) ||
+        !reader.String(storedBody) || !reader.Pod(headerCount) ||
+        headerCount > reader.Remaining() / sizeof(std::uint64_t)) {
+        spdlog::warn("Ignoring unreadable cache entry {}", key);
+        return std::nullopt;
+    }
+    // The key is only a hash; a different request that collides with it is a miss
+    if (storedUri != uri || storedBody != body) {
+        return std::nullopt;
+    }
+
+    HTTPResponse response;
+    response.statusCode = statusCode;
+    response.headers.reserve(headerCount);
+    std::string_view value;
+    for (std::uint64_t i = 0; i < headerCount; ++i) {
+        if (!reader.String(value)) {
+            spdlog::warn("Ignoring unreadable cache entry {}", key);
+            return std::nullopt;
+        }
+        response.headers.emplace_back(value);
+    }
+    if (!reader.String(value)) {
+        spdlog::warn("Ignoring unreadable cache entry {}", key);
+        return std::nullopt;
+    }
+    response.body = std::string(value);
+
+    storedAt = Clock::time_point(std::chrono::seconds(storedSeconds));
+    return response;
+}
+
+void ResponseCache::WriteToDisk(const std::string& key, std::string_view uri, std::string_view body,
+                                const HTTPResponse& response, Clock::time_point storedAt) {
+    auto directory = std::filesystem::path(*m_options.diskDirectory);
+    auto path = directory / key;
+    // Written under a temporary name and renamed, so readers in other
+    // processes never see a partial entry.  The name is unique per writer,
+    // so the file is written without holding the lock.
+    auto temporary = directory / (key + "." + std::to_string(::getpid()) + "." +
+                                  std::to_string(temporaryCounter++) + ".tmp");
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(kDiskMagic, kDiskMagicSize);
+        WritePod<std::int64_t>(out, std::chrono::duration_cast<std::chrono::seconds>(storedAt.time_since_epoch()).count());
+        WritePod<std::int32_t>(out, response.statusCode);
+        WriteString(out, uri);
+        WriteString(out, body);
+        WritePod<std::uint64_t>(out, response.headers.size());
+        for (const auto& header : response.headers) {
+            WriteString(out, header);
+        }
+        WriteString(out, response.body);
+        if (!out) {
+            spdlog::warn("Failed to write cache entry {}", path.string());
+            std::error_code error;
+            std::filesystem::remove(temporary, error);
+            return;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::error_code error;
+    auto previousSize = std::filesystem::exists(path) ? std::filesystem::file_size(path, error) : 0;
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        spdlog::warn("Failed to store cache entry {}: {}", path.string(), error.message());
+        return;
+    }
+    m_diskBytes = m_diskBytes - std::min(m_diskBytes, previousSize) + std::filesystem::file_size(path, error);
+
+    if (m_diskBytes > m_options.maxDiskBytes) {
+        TrimDisk();
+    }
+}
+
+void ResponseCache::TrimDisk() {
+    // Oldest first, down to 90% of the limit so trimming isn't repeated
+    // on every store
+    std::vector<std::filesystem::directory_entry> files;
+    for (const auto& entry : std::filesystem::directory_iterator(*m_options.diskDirectory)) {
+        if (entry.is_regular_file()) {
+            files.push_back(entry);
+        }
+    }
+    std::sort(files.begin(), files.end(), [](const auto& a, const auto& b) {
+        return a.last_write_time() < b.last_write_time();
+    });
+
+    std::uintmax_t total = 0;
+    for (const auto& file : files) {
+        total += file.file_size();
+    }
+    std::uintmax_t target = m_options.maxDiskBytes / 10 * 9;
+    for (const auto& file : files) {
+        if (total <= target) {
+            break;
+        }
+        std::error_code error;
+        auto size = file.file_size();
+        if (std::filesystem::remove(file.path(), error)) {
+            total -= size;
+            ++m_stats.evictions;
+        }
+    }
+    m_diskBytes = total;
+}
+
+} // namespace http_client
@@ -0,0 +1,31 @@
+#ifndef HTTP_CLIENT_WHEN_READY_HPP
+#define HTTP_CLIENT_WHEN_READY_HPP
+
+#include "http_client/http_response.hpp"
+#include <exception>
+#include <future>
+#include <thread>
+
+namespace http_client {
+
+// Runs finish on its own thread as soon as pending is ready, so a
+// decorator's follow-up work happens when the transport completes, not
+// when (or whether) the caller reads the response.  The returned future is
+// an ordinary one, so layers above can still wait on it with a timeout.
+template <typename Finish>
+std::future<HTTPResponse> WhenReady(std::future<HTTPResponse> pending, Finish finish) {
+    std::promise<HTTPResponse> promise;
+    auto result = promise.get_future();
+    std::thread([promise = std::move(promise), pending = std::move(pending), finish = std::move(finish)]() mutable {
+        try {
+            promise.set_value(finish(pending.get()));
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+        }
+    }).detach();
+    return result;
+}
+
+} // namespace http_client
+
+#endif // HTTP_CLIENT_WHEN_READY_HPP
@@ -1,59 +1,58 @@
 // src/main/main.cpp
 #include "session/llm_session.hpp"
 #include "translator/openai_translator.hpp"
-#include "http_client/curl_http_client.hpp"
+#include "http_client/curl_multi_http_client.hpp"
+#include "http_client/caching_http_client.hpp"
+#include "http_client/recording_http_client.hpp"
+#include "http_client/replay_http_client.hpp"
+#include "http_client/rate_limited_http_client.hpp"
+#include "http_client/hedging_http_client.hpp"
 #include "core/streamsource.hpp"
+#include "core/typed_tool.hpp"
+#include "script_runner.hpp"
 #include <spdlog/spdlog.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
+#include <algorithm>
+#include <filesystem>
 #include <iostream>
 #include <fstream>
-#include <nlohmann/json.hpp>
+
+struct WeatherArgs {
+    std::string location;
+
+    static constexpr auto toolFields() {
+        return std::make_tuple(
+            toolField("location", &WeatherArgs::location, "The city and state, e.g. San Francisco, CA"));
+    }
+};
 
 Tool createWeatherTool() {
-    Tool tool;
-    tool.name = "get_weather";
-    tool.description = "Get the current weather for a location";
-    tool.function = [](std::string paramsJson) {
-        spdlog::debug("Weather tool called with: {}", paramsJson);
-        std::string result{"Sunny and 75 degrees fahrenheit"};
-        spdlog::debug("Weather tool result: {}", result);
-        return result;
-    };
-
-    Parameter location;
-    location.name = "location";
-    location.type = "string";
-    location.description = "The city and state, e.g. San Francisco, CA";
-    location.required = true;
-
-    tool.parameters.push_back(location);
-    return tool;
+    return makeTypedTool<WeatherArgs>("get_weather", "Get the current weather for a location",
+        [](const WeatherArgs& args) {
+            spdlog::debug("Weather tool called for: {}", args.location);
+            std::string result{"Sunny and 75 degrees fahrenheit"};
+            spdlog::debug("Weather tool result: {}", result);
+            return result;
+        });
 }
 
+struct TemperatureArgs {
+    double fahrenheit = 0;
+
+    static constexpr auto toolFields() {
+        return std::make_tuple(
+            toolField("fahrenheit", &TemperatureArgs::fahrenheit, "The temperature in Fahrenheit"));
+    }
+};
+
 Tool createTemperatureConverterTool() {
-    Tool tool;
-    tool.name = "fahrenheit_to_celsius";
-    tool.description = "Converts a temperature in Fahrenheit to Celsius";
-    tool.function = [](std::string paramsJson) -> std::string {
-        spdlog::debug("Temperature converter tool called with: {}", paramsJson);
-        nlohmann::json params = nlohmann::json::parse(paramsJson);
-        if (params.find("fahrenheit") == params.end()) {
-            return "Missing fahrenheit parameter";
-        }
-        double fahrenheit = params["fahrenheit"];
-        double celsius = (fahrenheit - 32) * 5 / 9;
-        spdlog::debug("Temperature converter tool result: {}", celsius);
-        return std::to_string(celsius);
-    };
-
-    Parameter param;
-    param.name = "fahrenheit";
-    param.type = "number";
-    param.description = "The temperature in Fahrenheit";
-    param.required = true;
-
-    tool.parameters.push_back(param);
-    return tool;
+    return makeTypedTool<TemperatureArgs>("fahrenheit_to_celsius", "Converts a temperature in Fahrenheit to Celsius",
+        [](const TemperatureArgs& args) {
+            spdlog::debug("Temperature converter tool called with: {}", args.fahrenheit);
+            double celsius = (args.fahrenheit - 32) * 5 / 9;
+            spdlog::debug("Temperature converter tool result: {}", celsius);
+            return std::to_string(celsius);
+        });
 }
 
 void setupLogging(const std::optional<std::string>& logLevel) {
@@ -66,8 +65,36 @@ void setupLogging(const std::optional<std::string>& logLevel) {
     }
 }
 
-std::vector<std::string> parseCommandLineArgs(int argc, char* argv[]) {
+struct CommandLineOptions {
     std::vector<std::string> filenames;
+    std::optional<std::size_t> concurrency;
+    std::optional<std::string> outputDirectory;
+    std::optional<std::string> cacheDirectory;
+    std::optional<std::string> recordPath;
+    std::optional<std::string> replayPath;
+    bool replayLatency = false;
+    http_client::RateLimitOptions rateLimits;
+    std::optional<double> hedgePercentile;
+    std::optional<std::chrono::milliseconds> scriptTimeout;
+    // Shared by every session; see LLMSession::setEndpointPool
+    std::vector<EndpointPool::Endpoint> endpoints;
+    std::optional<EndpointPool::Strategy> balance;
+};
+
+// Regular files in a directory, sorted so runs are reproducible
+std::vector<std::string> listScripts(const std::string& directory) {
+    std::vector<std::string> scripts;
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        if (entry.is_regular_file()) {
+            scripts.push_back(entry.path().string());
+        }
+    }
+    std::sort(scripts.begin(), scripts.end());
+    return scripts;
+}
+
+CommandLineOptions parseCommandLineArgs(int argc, char* argv[]) {
+    CommandLineOptions options;
     
     for (int i = 1; i < argc; i += 2) {
         if (i + 1 >= argc) {
@@ -78,7 +105,46 @@ std::vector<std::string> parseCommandLineArgs(int argc, char* argv[]) {
         std::string value = argv[i + 1];
         
         if (arg == "--filename") {
-            filenames.push_back(value);
+            options.filenames.push_back(value);
+        } else if (arg == "--directory") {
+            auto scripts = listScripts(value);
+            options.filenames.insert(options.filenames.end(), scripts.begin(), scripts.end());
+        } else if (arg == "--concurrency") {
+            options.concurrency = std::stoul(value);
+        } else if (arg == "--output-dir") {
+            options.outputDirectory = value;
+        } else if (arg == "--cache-dir") {
+            options.cacheDirectory = value;
+        } else if (arg == "--record") {
+            options.recordPath = value;
+        } else if (arg == "--replay") {
+            options.replayPath = value;
+        } else if (arg == "--replay-latency") {
+            options.replayLatency = value == "on" || value == "true";
+        } else if (arg == "--requests-per-minute") {
+            options.rateLimits.requestsPerMinute = std::stod(value);
+        } else if (arg == "--tokens-per-minute") {
+            options.rateLimits.tokensPerMinute = std::stod(value);
+        } else if (arg == "--max-retries") {
+            options.rateLimits.maxRetries = std::stoi(value);
+        } else if (arg == "--hedge-percentile") {
+            options.hedgePercentile = std::stod(value) / 100.0;
+        } else if (arg == "--script-timeout") {
+            options.scriptTimeout = std::chrono::milliseconds(std::stol(value));
+        } else if (arg == "--endpoint") {
+            // <uri>[,<api key name>]
+            EndpointPool::Endpoint endpoint;
+            auto comma = value.find(',');
+            endpoint.uri = value.substr(0, comma);
+            if (comma != std::string::npos) {
+                endpoint.apiKeyName = value.substr(comma + 1);
+            }
+            options.endpoints.push_back(std::move(endpoint));
+        } else if (arg == "--balance") {
+            options.balance = EndpointPool::parseStrategy(value);
+            if (!options.balance) {
+                throw std::runtime_error("Unknown --balance strategy: " + value);
+            }
         } else if (arg == "--log-level") {
             setupLogging(value);
         } else {
@@ -86,36 +152,131 @@ std::vector<std::string> parseCommandLineArgs(int argc, char* argv[]) {
         }
     }
     
-    if (filenames.empty()) {
+    if (options.filenames.empty()) {
         throw std::runtime_error("No input file specified");
     }
+    if (options.recordPath && options.replayPath) {
+        throw std::runtime_error("--record and --replay cannot be combined");
+    }
     
-    return filenames;
+    return options;
+}
+
+struct Transport {
+    std::shared_ptr<http_client::IHTTPClient> client;
+    // Set when --hedge-percentile is given
+    std::shared_ptr<http_client::HedgingHTTPClient> hedging;
+};
+
+// Live network, optionally recorded to a cassette, or a cassette replayed
+// offline.  Live requests are paced per endpoint and 429/5xx are retried;
+// slow deterministic requests can be hedged.  Hedging sits outside the
+// rate limiter so a hedge waits for the limiter like any other request.
+Transport createTransport(const CommandLineOptions& options) {
+    if (options.replayPath) {
+        return {std::make_shared<http_client::ReplayHTTPClient>(*options.replayPath, options.replayLatency), nullptr};
+    }
+    Transport transport;
+    transport.client = std::make_shared<http_client::CurlMultiHTTPClient>();
+    if (options.recordPath) {
+        transport.client = std::make_shared<http_client::RecordingHTTPClient>(transport.client, *options.recordPath);
+    }
+    transport.client = std::make_shared<http_client::RateLimitedHTTPClient>(transport.client, options.rateLimits);
+    if (options.hedgePercentile) {
+        http_client::HedgingOptions hedgingOptions;
+        hedgingOptions.percentile = *options.hedgePercentile;
+        transport.hedging = std::make_shared<http_client::HedgingHTTPClient>(transport.client, hedgingOptions);
+        transport.client = transport.hedging;
+    }
+    return transport;
+}
+
+void setupSession(LLMSession& session, const CommandLineOptions& options,
+                  const std::shared_ptr<EndpointPool>& endpointPool) {
+    session.addTool(createWeatherTool());
+    session.addTool(createTemperatureConverterTool());
+    if (endpointPool) {
+        session.setEndpointPool(endpointPool);
+    }
+
+    // Cassettes never contain credentials, so replay needs none
+    if (options.replayPath) {
+        session.setApiKeyResolver([](const std::string&) { return std::string("replay"); });
+    }
 }
 
 int main(int argc, char* argv[]) {
     try {
-        auto filenames = parseCommandLineArgs(argc, argv);
+        auto options = parseCommandLineArgs(argc, argv);
         
-        std::ifstream file(filenames[0]);
-        if (!file.is_open()) {
-            throw std::runtime_error("Unable to open file: " + filenames[0]);
+        // One transport for every session so connections are shared.
+        // Deterministic requests are answered from the response cache when
+        // they repeat; --cache-dir keeps the cache across runs.
+        http_client::ResponseCacheOptions cacheOptions;
+        cacheOptions.diskDirectory = options.cacheDirectory;
+        auto cache = std::make_shared<http_client::ResponseCache>(cacheOptions);
+        auto transport = createTransport(options);
+        std::shared_ptr<http_client::IHTTPClient> httpClient = std::make_shared<http_client::CachingHTTPClient>(
+            transport.client, cache);
+
+        // --endpoint spreads every session's requests over the same replicas
+        std::shared_ptr<EndpointPool> endpointPool;
+        if (!options.endpoints.empty() || options.balance) {
+            endpointPool = std::make_shared<EndpointPool>();
+            for (const auto& endpoint : options.endpoints) {
+                endpointPool->add(endpoint);
+            }
+            if (options.balance) {
+                endpointPool->setStrategy(*options.balance);
+            }
         }
-        StreamSource source(file);
 
-        // Create session with basic dependencies
-        auto session = LLMSession(
-            std::make_unique<http_client::CurlHTTPClient>()
-        );
+        // A single script runs as before, echoing straight to stdout
+        if (options.filenames.size() == 1 && !options.concurrency && !options.outputDirectory &&
+            !options.scriptTimeout) {
+            std::ifstream file(options.filenames[0]);
+            if (!file.is_open()) {
+                throw std::runtime_error("Unable to open file: " + options.filenames[0]);
+            }
+            StreamSource source(file);
 
-        // Add available tools
-        session.addTool(createWeatherTool());
-        session.addTool(createTemperatureConverterTool());
+            auto session = LLMSession(httpClient);
+            setupSession(session, options, endpointPool);
 
-        // Process all messages from the source
-        session.processMessages(source);
-        
-        return 0;
+            // Process all messages from the source
+            session.processMessages(source);
+            return 0;
+        }
+
+        ScriptRunner::Options runnerOptions;
+        runnerOptions.concurrency = options.concurrency.value_or(1);
+        runnerOptions.outputDirectory = options.outputDirectory;
+        runnerOptions.scriptTimeout = options.scriptTimeout;
+        ScriptRunner runner(httpClient,
+                            [&options, &endpointPool](LLMSession& session) {
+                                setupSession(session, options, endpointPool);
+                            },
+                            runnerOptions);
+
+        auto summary = runner.run(options.filenames, std::cout);
+        ScriptRunner::printSummary(summary, std::cout);
+        auto cacheStats = cache->GetStats();
+        std::cout << "Cache:      " << cacheStats.hits << " hits (" << cacheStats.diskHits << " from disk), "
+                  << cacheStats.misses << " misses" << std::endl;
+        if (transport.hedging) {
+            auto hedgingStats = transport.hedging->GetStats();
+            std::cout << "Hedges:     " << hedgingStats.hedgesSent << " sent, " << hedgingStats.hedgesWon
+                      << " won (" << hedgingStats.eligible << " eligible requests)" << std::endl;
+        }
+        if (endpointPool) {
+            for (const auto& endpoint : endpointPool->stats()) {
+                std::cout << "Endpoint:   " << endpoint.endpoint.uri << ": " << endpoint.requests << " requests, "
+                          << endpoint.failures << " failed, "
+                          << std::chrono::duration_cast<std::chrono::milliseconds>(endpoint.latency).count()
+                          << " ms average" << (endpoint.ejected ? " (ejected)" : "") << std::endl;
+            }
+        }
+        return summary.failures.empty() ? 0 : 1;
     } 
     catch (const std::exception& e) {
         spdlog::error("Error: {}", e.what());
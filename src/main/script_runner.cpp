@@ -0,0 +1,131 @@
+// src/main/script_runner.cpp
+#include "script_runner.hpp"
+#include "core/streamsource.hpp"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+ScriptRunner::ScriptRunner(std::shared_ptr<http_client::IHTTPClient> httpClient,
+                           SessionSetup setup, Options options)
+    : httpClient_(std::move(httpClient)), setup_(std::move(setup)), options_(std::move(options)) {
+    if (options_.concurrency == 0) {
+        throw std::runtime_error("Concurrency must be at least 1");
+    }
+}
+
+std::size_t ScriptRunner::runScript(const std::string& script, std::ostream& output) {
+    std::ifstream file(script);
+    if (!file.is_open()) {
+        throw std::runtime_error("Unable to open file: " + script);
+    }
+    StreamSource source(file);
+
+    LLMSession session(httpClient_);
+    session.setOutput(output);
+    if (setup_) {
+        setup_(session);
+    }
+
+    http_client::RequestOptions requestOptions;
+    requestOptions.cancellation = cancellation_;
+    if (options_.scriptTimeout) {
+        requestOptions.deadline = std::chrono::steady_clock::now() + *options_.scriptTimeout;
+    }
+    session.processMessages(source, requestOptions);
+
+    const auto& conversation = session.getConversation();
+    return static_cast<std::size_t>(std::count_if(conversation.begin(), conversation.end(),
+        [](const std::unique_ptr<Message>& message) {
+            return message->getType() == Message::Type::Assistant;
+        }));
+}
+
+ScriptRunner::Summary ScriptRunner::run(const std::vector<std::string>& scripts, std::ostream& output) {
+    Summary summary;
+    summary.scripts = scripts.size();
+
+    if (options_.outputDirectory) {
+        std::filesystem::create_directories(*options_.outputDirectory);
+    }
+
+    std::mutex mutex;
+    std::atomic<std::size_t> next{0};
+    auto start = std::chrono::steady_clock::now();
+
+    auto worker = [&]() {
+        for (std::size_t i = next++; i < scripts.size(); i = next++) {
+            const std::string& script = scripts[i];
+            std::ostringstream buffer;
+            std::ofstream outputFile;
+            std::ostream* scriptOutput = &buffer;
+            if (options_.outputDirectory) {
+                auto path = std::filesystem::path(*options_.outputDirectory) /
+                            (std::filesystem::path(script).filename().string() + ".out");
+                outputFile.open(path);
+                scriptOutput = &outputFile;
+            }
+
+            std::optional<std::string> error;
+            std::size_t requests = 0;
+            try {
+                if (options_.outputDirectory && !outputFile.is_open()) {
+                    throw std::runtime_error("Unable to open output file for " + script);
+                }
+                requests = runScript(script, *scriptOutput);
+            } catch (const std::exception& e) {
+                error = e.what();
+                *scriptOutput << "Error: " << e.what() << std::endl;
+                spdlog::error("{}: {}", script, e.what());
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            summary.requests += requests;
+            if (error) {
+                summary.failures.push_back(Failure{script, *error});
+            } else {
+                ++summary.succeeded;
+            }
+            if (!options_.outputDirectory) {
+                output << "=== " << script << " ===\n" << buffer.str() << std::flush;
+            }
+        }
+    };
+
+    std::size_t threadCount = std::min(options_.concurrency, scripts.size());
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount);
+    for (std::size_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back(worker);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    summary.wallTime = std::chrono::steady_clock::now() - start;
+    return summary;
+}
+
+void ScriptRunner::cancel() {
+    cancellation_.Cancel();
+}
+
+void ScriptRunner::printSummary(const Summary& summary, std::ostream& output) {
+    double seconds = summary.wallTime.count();
+    output << "Scripts:    " << summary.scripts << " (" << summary.succeeded << " succeeded, "
+           << summary.failures.size() << " failed)\n"
+           << "Requests:   " << summary.requests << "\n"
+           << "Wall time:  " << seconds << " s\n";
+    if (seconds > 0) {
+        output << "Throughput: " << summary.scripts / seconds << " scripts/s, "
+               << summary.requests / seconds << " requests/s\n";
+    }
+    for (const auto& failure : summary.failures) {
+        output << "FAILED " << failure.script << ": " << failure.error << "\n";
+    }
+    output << std::flush;
+}
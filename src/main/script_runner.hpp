@@ -0,0 +1,68 @@
+// src/main/script_runner.hpp
+#pragma once
+#include "session/llm_session.hpp"
+#include "http_client/ihttp_client.hpp"
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Runs many conversation scripts concurrently over one transport
+ *
+ * Each script gets its own LLMSession; all sessions share the HTTP client, so
+ * connections are pooled across scripts.  A script's output is collected
+ * separately and written either to <outputDirectory>/<script name>.out or, when
+ * no directory is given, to the runner's output stream in one piece once the
+ * script finishes, so scripts never interleave.  A failing script is recorded
+ * in the summary and does not stop the others.
+ *
+ * cancel() may be called from any thread: requests in flight are aborted
+ * and the scripts not yet finished fail.
+ */
+class ScriptRunner {
+public:
+    struct Options {
+        std::size_t concurrency = 1;
+        std::optional<std::string> outputDirectory;
+        // Each script fails once it has run this long
+        std::optional<std::chrono::milliseconds> scriptTimeout;
+    };
+
+    struct Failure {
+        std::string script;
+        std::string error;
+    };
+
+    struct Summary {
+        std::size_t scripts = 0;
+        std::size_t succeeded = 0;
+        std::size_t requests = 0;
+        std::vector<Failure> failures;
+        std::chrono::duration<double> wallTime{0};
+    };
+
+    // Adds tools and other per-session setup before a script runs
+    using SessionSetup = std::function<void(LLMSession&)>;
+
+    ScriptRunner(std::shared_ptr<http_client::IHTTPClient> httpClient,
+                 SessionSetup setup, Options options);
+
+    Summary run(const std::vector<std::string>& scripts, std::ostream& output);
+
+    void cancel();
+
+    static void printSummary(const Summary& summary, std::ostream& output);
+
+private:
+    // Returns the number of responses received
+    std::size_t runScript(const std::string& script, std::ostream& output);
+
+    std::shared_ptr<http_client::IHTTPClient> httpClient_;
+    SessionSetup setup_;
+    Options options_;
+    http_client::CancellationToken cancellation_;
+};
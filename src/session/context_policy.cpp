@@ -0,0 +1,112 @@
+// src/session/context_policy.cpp
+#include "context_policy.hpp"
+#include <spdlog/spdlog.h>
+#include <unordered_set>
+
+namespace {
+
+constexpr std::size_t kBytesPerToken = 4;
+// Role markers and separators the provider adds around every message
+constexpr std::size_t kTokensPerMessage = 4;
+
+} // namespace
+
+TokenBudgetPolicy::TokenBudgetPolicy(std::size_t tokenBudget, std::size_t toolResultLimit)
+    : tokenBudget_(tokenBudget), toolResultLimit_(toolResultLimit) {}
+
+std::size_t TokenBudgetPolicy::estimateTokens(const Message& message) {
+    std::size_t bytes = message.content.size();
+    for (const auto& toolCall : message.tool_calls) {
+        bytes += toolCall.id.size() + toolCall.name.size() + toolCall.arguments.size();
+    }
+    return kTokensPerMessage + (bytes + kBytesPerToken - 1) / kBytesPerToken;
+}
+
+const Message* TokenBudgetPolicy::truncated(const Message& message) {
+    auto& copy = truncatedCopies_[message.getId()];
+    if (!copy) {
+        copy = std::make_unique<Message>(message);
+
+        // Cut at a UTF-8 character boundary
+        std::size_t keep = toolResultLimit_ * kBytesPerToken;
+        while (keep > 0 && (static_cast<unsigned char>(message.content[keep]) & 0xC0) == 0x80) {
+            --keep;
+        }
+        copy->content.assign(message.content, 0, keep)
+            .append("\n[truncated ")
+            .append(std::to_string(message.content.size() - keep))
+            .append(" bytes]");
+    }
+    return copy.get();
+}
+
+std::vector<const Message*> TokenBudgetPolicy::select(
+    const std::vector<std::unique_ptr<Message>>& conversation) {
+
+    // Substitute truncated tool results first; they count at their new size
+    std::vector<const Message*> messages;
+    messages.reserve(conversation.size());
+    std::unordered_set<std::uint64_t> liveIds;
+    for (const auto& message : conversation) {
+        const Message* candidate = message.get();
+        if (toolResultLimit_ != 0 && message->getType() == Message::Type::ToolResult &&
+            message->content.size() > toolResultLimit_ * kBytesPerToken) {
+            liveIds.insert(message->getId());
+            candidate = truncated(*message);
+        }
+        messages.push_back(candidate);
+    }
+    for (auto it = truncatedCopies_.begin(); it != truncatedCopies_.end();) {
+        it = liveIds.count(it->first) ? std::next(it) : truncatedCopies_.erase(it);
+    }
+
+    std::size_t total = 0;
+    for (const Message* message : messages) {
+        total += estimateTokens(*message);
+    }
+    if (tokenBudget_ == 0 || total <= tokenBudget_) {
+        return messages;
+    }
+
+    // Everything from the last user message onwards is the turn in progress
+    std::size_t pinnedFrom = messages.size();
+    for (std::size_t i = messages.size(); i-- > 0;) {
+        if (messages[i]->getType() == Message::Type::User) {
+            pinnedFrom = i;
+            break;
+        }
+    }
+
+    // Drop whole units, oldest first.  A unit is one message, or an
+    // assistant message with tool calls plus the tool results after it.
+    std::vector<bool> dropped(messages.size(), false);
+    std::size_t i = 0;
+    while (total > tokenBudget_ && i < pinnedFrom) {
+        std::size_t end = i + 1;
+        if (!messages[i]->tool_calls.empty()) {
+            while (end < pinnedFrom && messages[end]->getType() == Message::Type::ToolResult) {
+                ++end;
+            }
+        }
+        if (messages[i]->getType() != Message::Type::System) {
+            for (std::size_t k = i; k < end; ++k) {
+                dropped[k] = true;
+                total -= estimateTokens(*messages[k]);
+            }
+        }
+        i = end;
+    }
+    if (total > tokenBudget_) {
+        spdlog::warn("Context of ~{} tokens exceeds the budget of {} after dropping old turns",
+                     total, tokenBudget_);
+    }
+
+    std::vector<const Message*> selected;
+    selected.reserve(messages.size());
+    for (std::size_t k = 0; k < messages.size(); ++k) {
+        if (!dropped[k]) {
+            selected.push_back(messages[k]);
+        }
+    }
+    return selected;
+}
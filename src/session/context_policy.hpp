@@ -0,0 +1,62 @@
+// src/session/context_policy.hpp
+#pragma once
+#include "core/message.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Chooses which part of the conversation is sent with each request
+ *
+ * select() returns the messages for the next request, in conversation order.
+ * They may point into the conversation or at copies owned by the policy;
+ * either stays valid until the next call to select() or until the
+ * conversation changes.
+ */
+class ContextPolicy {
+public:
+    virtual ~ContextPolicy() = default;
+
+    virtual std::vector<const Message*> select(
+        const std::vector<std::unique_ptr<Message>>& conversation) = 0;
+};
+
+/**
+ * @brief Keeps requests under a token budget by dropping the oldest turns
+ *
+ * Token counts are estimated (about four bytes per token plus a small
+ * per-message overhead); no tokenizer is involved, so leave some headroom
+ * below the model's real limit.
+ *
+ * - System messages and everything from the last user message onwards are
+ *   always kept.
+ * - An assistant message with tool calls and the tool results answering it
+ *   are kept or dropped together, so the provider never sees half a pair.
+ * - Tool results longer than toolResultLimit tokens are replaced by a
+ *   truncated copy (0 = never truncate).  Copies are kept between calls so
+ *   the translator's serialization cache still applies to them.
+ * - Older units are dropped, oldest first, until the estimate fits.  If the
+ *   kept messages alone exceed the budget they are sent anyway.
+ */
+class TokenBudgetPolicy : public ContextPolicy {
+public:
+    explicit TokenBudgetPolicy(std::size_t tokenBudget, std::size_t toolResultLimit = 0);
+
+    std::vector<const Message*> select(
+        const std::vector<std::unique_ptr<Message>>& conversation) override;
+
+    static std::size_t estimateTokens(const Message& message);
+
+    std::size_t tokenBudget() const { return tokenBudget_; }
+    std::size_t toolResultLimit() const { return toolResultLimit_; }
+
+private:
+    const Message* truncated(const Message& message);
+
+    std::size_t tokenBudget_;
+    std::size_t toolResultLimit_;
+    // Truncated copies of oversized tool results, keyed by the original's id
+    std::unordered_map<std::uint64_t, std::unique_ptr<Message>> truncatedCopies_;
+};
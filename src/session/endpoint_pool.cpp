@@ -0,0 +1,212 @@
+// src/session/endpoint_pool.cpp
+#include "endpoint_pool.hpp"
+#include "exceptions/llm_exceptions.hpp"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <tuple>
+
+EndpointPool::Lease::Lease(EndpointPool* pool, std::size_t index, std::uint64_t generation, Endpoint endpoint)
+    : pool_(pool), index_(index), generation_(generation), endpoint_(std::move(endpoint)),
+      acquiredAt_(std::chrono::steady_clock::now()) {}
+
+EndpointPool::Lease::Lease(Lease&& other) noexcept
+    : pool_(other.pool_), index_(other.index_), generation_(other.generation_), endpoint_(std::move(other.endpoint_)),
+      acquiredAt_(other.acquiredAt_), outcome_(other.outcome_) {
+    other.pool_ = nullptr;
+}
+
+EndpointPool::Lease::~Lease() {
+    if (pool_) {
+        pool_->release(*this);
+    }
+}
+
+void EndpointPool::Lease::succeeded() {
+    if (pool_) {
+        pool_->complete(*this, std::chrono::steady_clock::now() - acquiredAt_);
+        pool_ = nullptr;
+        outcome_ = Outcome::Succeeded;
+    }
+}
+
+void EndpointPool::Lease::failed() {
+    if (pool_) {
+        pool_->complete(*this, std::nullopt);
+        pool_ = nullptr;
+        outcome_ = Outcome::Failed;
+    }
+}
+
+EndpointPool::EndpointPool() : EndpointPool(Options()) {}
+
+EndpointPool::EndpointPool(Options options) : options_(options) {}
+
+EndpointPool::EndpointPool(const EndpointPool& other) {
+    std::lock_guard<std::mutex> lock(other.mutex_);
+    options_ = other.options_;
+    slots_ = other.slots_;
+    generation_ = other.generation_;
+    next_ = other.next_;
+    for (auto& slot : slots_) {
+        slot.outstanding = 0;
+    }
+}
+
+void EndpointPool::add(Endpoint endpoint) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& slot : slots_) {
+        if (slot.endpoint.uri == endpoint.uri) {
+            slot.endpoint.apiKeyName = std::move(endpoint.apiKeyName);
+            return;
+        }
+    }
+    Slot slot;
+    slot.endpoint = std::move(endpoint);
+    slot.generation = generation_;
+    slots_.push_back(std::move(slot));
+}
+
+void EndpointPool::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    slots_.clear();
+    next_ = 0;
+    ++generation_;
+}
+
+void EndpointPool::setStrategy(Strategy strategy) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    options_.strategy = strategy;
+}
+
+std::size_t EndpointPool::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return slots_.size();
+}
+
+bool EndpointPool::empty() const {
+    return size() == 0;
+}
+
+EndpointPool::Lease EndpointPool::acquire(const std::vector<std::size_t>& tried) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (slots_.empty()) {
+        throw llm::LLMException("No endpoints in pool");
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    // Lower is better: available before ejected, untried before tried, then
+    // load; ejected endpoints are ranked by when they are due back
+    auto rank = [&](std::size_t index) {
+        const Slot& slot = slots_[index];
+        bool ejected = slot.ejectedUntil > now;
+        bool wasTried = std::find(tried.begin(), tried.end(), index) != tried.end();
+        double load;
+        if (ejected) {
+            load = static_cast<double>((slot.ejectedUntil - now).count());
+        } else if (options_.strategy == Strategy::Ewma) {
+            load = slot.latencyMicros * static_cast<double>(slot.outstanding + 1);
+        } else {
+            load = static_cast<double>(slot.outstanding);
+        }
+        return std::make_tuple(ejected, wasTried, load);
+    };
+
+    std::size_t best = next_ % slots_.size();
+    auto bestRank = rank(best);
+    for (std::size_t offset = 1; offset < slots_.size(); ++offset) {
+        std::size_t index = (next_ + offset) % slots_.size();
+        auto indexRank = rank(index);
+        if (indexRank < bestRank) {
+            best = index;
+            bestRank = indexRank;
+        }
+    }
+    next_ = best + 1;
+
+    Slot& slot = slots_[best];
+    if (std::get<0>(bestRank)) {
+        spdlog::warn("All endpoints ejected; using {}", slot.endpoint.uri);
+    }
+    ++slot.outstanding;
+    ++slot.requests;
+    return Lease(this, best, slot.generation, slot.endpoint);
+}
+
+std::vector<EndpointPool::EndpointStats> EndpointPool::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = std::chrono::steady_clock::now();
+    std::vector<EndpointStats> result;
+    result.reserve(slots_.size());
+    for (const auto& slot : slots_) {
+        EndpointStats stats;
+        stats.endpoint = slot.endpoint;
+        stats.outstanding = slot.outstanding;
+        stats.requests = slot.requests;
+        stats.failures = slot.failures;
+        stats.latency = std::chrono::microseconds(static_cast<std::int64_t>(slot.latencyMicros));
+        stats.ejected = slot.ejectedUntil > now;
+        result.push_back(std::move(stats));
+    }
+    return result;
+}
+
+std::optional<EndpointPool::Strategy> EndpointPool::parseStrategy(const std::string& name) {
+    if (name == "least-outstanding") {
+        return Strategy::LeastOutstanding;
+    }
+    if (name == "ewma") {
+        return Strategy::Ewma;
+    }
+    return std::nullopt;
+}
+
+EndpointPool::Slot* EndpointPool::slotFor(const Lease& lease) {
+    if (lease.index_ >= slots_.size() || slots_[lease.index_].generation != lease.generation_) {
+        return nullptr;
+    }
+    return &slots_[lease.index_];
+}
+
+void EndpointPool::complete(const Lease& lease, std::optional<std::chrono::steady_clock::duration> latency) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Slot* slot = slotFor(lease);
+    if (!slot) {
+        return;
+    }
+    --slot->outstanding;
+
+    if (latency) {
+        double sample = static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(*latency).count());
+        slot->latencyMicros = slot->latencyMicros == 0
+            ? sample
+            : options_.ewmaWeight * sample + (1 - options_.ewmaWeight) * slot->latencyMicros;
+        slot->consecutiveFailures = 0;
+        slot->ejections = 0;
+        return;
+    }
+
+    ++slot->failures;
+    auto now = std::chrono::steady_clock::now();
+    // Failures of requests sent before the ejection don't extend it
+    if (slot->ejectedUntil > now || ++slot->consecutiveFailures < options_.failureThreshold) {
+        return;
+    }
+    std::chrono::milliseconds duration = options_.ejection;
+    for (std::size_t i = 0; i < slot->ejections && duration < options_.maxEjection; ++i) {
+        duration *= 2;
+    }
+    duration = std::min(duration, options_.maxEjection);
+    ++slot->ejections;
+    slot->ejectedUntil = now + duration;
+    // On probation once re-admitted: one more failure ejects it again
+    slot->consecutiveFailures = options_.failureThreshold > 0 ? options_.failureThreshold - 1 : 0;
+    spdlog::warn("Ejecting endpoint {} for {} ms ({} failures so far)", slot->endpoint.uri, duration.count(),
+                 slot->failures);
+}
+
+void EndpointPool::release(const Lease& lease) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (Slot* slot = slotFor(lease)) {
+        --slot->outstanding;
+    }
+}
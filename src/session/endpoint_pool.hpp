@@ -0,0 +1,152 @@
+// src/session/endpoint_pool.hpp
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Spreads requests over a set of equivalent endpoints
+ *
+ * Each request takes a Lease on one endpoint and reports how it went.
+ * Endpoints are chosen by fewest requests in flight or by lowest latency
+ * (an exponentially weighted moving average, scaled by requests in flight);
+ * endpoints without a latency sample yet are tried first.  After
+ * failureThreshold failures in a row an endpoint is ejected for a while.
+ * Once that time is up it is re-admitted on probation: the next failure
+ * ejects it again for twice as long, a success clears its record.  When
+ * every endpoint is ejected the one due back soonest is used anyway.
+ *
+ * Thread safe, so one pool can be shared by all sessions of a run and see
+ * their combined load.
+ */
+class EndpointPool {
+public:
+    enum class Strategy {
+        LeastOutstanding,
+        Ewma
+    };
+
+    struct Options {
+        Strategy strategy = Strategy::LeastOutstanding;
+        std::size_t failureThreshold = 2;
+        std::chrono::milliseconds ejection{5000};
+        std::chrono::milliseconds maxEjection{120000};
+        // Weight of the newest latency sample in the average
+        double ewmaWeight = 0.3;
+    };
+
+    struct Endpoint {
+        std::string uri;
+        // Overrides the message's #API_KEY_NAME when set
+        std::optional<std::string> apiKeyName;
+    };
+
+    struct EndpointStats {
+        Endpoint endpoint;
+        std::size_t outstanding = 0;
+        std::uint64_t requests = 0;
+        std::uint64_t failures = 0;
+        std::chrono::microseconds latency{0};
+        bool ejected = false;
+    };
+
+    /**
+     * @brief One request's claim on an endpoint
+     *
+     * Report the outcome with succeeded() or failed().  A lease destroyed
+     * without either (e.g. the caller cancelled) only releases its slot.
+     */
+    class Lease {
+    public:
+        enum class Outcome {
+            Pending,
+            Succeeded,
+            Failed
+        };
+
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&&) = delete;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease();
+
+        const Endpoint& endpoint() const { return endpoint_; }
+        std::size_t index() const { return index_; }
+
+        // Only the first report counts
+        void succeeded();
+        void failed();
+        Outcome outcome() const { return outcome_; }
+
+    private:
+        friend class EndpointPool;
+        Lease(EndpointPool* pool, std::size_t index, std::uint64_t generation, Endpoint endpoint);
+
+        // Null once moved from or reported
+        EndpointPool* pool_;
+        std::size_t index_;
+        // The pool's generation when the lease was taken
+        std::uint64_t generation_;
+        Endpoint endpoint_;
+        std::chrono::steady_clock::time_point acquiredAt_;
+        Outcome outcome_ = Outcome::Pending;
+    };
+
+    EndpointPool();
+    explicit EndpointPool(Options options);
+    // Copies the endpoints, strategy and health records.  Requests in
+    // flight stay with the original, so nothing is outstanding in the copy.
+    EndpointPool(const EndpointPool& other);
+    EndpointPool& operator=(const EndpointPool&) = delete;
+
+    // Adding a URI that is already in the pool updates its key name
+    void add(Endpoint endpoint);
+    void clear();
+    void setStrategy(Strategy strategy);
+
+    std::size_t size() const;
+    bool empty() const;
+
+    // Endpoints whose index is in tried are only used when nothing else is
+    // available, so a retry goes elsewhere.  Throws if the pool is empty.
+    Lease acquire(const std::vector<std::size_t>& tried = {});
+
+    std::vector<EndpointStats> stats() const;
+
+    // "least-outstanding" or "ewma"
+    static std::optional<Strategy> parseStrategy(const std::string& name);
+
+private:
+    struct Slot {
+        Endpoint endpoint;
+        std::size_t outstanding = 0;
+        std::uint64_t requests = 0;
+        std::uint64_t failures = 0;
+        // Zero until the first success
+        double latencyMicros = 0;
+        std::size_t consecutiveFailures = 0;
+        // Ejections in a row; each one doubles the time out
+        std::size_t ejections = 0;
+        std::chrono::steady_clock::time_point ejectedUntil{};
+        // The pool's generation when the slot was added
+        std::uint64_t generation = 0;
+    };
+
+    // Null once the lease's endpoint has been removed by clear(), even if
+    // another endpoint has since been added at the same index
+    Slot* slotFor(const Lease& lease);
+    void complete(const Lease& lease, std::optional<std::chrono::steady_clock::duration> latency);
+    void release(const Lease& lease);
+
+    Options options_;
+    mutable std::mutex mutex_;
+    std::vector<Slot> slots_;
+    // Bumped by clear(), so leases on removed slots are told apart
+    std::uint64_t generation_ = 0;
+    // Where the search starts, so ties rotate
+    std::size_t next_ = 0;
+};
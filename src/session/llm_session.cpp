@@ -2,44 +2,175 @@
 #include "llm_session.hpp"
 #include "exceptions/llm_exceptions.hpp"
 #include "translator/openai_translator.hpp"
+#ifdef COLLOQUIUM_HAS_SIMDJSON
+#include "translator/simdjson_openai_translator.hpp"
+#endif
+#include "http_client/chunk_stream.hpp"
+#include "http_client/response_cache.hpp"
 #include <spdlog/spdlog.h>
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
+#include <sstream>
+
+namespace {
+
+// First block of a session's arena; later blocks grow geometrically
+constexpr std::size_t ARENA_INITIAL_SIZE = 16 * 1024;
+
+// Throttling and server errors count against an endpoint; other statuses
+// show it is up, even when the request itself was refused
+void reportOutcome(EndpointPool::Lease* lease, int statusCode) {
+    if (!lease) {
+        return;
+    }
+    if (statusCode == 429 || statusCode >= 500) {
+        lease->failed();
+    } else {
+        lease->succeeded();
+    }
+}
+
+} // namespace
 
 LLMSession::LLMSession(
-    std::unique_ptr<http_client::IHTTPClient> httpClient
+    std::shared_ptr<http_client::IHTTPClient> httpClient
 ) : httpClient_(std::move(httpClient)),
-    defaultMessage(Message(Message::Type::System)) {}
+    toolExecutor_(std::make_unique<ToolExecutor>()),
+    defaultConfig_(std::make_shared<RequestConfig>()) {}
+
+LLMSession::~LLMSession() {
+    // Messages may live in the arena
+    conversation_.clear();
+}
 
 void LLMSession::addTool(Tool tool) {
-    tools_.push_back(std::move(tool));
+    tools_.add(std::move(tool));
+}
+
+void LLMSession::setTokenCallback(ITranslator::TokenCallback callback) {
+    tokenCallback_ = std::move(callback);
+}
+
+void LLMSession::setIncrementalParsing(bool enabled) {
+    incrementalParsing_ = enabled;
+}
+
+void LLMSession::setOutput(std::ostream& output) {
+    output_ = &output;
+}
+
+void LLMSession::setContextPolicy(std::unique_ptr<ContextPolicy> policy) {
+    contextPolicy_ = std::move(policy);
+}
+
+void LLMSession::setApiKeyResolver(ApiKeyResolver resolver) {
+    apiKeyResolver_ = std::move(resolver);
+}
+
+void LLMSession::setCacheMode(CacheMode mode) {
+    cacheMode_ = mode;
+}
+
+RequestConfig& LLMSession::editDefaultConfig() {
+    // Messages already created keep pointing at the previous settings
+    auto config = std::make_shared<RequestConfig>(*defaultConfig_);
+    defaultConfig_ = config;
+    return *config;
+}
+
+void LLMSession::setEndpointPool(std::shared_ptr<EndpointPool> pool) {
+    endpointPool_ = std::move(pool);
+    ownsEndpointPool_ = false;
+}
+
+EndpointPool& LLMSession::editEndpointPool() {
+    if (!endpointPool_) {
+        endpointPool_ = std::make_shared<EndpointPool>();
+    } else if (!ownsEndpointPool_) {
+        endpointPool_ = std::make_shared<EndpointPool>(*endpointPool_);
+    }
+    ownsEndpointPool_ = true;
+    return *endpointPool_;
+}
+
+void LLMSession::setRequestTimeout(std::chrono::milliseconds timeout) {
+    requestTimeout_ = timeout;
+}
+
+http_client::RequestOptions LLMSession::requestOptions() const {
+    http_client::RequestOptions options = runOptions_;
+    if (requestTimeout_.count() > 0) {
+        auto deadline = std::chrono::steady_clock::now() + requestTimeout_;
+        if (!options.deadline || deadline < *options.deadline) {
+            options.deadline = deadline;
+        }
+    }
+    return options;
+}
+
+bool LLMSession::isCacheable(const Message& message) const {
+    const RequestConfig& config = message.getConfig();
+    if (config.stream.value_or(false)) {
+        return false;
+    }
+    switch (cacheMode_) {
+        case CacheMode::Always:
+            return true;
+        case CacheMode::Deterministic:
+            return config.random_seed.has_value() ||
+                   (config.temperature.has_value() && *config.temperature == 0.0);
+        case CacheMode::Off:
+        default:
+            return false;
+    }
+}
+
+void LLMSession::setToolWorkers(std::size_t workers) {
+    toolExecutor_ = std::make_unique<ToolExecutor>(workers);
+}
+
+void LLMSession::setArenaAllocation(bool enabled) {
+    arenaEnabled_ = enabled;
+    if (enabled && !arena_) {
+        arena_ = std::make_unique<std::pmr::monotonic_buffer_resource>(ARENA_INITIAL_SIZE);
+    }
 }
 
-std::string LLMSession::getApiKey(const Message& message) const {
+std::pmr::memory_resource* LLMSession::messageResource() const {
+    return arenaEnabled_ ? arena_.get() : nullptr;
+}
+
+std::string LLMSession::getApiKey(const std::optional<std::string>& apiKeyName) const {
     spdlog::debug("getApiKey");
-    if (!message.api_key_name) {
+    if (!apiKeyName) {
         throw llm::LLMException("No API_KEY_NAME specified in message");
     }
     
-    const char* apiKey = std::getenv(message.api_key_name->c_str());
+    if (apiKeyResolver_) {
+        return apiKeyResolver_(*apiKeyName);
+    }
+
+    const char* apiKey = std::getenv(apiKeyName->c_str());
     if (!apiKey) {
-        throw llm::LLMException(*message.api_key_name + " environment variable not set");
+        throw llm::LLMException(*apiKeyName + " environment variable not set");
     }
     return apiKey;
 }
 
-std::vector<std::string> LLMSession::createRequestHeaders(const Message& message) const {
-    std::string authHeader = "Authorization: Bearer " + getApiKey(message);
+std::vector<std::string> LLMSession::createRequestHeaders(const Message& message,
+                                                          const std::optional<std::string>& apiKeyName) const {
+    std::string authHeader = "Authorization: Bearer " + getApiKey(apiKeyName);
     return {
         "Content-Type: application/json",
-        "Accept: application/json",
+        message.getConfig().stream.value_or(false) ? "Accept: text/event-stream" : "Accept: application/json",
         authHeader
     };
 }
 
 void LLMSession::handleSystemMessage(const std::string& content) {
     spdlog::debug("handleSystemMessage");
-    auto message = std::make_unique<Message>(Message::Type::System);
+    auto message = Message::create(Message::Type::System, messageResource());
     message->content = content;
     conversation_.push_back(std::move(message));
 
@@ -51,8 +182,8 @@ void LLMSession::handleSystemMessage(const std::string& content) {
 
 void LLMSession::handleUserMessage(const std::string& content) {
     spdlog::debug("handleUserMessage");
-    auto message = std::make_unique<Message>(Message::Type::User);
-    defaultMessage.copyTo(*message);
+    auto message = Message::create(Message::Type::User, messageResource());
+    message->config = defaultConfig_;
     message->content = content;
     conversation_.push_back(std::move(message));
 
@@ -68,19 +199,87 @@ std::unique_ptr<Message> LLMSession::sendRequest() {
     // the last message *must* have all the details to make a request
     std::unique_ptr<Message>& lastMessage = conversation_.back();
     
-    if (!lastMessage->uri) {
+    bool usePool = endpointPool_ && !endpointPool_->empty();
+    const RequestConfig& config = lastMessage->getConfig();
+    if (!config.uri && !usePool) {
         throw llm::LLMException("No URI specified for API request");
     }
 
     if (!translator_) {
         throw llm::LLMException("No translator specified");
     }
+    translator_->setMemoryResource(messageResource());
 
-    std::string requestBody = translator_->createRequest(conversation_, tools_);
-    auto headers = createRequestHeaders(*lastMessage);
+    if (contextPolicy_) {
+        translator_->createRequest(contextPolicy_->select(conversation_), tools_, requestBuffer_);
+    } else {
+        translator_->createRequest(conversation_, tools_, requestBuffer_);
+    }
 
-    spdlog::debug("Sending request to {}", lastMessage->uri.value());
-    auto response = httpClient_->Post(lastMessage->uri.value(), requestBody, headers).get();
+    if (usePool) {
+        return sendToPool(*lastMessage);
+    }
+    return sendTo(*lastMessage, config.uri.value(), config.api_key_name, nullptr);
+}
+
+std::unique_ptr<Message> LLMSession::sendToPool(const Message& lastMessage) {
+    // A failed request is tried once on each other endpoint.  Streamed
+    // tokens already handed to the token callback cannot be taken back, so
+    // a stream that broke off is not retried; one that was refused with an
+    // error status never delivered any.
+    std::vector<std::size_t> tried;
+    while (true) {
+        auto lease = endpointPool_->acquire(tried);
+        tried.push_back(lease.index());
+        const auto& endpoint = lease.endpoint();
+        try {
+            return sendTo(lastMessage, endpoint.uri,
+                          endpoint.apiKeyName ? endpoint.apiKeyName : lastMessage.getConfig().api_key_name, &lease);
+        } catch (const llm::HTTPException& e) {
+            // Giving up on the caller's behalf is not the endpoint's fault
+            if (runOptions_.IsCancelled() || runOptions_.IsExpired()) {
+                throw;
+            }
+            bool brokeOff = lease.outcome() == EndpointPool::Lease::Outcome::Pending;
+            if (brokeOff) {
+                lease.failed();
+            }
+            if (lease.outcome() != EndpointPool::Lease::Outcome::Failed || tried.size() >= endpointPool_->size() ||
+                (brokeOff && lastMessage.getConfig().stream.value_or(false))) {
+                throw;
+            }
+            spdlog::warn("Request to {} failed, trying another endpoint: {}", endpoint.uri, e.what());
+        }
+    }
+}
+
+std::unique_ptr<Message> LLMSession::sendTo(
+    const Message& lastMessage,
+    const std::string& uri,
+    const std::optional<std::string>& apiKeyName,
+    EndpointPool::Lease* lease) {
+
+    const std::string& requestBody = requestBuffer_;
+    auto headers = createRequestHeaders(lastMessage, apiKeyName);
+    // Lets a caching or hedging transport answer or repeat this exact request
+    auto options = requestOptions();
+    options.idempotent = isCacheable(lastMessage);
+
+    if (lastMessage.getConfig().stream.value_or(false)) {
+        return sendChunkedRequest(uri, requestBody, headers, options, [this](std::istream& stream) {
+            return translator_->streamToMessage(stream, tokenCallback_);
+        }, lease);
+    }
+    if (incrementalParsing_) {
+        return sendChunkedRequest(uri, requestBody, headers, options, [this](std::istream& stream) {
+            return translator_->responseToMessage(stream);
+        }, lease);
+    }
+
+    spdlog::debug("Sending request to {}", uri);
+    auto sentAt = std::chrono::steady_clock::now();
+    auto response = httpClient_->Post(uri, requestBody, headers, options).get();
+    reportOutcome(lease, response.statusCode);
 
     if (response.statusCode != 200) {
         throw llm::HTTPException("Received error status code: " + 
@@ -92,44 +291,108 @@ std::unique_ptr<Message> LLMSession::sendRequest() {
         throw llm::TranslationException("Failed to parse the response.");
     }
 
+    recordTurn(*responseMessage, response, uri, sentAt);
     return responseMessage;
 }
 
+std::unique_ptr<Message> LLMSession::sendChunkedRequest(
+    const std::string& uri,
+    const std::string& requestBody,
+    const std::vector<std::string>& headers,
+    const http_client::RequestOptions& options,
+    const std::function<std::unique_ptr<Message>(std::istream&)>& parse,
+    EndpointPool::Lease* lease) {
+
+    spdlog::debug("Sending chunked request to {}", uri);
+    auto sentAt = std::chrono::steady_clock::now();
+    http_client::ChunkStream stream;
+    auto future = httpClient_->PostStreaming(uri, requestBody, headers, stream.Handler(), options);
+
+    // Parse on this thread while the transport is still receiving.  The
+    // transfer has to finish before the stream goes out of scope, so parse
+    // errors are held until the response status is known.
+    std::unique_ptr<Message> responseMessage;
+    std::exception_ptr parseError;
+    try {
+        responseMessage = parse(stream);
+    } catch (...) {
+        parseError = std::current_exception();
+    }
+
+    auto response = future.get();
+    reportOutcome(lease, response.statusCode);
+    if (response.statusCode != 200) {
+        throw llm::HTTPException("Received error status code: " +
+            std::to_string(response.statusCode) + "\nResponse body: " + response.body);
+    }
+    if (parseError) {
+        std::rethrow_exception(parseError);
+    }
+    if (!responseMessage) {
+        throw llm::TranslationException("Failed to parse the response.");
+    }
+
+    recordTurn(*responseMessage, response, uri, sentAt);
+    return responseMessage;
+}
+
+void LLMSession::recordTurn(const Message& response, const http_client::HTTPResponse& httpResponse,
+                            const std::string& uri, std::chrono::steady_clock::time_point sentAt) {
+    TurnMetrics metrics;
+    // The response is appended to the conversation right after this
+    metrics.conversationIndex = conversation_.size();
+    metrics.uri = uri;
+    metrics.streamed = conversation_.back()->getConfig().stream.value_or(false);
+    const ResponseMetadata& usage = response.getMetadata();
+    metrics.promptTokens = usage.prompt_tokens;
+    metrics.completionTokens = usage.completion_tokens;
+    metrics.totalTokens = usage.total_tokens;
+    metrics.transfer = httpResponse.timing;
+    metrics.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - sentAt);
+
+    const auto& t = metrics.transfer;
+    spdlog::debug("Turn {}: {} us total (dns {} connect {} tls {} ttfb {} transfer {} us, {} B up, {} B down{}), "
+                  "tokens {}/{}",
+                  turnMetrics_.size(), metrics.elapsed.count(), t.nameLookup.count(), t.connect.count(),
+                  t.tlsHandshake.count(), t.timeToFirstByte.count(), t.total.count(), t.bytesUploaded,
+                  t.bytesDownloaded, t.connectionReused ? ", reused" : "",
+                  metrics.promptTokens.value_or(0), metrics.completionTokens.value_or(0));
+    turnMetrics_.push_back(metrics);
+}
+
 void LLMSession::processToolCalls(const Message& response, 
     async_deque::AsyncDeque<std::unique_ptr<Message>>& cache) {
     
-    auto firstToolCall = response.tool_calls[0];
-    for (std::map<std::string, std::string> tool_call : response.tool_calls) {
-        std::string toolName = tool_call["name"];
-        std::cout << "Tool call: " << toolName << std::endl;
+    for (const auto& tool_call : response.tool_calls) {
+        *output_ << "Tool call: " << tool_call.name << std::endl;
     }
     spdlog::debug("processToolCalls");
-    for (const auto& tool_call : response.tool_calls) {
-        auto toolNameIt = tool_call.find("name");
-        auto toolCallIdIt = tool_call.find("id");
-        auto toolArgsIt = tool_call.find("arguments");
 
-        if (toolNameIt == tool_call.end() || toolCallIdIt == tool_call.end() || 
-            toolArgsIt == tool_call.end()) {
-            throw llm::LLMException("Invalid tool call format");
+    // Resolve every call before running any, so a bad call fails the turn
+    // without side effects
+    std::vector<ToolExecutor::Call> calls;
+    calls.reserve(response.tool_calls.size());
+    for (const auto& tool_call : response.tool_calls) {
+        const ToolRegistry::Entry* entry = tools_.find(tool_call.name);
+        if (!entry) {
+            throw llm::LLMException("Tool not found: " + std::string(tool_call.name));
         }
 
-        auto toolIt = std::find_if(tools_.begin(), tools_.end(),
-            [&toolName = toolNameIt->second](const Tool& tool) { 
-                return tool.name == toolName; 
-            });
+        calls.push_back(ToolExecutor::Call{&entry->tool, std::string(tool_call.arguments)});
+    }
 
-        if (toolIt == tools_.end()) {
-            throw llm::LLMException("Tool not found: " + toolNameIt->second);
-        }
+    // Independent calls run concurrently; results come back in call order
+    std::vector<std::string> toolResults = toolExecutor_->run(std::move(calls));
 
-        std::string toolResult = toolIt->function(toolArgsIt->second);
+    for (std::size_t i = 0; i < response.tool_calls.size(); ++i) {
+        const auto& tool_call = response.tool_calls[i];
 
-        auto resultMessage = std::make_unique<Message>(Message::Type::ToolResult);
-        defaultMessage.copyTo(*resultMessage);
-        resultMessage->content = toolResult;
-        resultMessage->name = toolNameIt->second;
-        resultMessage->tool_call_id = toolCallIdIt->second;
+        auto resultMessage = Message::create(Message::Type::ToolResult, messageResource());
+        resultMessage->config = defaultConfig_;
+        resultMessage->content = toolResults[i];
+        resultMessage->name.emplace(tool_call.name, resultMessage->get_allocator());
+        resultMessage->tool_call_id.emplace(tool_call.id, resultMessage->get_allocator());
         
         cache.push_back(std::move(resultMessage));
 
@@ -140,8 +403,9 @@ void LLMSession::processToolCalls(const Message& response,
     }
 }
 
-void LLMSession::processMessages(Source& source) {
+void LLMSession::processMessages(Source& source, const http_client::RequestOptions& options) {
     spdlog::debug("processMessages");
+    runOptions_ = options;
     async_deque::AsyncDeque<std::unique_ptr<Message>> cache;
 
     while (true) {
@@ -175,23 +439,138 @@ void LLMSession::processMessages(Source& source) {
                 constexpr std::string_view API_KEY_NAME_CMD = "#API_KEY_NAME ";
                 constexpr std::string_view MODEL_CMD = "#MODEL ";
                 constexpr std::string_view TRANSLATOR_CMD = "#TRANSLATOR ";
+                constexpr std::string_view STREAM_CMD = "#STREAM ";
+                constexpr std::string_view INCREMENTAL_PARSE_CMD = "#INCREMENTAL_PARSE ";
+                constexpr std::string_view TOOL_WORKERS_CMD = "#TOOL_WORKERS ";
+                constexpr std::string_view ARENA_CMD = "#ARENA ";
+                constexpr std::string_view TOOLS_CMD = "#TOOLS ";
+                constexpr std::string_view CONTEXT_BUDGET_CMD = "#CONTEXT_BUDGET ";
+                constexpr std::string_view TOOL_RESULT_LIMIT_CMD = "#TOOL_RESULT_LIMIT ";
+                constexpr std::string_view CACHE_CMD = "#CACHE ";
+                constexpr std::string_view REQUEST_TIMEOUT_CMD = "#REQUEST_TIMEOUT ";
+                constexpr std::string_view ENDPOINT_CMD = "#ENDPOINT ";
+                constexpr std::string_view BALANCE_CMD = "#BALANCE ";
                 if (prompt->find(URI_CMD) == 0) {
-                    defaultMessage.uri = prompt->substr(URI_CMD.length());
-                    spdlog::debug("URI set to {}", defaultMessage.uri.value());
+                    editDefaultConfig().uri = prompt->substr(URI_CMD.length());
+                    spdlog::debug("URI set to {}", defaultConfig_->uri.value());
                 } else if (prompt->find(API_KEY_NAME_CMD) == 0) {
-                    defaultMessage.api_key_name = prompt->substr(API_KEY_NAME_CMD.length());
-                    spdlog::debug("API_KEY_NAME set to {}", defaultMessage.api_key_name.value());
+                    editDefaultConfig().api_key_name = prompt->substr(API_KEY_NAME_CMD.length());
+                    spdlog::debug("API_KEY_NAME set to {}", defaultConfig_->api_key_name.value());
                 } else if (prompt->find(MODEL_CMD) == 0) {
-                    defaultMessage.model = prompt->substr(MODEL_CMD.length());
-                    spdlog::debug("MODEL set to {}", defaultMessage.model.value());
+                    editDefaultConfig().model = prompt->substr(MODEL_CMD.length());
+                    spdlog::debug("MODEL set to {}", defaultConfig_->model.value());
                 } else if (prompt->find(TRANSLATOR_CMD) == 0) {
                     std::string translatorName = prompt->substr(TRANSLATOR_CMD.length());
                     if (translatorName == "openai") {
                         translator_ = std::make_unique<OpenAITranslator>();
+#ifdef COLLOQUIUM_HAS_SIMDJSON
+                    } else if (translatorName == "openai-simdjson") {
+                        translator_ = std::make_unique<SimdjsonOpenAITranslator>();
+#endif
                     } else {
                         throw llm::LLMException("Unknown translator: " + translatorName);
                     }
                     spdlog::debug("Translator set to {}", translatorName);
+                } else if (prompt->find(STREAM_CMD) == 0) {
+                    std::string value = prompt->substr(STREAM_CMD.length());
+                    editDefaultConfig().stream = value == "on" || value == "true";
+                    spdlog::debug("STREAM set to {}", defaultConfig_->stream.value());
+                } else if (prompt->find(INCREMENTAL_PARSE_CMD) == 0) {
+                    std::string value = prompt->substr(INCREMENTAL_PARSE_CMD.length());
+                    setIncrementalParsing(value == "on" || value == "true");
+                    spdlog::debug("INCREMENTAL_PARSE set to {}", incrementalParsing_);
+                } else if (prompt->find(TOOL_WORKERS_CMD) == 0) {
+                    std::string value = prompt->substr(TOOL_WORKERS_CMD.length());
+                    try {
+                        setToolWorkers(std::stoul(value));
+                    } catch (const std::logic_error&) {
+                        throw llm::LLMException("Invalid TOOL_WORKERS value: " + value);
+                    }
+                    spdlog::debug("TOOL_WORKERS set to {}", toolExecutor_->workerCount());
+                } else if (prompt->find(TOOLS_CMD) == 0) {
+                    std::string value = prompt->substr(TOOLS_CMD.length());
+                    if (value == "all") {
+                        editDefaultConfig().tools.reset();
+                    } else {
+                        std::vector<std::string> names;
+                        std::istringstream list(value == "none" ? "" : value);
+                        for (std::string name; std::getline(list, name, ',');) {
+                            if (!name.empty()) {
+                                names.push_back(std::move(name));
+                            }
+                        }
+                        editDefaultConfig().tools = std::move(names);
+                    }
+                    spdlog::debug("TOOLS set to {}", value);
+                } else if (prompt->find(ARENA_CMD) == 0) {
+                    std::string value = prompt->substr(ARENA_CMD.length());
+                    setArenaAllocation(value == "on" || value == "true");
+                    spdlog::debug("ARENA set to {}", arenaEnabled_);
+                } else if (prompt->find(CONTEXT_BUDGET_CMD) == 0 || prompt->find(TOOL_RESULT_LIMIT_CMD) == 0) {
+                    // Both adjust the token budget policy; 0 turns a limit off
+                    bool isBudget = prompt->find(CONTEXT_BUDGET_CMD) == 0;
+                    std::string value = prompt->substr(isBudget ? CONTEXT_BUDGET_CMD.length()
+                                                                : TOOL_RESULT_LIMIT_CMD.length());
+                    std::size_t tokens = 0;
+                    try {
+                        tokens = value == "off" ? 0 : std::stoul(value);
+                    } catch (const std::logic_error&) {
+                        throw llm::LLMException("Invalid token limit: " + value);
+                    }
+                    auto* current = dynamic_cast<TokenBudgetPolicy*>(contextPolicy_.get());
+                    std::size_t budget = isBudget ? tokens : (current ? current->tokenBudget() : 0);
+                    std::size_t toolResultLimit = isBudget ? (current ? current->toolResultLimit() : 0) : tokens;
+                    if (budget == 0 && toolResultLimit == 0) {
+                        setContextPolicy(nullptr);
+                    } else {
+                        setContextPolicy(std::make_unique<TokenBudgetPolicy>(budget, toolResultLimit));
+                    }
+                    spdlog::debug("Context budget {} tokens, tool result limit {} tokens", budget, toolResultLimit);
+                } else if (prompt->find(CACHE_CMD) == 0) {
+                    std::string value = prompt->substr(CACHE_CMD.length());
+                    if (value == "auto") {
+                        setCacheMode(CacheMode::Deterministic);
+                    } else if (value == "on" || value == "true") {
+                        setCacheMode(CacheMode::Always);
+                    } else if (value == "off" || value == "false") {
+                        setCacheMode(CacheMode::Off);
+                    } else {
+                        throw llm::LLMException("Invalid CACHE value: " + value);
+                    }
+                    spdlog::debug("CACHE set to {}", value);
+                } else if (prompt->find(REQUEST_TIMEOUT_CMD) == 0) {
+                    std::string value = prompt->substr(REQUEST_TIMEOUT_CMD.length());
+                    try {
+                        setRequestTimeout(std::chrono::milliseconds(value == "off" ? 0 : std::stol(value)));
+                    } catch (const std::logic_error&) {
+                        throw llm::LLMException("Invalid REQUEST_TIMEOUT value: " + value);
+                    }
+                    spdlog::debug("REQUEST_TIMEOUT set to {} ms", requestTimeout_.count());
+                } else if (prompt->find(ENDPOINT_CMD) == 0) {
+                    // "#ENDPOINT <uri> [<api key name>]" or "#ENDPOINT clear"
+                    std::istringstream fields(prompt->substr(ENDPOINT_CMD.length()));
+                    EndpointPool::Endpoint endpoint;
+                    std::string apiKeyName;
+                    fields >> endpoint.uri >> apiKeyName;
+                    if (endpoint.uri == "clear") {
+                        editEndpointPool().clear();
+                    } else if (endpoint.uri.empty()) {
+                        throw llm::LLMException("ENDPOINT needs a URI");
+                    } else {
+                        if (!apiKeyName.empty()) {
+                            endpoint.apiKeyName = apiKeyName;
+                        }
+                        editEndpointPool().add(endpoint);
+                    }
+                    spdlog::debug("ENDPOINT {}; {} in pool", endpoint.uri, endpointPool_->size());
+                } else if (prompt->find(BALANCE_CMD) == 0) {
+                    std::string value = prompt->substr(BALANCE_CMD.length());
+                    auto strategy = EndpointPool::parseStrategy(value);
+                    if (!strategy) {
+                        throw llm::LLMException("Invalid BALANCE value: " + value);
+                    }
+                    editEndpointPool().setStrategy(*strategy);
+                    spdlog::debug("BALANCE set to {}", value);
                 }
                 continue;
             } else {
@@ -200,22 +579,18 @@ void LLMSession::processMessages(Source& source) {
         }
 
         // Send the request with current conversation state
-        std::cout << "Request:  " << conversation_.back()->content << std::endl;
+        *output_ << "Request:  " << conversation_.back()->content << std::endl;
         auto responseMessage = sendRequest();
-        std::cout << "Response:  " << responseMessage->content << std::endl;
+        *output_ << "Response:  " << responseMessage->content << std::endl;
         
         if (responseMessage->tool_calls.empty()) {
             conversation_.push_back(std::move(responseMessage));
         } else {
-            // make a copy for conversation
-            std::unique_ptr<Message> responseMessageCopy = std::make_unique<Message>(*responseMessage);
-            conversation_.push_back(std::move(responseMessageCopy));
-            processToolCalls(*responseMessage, cache);
-
-            // sanity checks
-            if (responseMessageCopy.get() != nullptr) {
-                std::cerr << "Dangling Response Copy: " << responseMessageCopy->content << std::endl;
-            }
+            // The conversation owns the response; the pointer stays valid
+            // while its tool calls run
+            const Message& response = *responseMessage;
+            conversation_.push_back(std::move(responseMessage));
+            processToolCalls(response, cache);
         }
 
         // sanity checks
@@ -229,3 +604,7 @@ void LLMSession::processMessages(Source& source) {
 const std::vector<std::unique_ptr<Message>>& LLMSession::getConversation() const {
     return conversation_;
 }
+
+const std::vector<TurnMetrics>& LLMSession::getTurnMetrics() const {
+    return turnMetrics_;
+}
@@ -4,17 +4,36 @@
 #include "translator/itranslator.hpp"
 #include "http_client/ihttp_client.hpp"
 #include "core/message.hpp"
-#include "core/tool.hpp"
+#include "core/tool_registry.hpp"
 #include "core/source.hpp"
+#include "tool_executor.hpp"
+#include "context_policy.hpp"
+#include "endpoint_pool.hpp"
+#include "turn_metrics.hpp"
 #include <async_deque/async_deque.hpp>
+#include <functional>
+#include <iostream>
 #include <memory>
+#include <memory_resource>
 #include <string>
 #include <vector>
 
 class LLMSession {
 public:
+    // Which requests are marked idempotent, making them safe to answer from
+    // a response cache or to hedge (#CACHE auto|on|off)
+    enum class CacheMode {
+        Off,
+        Deterministic,  // random_seed set or temperature 0 (default)
+        Always
+    };
+
+    // Maps an #API_KEY_NAME to the key itself
+    using ApiKeyResolver = std::function<std::string(const std::string& name)>;
+
+    // The transport may be shared by many sessions running concurrently
     LLMSession(
-        std::unique_ptr<http_client::IHTTPClient> httpClient
+        std::shared_ptr<http_client::IHTTPClient> httpClient
     );
 
     // Prevent copying
@@ -25,13 +44,62 @@ public:
     LLMSession(LLMSession&&) = default;
     LLMSession& operator=(LLMSession&&) = default;
 
+    ~LLMSession();
+
     // Main interface
+    // Replaces a tool of the same name.  All tools are offered unless
+    // #TOOLS name,... (or #TOOLS none) narrows the set; #TOOLS all undoes it.
     void addTool(Tool tool);
-    void processMessages(Source& source);
+    // options applies to every request of the run: its deadline bounds the
+    // whole run and cancelling its token aborts the request in flight
+    void processMessages(Source& source, const http_client::RequestOptions& options = {});
+
+    // Called with each content token of streamed (#STREAM on) responses
+    void setTokenCallback(ITranslator::TokenCallback callback);
+
+    // Parse non-streamed responses while they are being received instead of
+    // after the whole body has arrived (#INCREMENTAL_PARSE on)
+    void setIncrementalParsing(bool enabled);
+
+    // Limits what part of the conversation each request carries; nullptr
+    // sends everything (#CONTEXT_BUDGET n, #TOOL_RESULT_LIMIT n)
+    void setContextPolicy(std::unique_ptr<ContextPolicy> policy);
+
+    void setCacheMode(CacheMode mode);
+
+    // Deadline for each request, counted from when it is sent; zero means
+    // none (#REQUEST_TIMEOUT ms|off)
+    void setRequestTimeout(std::chrono::milliseconds timeout);
+
+    // Requests go to the pool's endpoints instead of #URI while it is not
+    // empty.  The pool may be shared with other sessions, so #ENDPOINT uri
+    // [api key name], #ENDPOINT clear and #BALANCE least-outstanding|ewma
+    // change a copy of it that only this session uses.
+    void setEndpointPool(std::shared_ptr<EndpointPool> pool);
+
+    // Replaces the default lookup of API keys in the environment, e.g. for
+    // replaying recorded sessions without credentials
+    void setApiKeyResolver(ApiKeyResolver resolver);
+
+    // Where requests, responses and tool calls are echoed (default std::cout)
+    void setOutput(std::ostream& output);
+
+    // Size of the pool that runs a response's tool calls concurrently
+    // (#TOOL_WORKERS n, default 4)
+    void setToolWorkers(std::size_t workers);
+
+    // Allocates the session's messages, text and tool calls included, from
+    // an arena that is released in one piece with the session instead of
+    // message by message (#ARENA on|off).  Turning it off only affects
+    // messages created afterwards.
+    void setArenaAllocation(bool enabled);
 
     // Access to conversation history
     const std::vector<std::unique_ptr<Message>>& getConversation() const;
 
+    // One entry per response received, in order
+    const std::vector<TurnMetrics>& getTurnMetrics() const;
+
 private:
 
     // Helper methods for message processing
@@ -42,16 +110,69 @@ private:
         async_deque::AsyncDeque<std::unique_ptr<Message>>& cache
     );
     std::unique_ptr<Message> sendRequest();
+    std::unique_ptr<Message> sendToPool(const Message& lastMessage);
+    // lease, when given, is told whether the endpoint answered properly
+    std::unique_ptr<Message> sendTo(
+        const Message& lastMessage,
+        const std::string& uri,
+        const std::optional<std::string>& apiKeyName,
+        EndpointPool::Lease* lease
+    );
+    std::unique_ptr<Message> sendChunkedRequest(
+        const std::string& uri,
+        const std::string& requestBody,
+        const std::vector<std::string>& headers,
+        const http_client::RequestOptions& options,
+        const std::function<std::unique_ptr<Message>(std::istream&)>& parse,
+        EndpointPool::Lease* lease
+    );
+
+    void recordTurn(const Message& response, const http_client::HTTPResponse& httpResponse,
+                    const std::string& uri, std::chrono::steady_clock::time_point sentAt);
+
+    RequestConfig& editDefaultConfig();
+
+    // The arena while arena allocation is on, else nullptr
+    std::pmr::memory_resource* messageResource() const;
 
     // API communication helpers
-    std::string getApiKey(const Message& message) const;
-    std::vector<std::string> createRequestHeaders(const Message& message) const;
+    http_client::RequestOptions requestOptions() const;
+    // The pool that directives change; copied first if it may be shared
+    EndpointPool& editEndpointPool();
+    bool isCacheable(const Message& message) const;
+    std::string getApiKey(const std::optional<std::string>& apiKeyName) const;
+    std::vector<std::string> createRequestHeaders(const Message& message,
+                                                  const std::optional<std::string>& apiKeyName) const;
 
     // Member variables
     std::vector<std::unique_ptr<Message>> conversation_;
-    std::vector<Tool> tools_;
+    std::vector<TurnMetrics> turnMetrics_;
+    ToolRegistry tools_;
     std::unique_ptr<ITranslator> translator_;
-    std::unique_ptr<http_client::IHTTPClient> httpClient_;
+    std::shared_ptr<http_client::IHTTPClient> httpClient_;
+    std::unique_ptr<ToolExecutor> toolExecutor_;
+    std::unique_ptr<ContextPolicy> contextPolicy_;
+    ITranslator::TokenCallback tokenCallback_;
+    bool incrementalParsing_ = false;
+    std::ostream* output_ = &std::cout;
+    CacheMode cacheMode_ = CacheMode::Deterministic;
+    ApiKeyResolver apiKeyResolver_;
+    std::shared_ptr<EndpointPool> endpointPool_;
+    // False while endpointPool_ is the one given to setEndpointPool
+    bool ownsEndpointPool_ = false;
+    std::chrono::milliseconds requestTimeout_{0};
+    // Options of the processMessages call in progress
+    http_client::RequestOptions runOptions_;
+
+    bool arenaEnabled_ = false;
+    // Declared after conversation_ so that a move assignment releases the
+    // old messages before their arena; the destructor does the same
+    std::unique_ptr<std::pmr::monotonic_buffer_resource> arena_;
+
+    // Reused across turns so request bodies don't reallocate every time
+    std::string requestBuffer_;
 
-    Message defaultMessage;
+    // Settings given to new messages.  Shared with them, so a directive
+    // replaces it instead of modifying it.
+    std::shared_ptr<const RequestConfig> defaultConfig_;
 };
@@ -0,0 +1,140 @@
+// src/session/tool_executor.cpp
+#include "tool_executor.hpp"
+#include "exceptions/llm_exceptions.hpp"
+
+ToolExecutor::ToolExecutor(std::size_t workers) {
+    if (workers == 0) {
+        throw llm::LLMException("Tool executor needs at least one worker");
+    }
+    workers_.reserve(workers);
+    for (std::size_t i = 0; i < workers; ++i) {
+        workers_.emplace_back(&ToolExecutor::workerLoop, this);
+    }
+}
+
+ToolExecutor::~ToolExecutor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    queueChanged_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+std::vector<std::string> ToolExecutor::run(std::vector<Call> calls) {
+    std::vector<std::shared_ptr<Job>> jobs;
+    jobs.reserve(calls.size());
+    for (auto& call : calls) {
+        auto job = std::make_shared<Job>();
+        job->toolName = call.tool->name;
+        job->function = call.tool->function;
+        job->arguments = std::move(call.arguments);
+        job->maxConcurrency = call.tool->max_concurrency;
+        job->timeout = call.tool->timeout;
+        jobs.push_back(std::move(job));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.insert(queue_.end(), jobs.begin(), jobs.end());
+    }
+    queueChanged_.notify_all();
+
+    std::vector<std::string> results;
+    results.reserve(jobs.size());
+    std::exception_ptr firstError;
+    for (const auto& job : jobs) {
+        try {
+            results.push_back(waitFor(*job));
+        } catch (...) {
+            if (!firstError) {
+                firstError = std::current_exception();
+            }
+            results.emplace_back();
+        }
+    }
+    if (firstError) {
+        std::rethrow_exception(firstError);
+    }
+    return results;
+}
+
+std::string ToolExecutor::waitFor(Job& job) {
+    std::unique_lock<std::mutex> lock(job.mutex);
+    if (job.timeout.count() == 0) {
+        job.done.wait(lock, [&job]() { return job.finished; });
+    } else {
+        // The deadline only exists once a worker has picked the call up
+        job.done.wait(lock, [&job]() { return job.started; });
+        bool finished = job.done.wait_until(lock, job.startedAt + job.timeout,
+                                            [&job]() { return job.finished; });
+        if (!finished) {
+            return "Error: tool " + job.toolName + " timed out after " +
+                   std::to_string(job.timeout.count()) + " ms";
+        }
+    }
+    if (job.error) {
+        std::rethrow_exception(job.error);
+    }
+    return std::move(job.result);
+}
+
+std::shared_ptr<ToolExecutor::Job> ToolExecutor::takeRunnableJob(std::unique_lock<std::mutex>& lock) {
+    for (;;) {
+        if (stopping_) {
+            return nullptr;
+        }
+        for (auto it = queue_.begin(); it != queue_.end(); ++it) {
+            const auto& job = *it;
+            std::size_t& running = running_[job->toolName];
+            if (job->maxConcurrency == 0 || running < job->maxConcurrency) {
+                ++running;
+                auto taken = std::move(*it);
+                queue_.erase(it);
+                return taken;
+            }
+        }
+        queueChanged_.wait(lock);
+    }
+}
+
+void ToolExecutor::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        auto job = takeRunnableJob(lock);
+        if (!job) {
+            return;
+        }
+        lock.unlock();
+
+        {
+            std::lock_guard<std::mutex> jobLock(job->mutex);
+            job->started = true;
+            job->startedAt = std::chrono::steady_clock::now();
+        }
+        job->done.notify_all();
+
+        std::string result;
+        std::exception_ptr error;
+        try {
+            result = job->function(job->arguments);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> jobLock(job->mutex);
+            job->result = std::move(result);
+            job->error = error;
+            job->finished = true;
+        }
+        job->done.notify_all();
+
+        lock.lock();
+        --running_[job->toolName];
+        // A slot for this tool opened up; queued calls of it may now run
+        queueChanged_.notify_all();
+    }
+}
@@ -0,0 +1,75 @@
+// src/session/tool_executor.hpp
+#pragma once
+#include "core/tool.hpp"
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Bounded worker pool that runs a turn's tool calls concurrently
+ *
+ * run() dispatches every call at once and returns the outputs in the order
+ * the calls were given.  Tool::max_concurrency caps how many calls of one
+ * tool run at the same time; further calls of that tool wait in the queue
+ * while other tools proceed.  Tool::timeout is measured from when a call
+ * starts running: a call that overruns is reported as an error string and
+ * left to finish on its worker, since a running std::function cannot be
+ * interrupted.  The destructor waits for such calls.
+ *
+ * If a tool throws, run() waits for the remaining calls and rethrows the
+ * first exception in call order.
+ */
+class ToolExecutor {
+public:
+    struct Call {
+        const Tool* tool;
+        std::string arguments;
+    };
+
+    explicit ToolExecutor(std::size_t workers = 4);
+    ~ToolExecutor();
+
+    ToolExecutor(const ToolExecutor&) = delete;
+    ToolExecutor& operator=(const ToolExecutor&) = delete;
+
+    // Takes the calls by value so their arguments move into the jobs
+    std::vector<std::string> run(std::vector<Call> calls);
+
+    std::size_t workerCount() const { return workers_.size(); }
+
+private:
+    // Shared with the worker so a timed-out call can outlive run()
+    struct Job {
+        std::string toolName;
+        std::function<std::string(const std::string&)> function;
+        std::string arguments;
+        std::size_t maxConcurrency;
+        std::chrono::milliseconds timeout;
+
+        std::mutex mutex;
+        std::condition_variable done;
+        bool started = false;
+        bool finished = false;
+        std::chrono::steady_clock::time_point startedAt;
+        std::string result;
+        std::exception_ptr error;
+    };
+
+    void workerLoop();
+    std::shared_ptr<Job> takeRunnableJob(std::unique_lock<std::mutex>& lock);
+    static std::string waitFor(Job& job);
+
+    std::mutex mutex_;
+    std::condition_variable queueChanged_;
+    std::deque<std::shared_ptr<Job>> queue_;
+    // Calls currently running, per tool name
+    std::unordered_map<std::string, std::size_t> running_;
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+};
@@ -0,0 +1,29 @@
+// src/session/turn_metrics.hpp
+#pragma once
+#include "http_client/http_response.hpp"
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <string>
+
+/**
+ * @brief What one request/response turn of a session cost
+ *
+ * Token counts come from the provider's usage report; transfer is the
+ * transport's breakdown of the HTTP exchange (all zeros when it was served
+ * without the network).  elapsed is measured by the session from sending
+ * the request to having the parsed response, so elapsed - transfer.total
+ * is roughly the time spent outside the transport.
+ */
+struct TurnMetrics {
+    // Position of the response in the conversation
+    std::size_t conversationIndex = 0;
+    // Endpoint that answered; differs between turns when a pool is in use
+    std::string uri;
+    bool streamed = false;
+    std::optional<int> promptTokens;
+    std::optional<int> completionTokens;
+    std::optional<int> totalTokens;
+    http_client::TransferTiming transfer;
+    std::chrono::microseconds elapsed{0};
+};
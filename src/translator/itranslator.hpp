@@ -1,15 +1,70 @@
 #pragma once
 #include "core/message.hpp"
-#include "core/tool.hpp"
+#include "core/tool_registry.hpp"
 #include "exceptions/llm_exceptions.hpp"
+#include <functional>
+#include <istream>
+#include <iterator>
 #include <memory>
+#include <memory_resource>
 #include <string>
 #include <vector>
 
 class ITranslator {
 public:
+    // Receives each piece of assistant text as it is streamed in
+    using TokenCallback = std::function<void(const std::string& token)>;
+
     virtual ~ITranslator() = default;
+    // Serializes the request into out, replacing its contents but keeping
+    // its capacity, so callers can reuse one buffer across requests.  Takes
+    // the messages by pointer so a context policy can send a subset of the
+    // conversation, or substitute shortened copies, without moving ownership.
+    // The last user message's RequestConfig::tools picks which of the
+    // registered tools are offered.
+    virtual void createRequest(const std::vector<const Message*>& messages,
+                               const ToolRegistry& tools,
+                               std::string& out) const noexcept(false) = 0;
+
+    virtual void createRequest(const std::vector<std::unique_ptr<Message>>& messages,
+                               const ToolRegistry& tools,
+                               std::string& out) const noexcept(false) {
+        std::vector<const Message*> view;
+        view.reserve(messages.size());
+        for (const auto& message : messages) {
+            view.push_back(message.get());
+        }
+        createRequest(view, tools, out);
+    }
+
     virtual std::string createRequest(const std::vector<std::unique_ptr<Message>>& messages,
-                                      const std::vector<Tool>& tools) const noexcept(false) = 0;
+                                      const ToolRegistry& tools) const noexcept(false) {
+        std::string out;
+        createRequest(messages, tools, out);
+        return out;
+    }
     virtual std::unique_ptr<Message> responseToMessage(const std::string& json) const noexcept(false) = 0;
+
+    // Parses a response read incrementally from stream, e.g. a ChunkStream
+    // fed by the transport while the body is still arriving.  The default
+    // reads the whole stream and defers to the string overload.
+    virtual std::unique_ptr<Message> responseToMessage(std::istream& stream) const noexcept(false) {
+        std::string json((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+        return responseToMessage(json);
+    }
+
+    // Reads a streamed (stream: true) response, calling onToken for every
+    // content delta, and returns the assembled message once the stream ends
+    virtual std::unique_ptr<Message> streamToMessage(std::istream& stream,
+                                                     const TokenCallback& onToken) const noexcept(false) = 0;
+
+    // Where response messages are allocated, e.g. a session's arena; nullptr
+    // (the default) uses the heap
+    void setMemoryResource(std::pmr::memory_resource* resource) { memoryResource_ = resource; }
+
+protected:
+    std::pmr::memory_resource* memoryResource() const { return memoryResource_; }
+
+private:
+    std::pmr::memory_resource* memoryResource_ = nullptr;
 };
@@ -0,0 +1,216 @@
+// src/translator/json_writer.cpp
+#include "json_writer.hpp"
+#include "exceptions/llm_exceptions.hpp"
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+JsonWriter::JsonWriter(std::string& out) : out_(out) {}
+
+void JsonWriter::beforeValue() {
+    if (afterKey_) {
+        afterKey_ = false;
+        return;
+    }
+    if (!hasElements_.empty()) {
+        if (hasElements_.back()) {
+            out_ += ',';
+        }
+        hasElements_.back() = true;
+    }
+}
+
+void JsonWriter::beginObject() {
+    beforeValue();
+    out_ += '{';
+    hasElements_.push_back(false);
+}
+
+void JsonWriter::endObject() {
+    out_ += '}';
+    hasElements_.pop_back();
+}
+
+void JsonWriter::beginArray() {
+    beforeValue();
+    out_ += '[';
+    hasElements_.push_back(false);
+}
+
+void JsonWriter::endArray() {
+    out_ += ']';
+    hasElements_.pop_back();
+}
+
+void JsonWriter::key(std::string_view name) {
+    beforeValue();
+    appendEscaped(out_, name);
+    out_ += ':';
+    afterKey_ = true;
+}
+
+void JsonWriter::value(std::string_view text) {
+    beforeValue();
+    appendEscaped(out_, text);
+}
+
+void JsonWriter::value(const char* text) {
+    value(std::string_view(text));
+}
+
+void JsonWriter::value(bool flag) {
+    beforeValue();
+    out_ += flag ? "true" : "false";
+}
+
+void JsonWriter::value(int number) {
+    value(static_cast<long long>(number));
+}
+
+void JsonWriter::value(long long number) {
+    beforeValue();
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), number);
+    out_.append(buffer, result.ptr);
+}
+
+void JsonWriter::value(double number) {
+    beforeValue();
+    appendDouble(out_, number);
+}
+
+void JsonWriter::raw(std::string_view json) {
+    beforeValue();
+    out_ += json;
+}
+
+void JsonWriter::appendEscaped(std::string& out, std::string_view text) {
+    static const char* hex = "0123456789abcdef";
+
+    out += '"';
+    size_t i = 0;
+    while (i < text.size()) {
+        auto byte = static_cast<unsigned char>(text[i]);
+
+        if (byte < 0x80) {
+            switch (byte) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\b': out += "\\b"; break;
+                case '\f': out += "\\f"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                default:
+                    if (byte < 0x20) {
+                        out += "\\u00";
+                        out += hex[byte >> 4];
+                        out += hex[byte & 0x0F];
+                    } else {
+                        out += static_cast<char>(byte);
+                    }
+            }
+            ++i;
+            continue;
+        }
+
+        // Validate one multi-byte UTF-8 sequence and copy it through
+        size_t length = 0;
+        unsigned char low = 0x80;
+        unsigned char high = 0xBF;
+        if (byte >= 0xC2 && byte <= 0xDF) {
+            length = 2;
+        } else if (byte >= 0xE0 && byte <= 0xEF) {
+            length = 3;
+            if (byte == 0xE0) { low = 0xA0; }
+            if (byte == 0xED) { high = 0x9F; }
+        } else if (byte >= 0xF0 && byte <= 0xF4) {
+            length = 4;
+            if (byte == 0xF0) { low = 0x90; }
+            if (byte == 0xF4) { high = 0x8F; }
+        }
+
+        bool valid = length != 0 && i + length <= text.size();
+        for (size_t k = 1; valid && k < length; ++k) {
+            auto continuation = static_cast<unsigned char>(text[i + k]);
+            unsigned char min = k == 1 ? low : 0x80;
+            unsigned char max = k == 1 ? high : 0xBF;
+            valid = continuation >= min && continuation <= max;
+        }
+        if (!valid) {
+            throw llm::TranslationException("Invalid UTF-8 byte at index " + std::to_string(i));
+        }
+
+        out.append(text.data() + i, length);
+        i += length;
+    }
+    out += '"';
+}
+
+void JsonWriter::appendDouble(std::string& out, double number) {
+    if (!std::isfinite(number)) {
+        out += "null";
+        return;
+    }
+    if (number == 0) {
+        out += std::signbit(number) ? "-0.0" : "0.0";
+        return;
+    }
+    if (number < 0) {
+        out += '-';
+        number = -number;
+    }
+
+    // Shortest round-trip digits, then laid out the way nlohmann's
+    // dtoa_impl::format_buffer does it
+    char scientific[32];
+    auto result = std::to_chars(scientific, scientific + sizeof(scientific), number,
+                                std::chars_format::scientific);
+
+    char digits[24];
+    int k = 0;
+    const char* p = scientific;
+    for (; p < result.ptr && *p != 'e'; ++p) {
+        if (*p != '.') {
+            digits[k++] = *p;
+        }
+    }
+    int exponent = 0;
+    std::from_chars(*(p + 1) == '+' ? p + 2 : p + 1, result.ptr, exponent);
+
+    constexpr int minExp = -4;
+    constexpr int maxExp = 15;
+    const int n = exponent + 1;
+
+    if (k <= n && n <= maxExp) {
+        // digits[000].0
+        out.append(digits, k);
+        out.append(n - k, '0');
+        out += ".0";
+    } else if (0 < n && n <= maxExp) {
+        // dig.its
+        out.append(digits, n);
+        out += '.';
+        out.append(digits + n, k - n);
+    } else if (minExp < n && n <= 0) {
+        // 0.[000]digits
+        out += "0.";
+        out.append(-n, '0');
+        out.append(digits, k);
+    } else {
+        // d.igitse+XX
+        out += digits[0];
+        if (k > 1) {
+            out += '.';
+            out.append(digits + 1, k - 1);
+        }
+        int e = n - 1;
+        out += 'e';
+        out += e < 0 ? '-' : '+';
+        e = std::abs(e);
+        if (e < 10) {
+            out += '0';
+        }
+        out += std::to_string(e);
+    }
+}
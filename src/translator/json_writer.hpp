@@ -0,0 +1,49 @@
+// src/translator/json_writer.hpp
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Streaming JSON writer that appends directly to a caller-owned string
+ *
+ * Produces the same bytes as nlohmann::json::dump() with default settings
+ * (no indentation, UTF-8 passed through, doubles in shortest round-trip
+ * form), so requests can be built without an intermediate DOM.  Object keys
+ * are written in the order they are given; callers that need dump()'s
+ * sorted key order must emit keys sorted.
+ *
+ * Throws llm::TranslationException on strings that are not valid UTF-8.
+ */
+class JsonWriter {
+public:
+    explicit JsonWriter(std::string& out);
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+
+    void key(std::string_view name);
+
+    void value(std::string_view text);
+    void value(const char* text);
+    void value(bool flag);
+    void value(int number);
+    void value(long long number);
+    void value(double number);
+
+    // Appends an already-serialized JSON value
+    void raw(std::string_view json);
+
+    static void appendEscaped(std::string& out, std::string_view text);
+    static void appendDouble(std::string& out, double number);
+
+private:
+    void beforeValue();
+
+    std::string& out_;
+    // One entry per open object/array: true once it holds an element
+    std::vector<bool> hasElements_;
+    bool afterKey_ = false;
+};
@@ -0,0 +1,235 @@
+// src/translator/openai_response_handler.cpp
+#include "openai_response_handler.hpp"
+#include "exceptions/llm_exceptions.hpp"
+
+namespace {
+
+// Bits of toolCallFieldsSeen_
+constexpr unsigned kToolCallId = 1;
+constexpr unsigned kToolCallName = 2;
+constexpr unsigned kToolCallArguments = 4;
+
+} // namespace
+
+OpenAIResponseHandler::OpenAIResponseHandler(std::pmr::memory_resource* resource)
+    : resource_(resource),
+      toolCalls_(resource ? resource : std::pmr::get_default_resource()) {}
+
+bool OpenAIResponseHandler::atKey(std::size_t depth, const char* key) const {
+    return !frames_[depth].isArray && frames_[depth].key == key;
+}
+
+bool OpenAIResponseHandler::atIndex(std::size_t depth, std::size_t index) const {
+    return frames_[depth].isArray && frames_[depth].index == index;
+}
+
+OpenAIResponseHandler::Field OpenAIResponseHandler::currentField() const {
+    switch (frames_.size()) {
+        case 1:
+            if (atKey(0, "created")) return Field::Created;
+            if (atKey(0, "model")) return Field::Model;
+            return Field::None;
+        case 2:
+            if (!atKey(0, "usage")) return Field::None;
+            if (atKey(1, "prompt_tokens")) return Field::PromptTokens;
+            if (atKey(1, "completion_tokens")) return Field::CompletionTokens;
+            if (atKey(1, "total_tokens")) return Field::TotalTokens;
+            return Field::None;
+        case 3:
+            if (atKey(0, "choices") && atIndex(1, 0) && atKey(2, "finish_reason")) return Field::FinishReason;
+            return Field::None;
+        case 4:
+            if (!atKey(0, "choices") || !atIndex(1, 0) || !atKey(2, "message")) return Field::None;
+            if (atKey(3, "role")) return Field::Role;
+            if (atKey(3, "content")) return Field::Content;
+            return Field::None;
+        case 6:
+        case 7:
+            if (!atKey(0, "choices") || !atIndex(1, 0) || !atKey(2, "message") ||
+                !atKey(3, "tool_calls") || !frames_[4].isArray) return Field::None;
+            if (frames_.size() == 6) {
+                return atKey(5, "id") ? Field::ToolCallId : Field::None;
+            }
+            if (!atKey(5, "function")) return Field::None;
+            if (atKey(6, "name")) return Field::ToolCallName;
+            if (atKey(6, "arguments")) return Field::ToolCallArguments;
+            return Field::None;
+        default:
+            return Field::None;
+    }
+}
+
+void OpenAIResponseHandler::valueDone() {
+    if (!frames_.empty() && frames_.back().isArray) {
+        ++frames_.back().index;
+    }
+}
+
+void OpenAIResponseHandler::typeMismatch(const char* expected) {
+    std::string path;
+    for (const auto& frame : frames_) {
+        path += frame.isArray ? "[" + std::to_string(frame.index) + "]" : "/" + frame.key;
+    }
+    error_ = "Unexpected type at " + path + ": expected " + expected;
+}
+
+bool OpenAIResponseHandler::null() {
+    if (currentField() != Field::None) {
+        typeMismatch("a value, got null");
+        return false;
+    }
+    valueDone();
+    return true;
+}
+
+bool OpenAIResponseHandler::boolean(bool) {
+    if (currentField() != Field::None) {
+        typeMismatch("a string or number, got boolean");
+        return false;
+    }
+    valueDone();
+    return true;
+}
+
+bool OpenAIResponseHandler::number_integer(number_integer_t val) {
+    switch (currentField()) {
+        case Field::None: break;
+        case Field::Created: created_ = static_cast<long long>(val); break;
+        case Field::PromptTokens: promptTokens_ = static_cast<int>(val); break;
+        case Field::CompletionTokens: completionTokens_ = static_cast<int>(val); break;
+        case Field::TotalTokens: totalTokens_ = static_cast<int>(val); break;
+        default:
+            typeMismatch("string, got number");
+            return false;
+    }
+    valueDone();
+    return true;
+}
+
+bool OpenAIResponseHandler::number_unsigned(number_unsigned_t val) {
+    return number_integer(static_cast<number_integer_t>(val));
+}
+
+bool OpenAIResponseHandler::number_float(number_float_t val, const string_t&) {
+    return number_integer(static_cast<number_integer_t>(val));
+}
+
+bool OpenAIResponseHandler::string(string_t& val) {
+    switch (currentField()) {
+        case Field::None: break;
+        case Field::Model: model_ = std::move(val); break;
+        case Field::FinishReason: finishReason_ = std::move(val); break;
+        case Field::Role: role_ = std::move(val); break;
+        case Field::Content: content_ = std::move(val); break;
+        case Field::ToolCallId:
+            toolCalls_.back().id = val;
+            toolCallFieldsSeen_.back() |= kToolCallId;
+            break;
+        case Field::ToolCallName:
+            toolCalls_.back().name = val;
+            toolCallFieldsSeen_.back() |= kToolCallName;
+            break;
+        case Field::ToolCallArguments:
+            toolCalls_.back().arguments = val;
+            toolCallFieldsSeen_.back() |= kToolCallArguments;
+            break;
+        default:
+            typeMismatch("number, got string");
+            return false;
+    }
+    valueDone();
+    return true;
+}
+
+bool OpenAIResponseHandler::binary(binary_t&) {
+    valueDone();
+    return true;
+}
+
+bool OpenAIResponseHandler::start_object(std::size_t) {
+    if (currentField() != Field::None) {
+        typeMismatch("a scalar, got object");
+        return false;
+    }
+    // Elements of choices[0].message.tool_calls
+    if (frames_.size() == 5 && atKey(0, "choices") && atIndex(1, 0) && atKey(2, "message") &&
+        atKey(3, "tool_calls") && frames_[4].isArray) {
+        toolCalls_.emplace_back();
+        toolCallFieldsSeen_.push_back(0);
+    }
+    frames_.push_back(Frame{false, {}, 0});
+    return true;
+}
+
+bool OpenAIResponseHandler::key(string_t& val) {
+    frames_.back().key = std::move(val);
+    return true;
+}
+
+bool OpenAIResponseHandler::end_object() {
+    frames_.pop_back();
+    valueDone();
+    return true;
+}
+
+bool OpenAIResponseHandler::start_array(std::size_t) {
+    if (currentField() != Field::None) {
+        typeMismatch("a scalar, got array");
+        return false;
+    }
+    frames_.push_back(Frame{true, {}, 0});
+    return true;
+}
+
+bool OpenAIResponseHandler::end_array() {
+    frames_.pop_back();
+    valueDone();
+    return true;
+}
+
+bool OpenAIResponseHandler::parse_error(std::size_t, const std::string&,
+                                        const nlohmann::detail::exception& ex) {
+    error_ = ex.what();
+    return false;
+}
+
+std::unique_ptr<Message> OpenAIResponseHandler::takeMessage() {
+    if (!error_.empty()) {
+        throw llm::TranslationException(error_);
+    }
+
+    auto require = [](bool present, const char* field) {
+        if (!present) {
+            throw llm::TranslationException(std::string("Missing field in response: ") + field);
+        }
+    };
+    require(role_.has_value(), "choices[0].message.role");
+    require(content_.has_value(), "choices[0].message.content");
+    require(created_.has_value(), "created");
+    require(finishReason_.has_value(), "choices[0].finish_reason");
+    require(model_.has_value(), "model");
+    require(promptTokens_.has_value(), "usage.prompt_tokens");
+    require(completionTokens_.has_value(), "usage.completion_tokens");
+    require(totalTokens_.has_value(), "usage.total_tokens");
+    for (unsigned seen : toolCallFieldsSeen_) {
+        require(seen & kToolCallId, "tool_calls[].id");
+        require(seen & kToolCallName, "tool_calls[].function.name");
+        require(seen & kToolCallArguments, "tool_calls[].function.arguments");
+    }
+
+    auto message = Message::create(*role_ == "assistant" ? Message::Type::Assistant : Message::Type::System,
+                                   resource_);
+
+    message->content = *content_;
+    auto metadata = std::make_shared<ResponseMetadata>();
+    metadata->created = *created_;
+    metadata->finish_reason = std::move(finishReason_);
+    metadata->model = std::move(model_);
+    metadata->prompt_tokens = promptTokens_;
+    metadata->completion_tokens = completionTokens_;
+    metadata->total_tokens = totalTokens_;
+    message->metadata = std::move(metadata);
+    message->tool_calls = std::move(toolCalls_);
+
+    return message;
+}
@@ -0,0 +1,75 @@
+// src/translator/openai_response_handler.hpp
+#pragma once
+#include "core/message.hpp"
+#include <nlohmann/json.hpp>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+/**
+ * @brief SAX handler that fills a Message straight from a chat completion
+ *
+ * Used with nlohmann::json::sax_parse so a response can be parsed while it is
+ * still arriving, without building a DOM.  Only the fields read by
+ * OpenAITranslator::responseToMessage are kept; everything else is skipped.
+ * takeMessage() enforces the same required fields as the DOM path and throws
+ * llm::TranslationException when one is missing or has the wrong type.
+ */
+class OpenAIResponseHandler : public nlohmann::json_sax<nlohmann::json> {
+public:
+    // The message is allocated from resource; nullptr uses the heap
+    explicit OpenAIResponseHandler(std::pmr::memory_resource* resource = nullptr);
+
+    bool null() override;
+    bool boolean(bool val) override;
+    bool number_integer(number_integer_t val) override;
+    bool number_unsigned(number_unsigned_t val) override;
+    bool number_float(number_float_t val, const string_t& s) override;
+    bool string(string_t& val) override;
+    bool binary(binary_t& val) override;
+    bool start_object(std::size_t elements) override;
+    bool key(string_t& val) override;
+    bool end_object() override;
+    bool start_array(std::size_t elements) override;
+    bool end_array() override;
+    bool parse_error(std::size_t position, const std::string& last_token,
+                     const nlohmann::detail::exception& ex) override;
+
+    std::unique_ptr<Message> takeMessage();
+
+private:
+    // One frame per open container; key/index name the slot being filled
+    struct Frame {
+        bool isArray;
+        std::string key;
+        std::size_t index = 0;
+    };
+
+    enum class Field {
+        None, Created, Model, PromptTokens, CompletionTokens, TotalTokens,
+        FinishReason, Role, Content, ToolCallId, ToolCallName, ToolCallArguments
+    };
+
+    Field currentField() const;
+    bool atKey(std::size_t depth, const char* key) const;
+    bool atIndex(std::size_t depth, std::size_t index) const;
+    void valueDone();
+    void typeMismatch(const char* expected);
+
+    std::pmr::memory_resource* resource_;
+    std::vector<Frame> frames_;
+
+    std::optional<std::string> role_;
+    std::optional<std::string> content_;
+    std::optional<long long> created_;
+    std::optional<std::string> finishReason_;
+    std::optional<std::string> model_;
+    std::optional<int> promptTokens_;
+    std::optional<int> completionTokens_;
+    std::optional<int> totalTokens_;
+    std::pmr::vector<ToolCall> toolCalls_;
+    // Which fields each element of toolCalls_ has received
+    std::vector<unsigned> toolCallFieldsSeen_;
+    std::string error_;
+};
@@ -1,6 +1,10 @@
 // src/translators/openai_translator.cpp
 #include "openai_translator.hpp"
+#include "sse_reader.hpp"
+#include "openai_response_handler.hpp"
 #include <nlohmann/json.hpp>
+#include <algorithm>
+#include <map>
 #include <vector>
 #include <iostream>
 
@@ -43,11 +47,10 @@
 */
 
 
-std::string OpenAITranslator::createRequest(
-    const std::vector<std::unique_ptr<Message>>& messages,
-    const std::vector<Tool>& tools) const {
-    nlohmann::json request;
-    
+void OpenAITranslator::createRequest(
+    const std::vector<const Message*>& messages,
+    const ToolRegistry& tools,
+    std::string& out) const {
     auto lastUserMessageIterator = std::find_if(messages.rbegin(), messages.rend(), 
         [](const auto& msg) { return msg->getType() == Message::Type::User; });
 
@@ -55,67 +58,138 @@ std::string OpenAITranslator::createRequest(
         throw llm::TranslationException("No user message found in conversation");
     }
     
-    const Message* messageWithSpecs = lastUserMessageIterator->get();
-
-    // Add message-specific parameters
-    if (messageWithSpecs->model.has_value()) { request["model"] = *messageWithSpecs->model; }
-    if (messageWithSpecs->temperature.has_value()) { request["temperature"] = *messageWithSpecs->temperature; }
-    if (messageWithSpecs->top_p.has_value()) { request["top_p"] = *messageWithSpecs->top_p; }
-    if (messageWithSpecs->max_tokens.has_value()) { request["max_tokens"] = *messageWithSpecs->max_tokens; }
-    if (messageWithSpecs->logprobs.has_value()) { request["logprobs"] = *messageWithSpecs->logprobs; }
-    if (messageWithSpecs->stream.has_value()) { request["stream"] = *messageWithSpecs->stream; }
-    if (messageWithSpecs->random_seed.has_value()) { request["seed"] = *messageWithSpecs->random_seed; }
-    if (messageWithSpecs->response_format_type.has_value()) { 
-        request["response_format"]["type"] = *messageWithSpecs->response_format_type; 
-    }
-
-    // Add messages array
-    nlohmann::json messageArray = nlohmann::json::array();
+    const RequestConfig& specs = (*lastUserMessageIterator)->getConfig();
+
+    // Every registered tool, or the subset the message asks for.  A name
+    // listed twice is offered once; providers reject duplicate tools.
+    std::vector<const ToolRegistry::Entry*> subset;
+    if (specs.tools) {
+        subset.reserve(specs.tools->size());
+        for (const auto& name : *specs.tools) {
+            const ToolRegistry::Entry* entry = tools.find(name);
+            if (!entry) {
+                throw llm::TranslationException("Unknown tool: " + name);
+            }
+            if (std::find(subset.begin(), subset.end(), entry) == subset.end()) {
+                subset.push_back(entry);
+            }
+        }
+    }
+    const std::vector<const ToolRegistry::Entry*>& offered = specs.tools ? subset : tools.entries();
+
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    ++requestCount_;
+
+    out.clear();
+    JsonWriter writer(out);
+    writer.beginObject();
+
+    // Message-specific parameters, with messages and tools spliced in from
+    // the cache.  Keys must stay in sorted order.
+    if (specs.logprobs.has_value()) { writer.key("logprobs"); writer.value(*specs.logprobs); }
+    if (specs.max_tokens.has_value()) { writer.key("max_tokens"); writer.value(*specs.max_tokens); }
+
+    writer.key("messages");
+    writer.beginArray();
     for (const auto& message : messages) {
-        messageArray.push_back(messageToJSONObject(*message));
+        writer.raw(serializedMessage(*message));
     }
-    request["messages"] = messageArray;
-    
-    // Add tools if present
-    if (!tools.empty()) {
-        nlohmann::json toolArray = nlohmann::json::array();
-        for (const auto& tool : tools) {
-            toolArray.push_back(toolToJSONObject(tool));
+    writer.endArray();
+
+    if (specs.model.has_value()) { writer.key("model"); writer.value(*specs.model); }
+    if (specs.response_format_type.has_value()) {
+        writer.key("response_format");
+        writer.beginObject();
+        writer.key("type");
+        writer.value(*specs.response_format_type);
+        writer.endObject();
+    }
+    if (specs.random_seed.has_value()) { writer.key("seed"); writer.value(*specs.random_seed); }
+    if (specs.stream.has_value()) { writer.key("stream"); writer.value(*specs.stream); }
+    if (specs.temperature.has_value()) { writer.key("temperature"); writer.value(*specs.temperature); }
+
+    if (!offered.empty()) {
+        if (specs.tool_choice.has_value()) {
+            writer.key("tool_choice");
+            writer.value(*specs.tool_choice);
         }
-        request["tools"] = toolArray;
-        if (messageWithSpecs->tool_choice.has_value()) {
-            request["tool_choice"] = *messageWithSpecs->tool_choice;
+        writer.key("tools");
+        writer.beginArray();
+        for (const auto* entry : offered) {
+            writer.raw(serializedTool(*entry));
         }
+        writer.endArray();
+    }
+
+    if (specs.top_p.has_value()) { writer.key("top_p"); writer.value(*specs.top_p); }
+
+    writer.endObject();
+
+    pruneCaches(messages.size(), tools.size());
+}
+
+const std::string& OpenAITranslator::serializedMessage(const Message& message) const {
+    auto& entry = messageCache_[message.getId()];
+    if (entry.json.empty()) {
+        JsonWriter writer(entry.json);
+        writeMessage(writer, message);
+    }
+    entry.lastUsed = requestCount_;
+    return entry.json;
+}
+
+const std::string& OpenAITranslator::serializedTool(const ToolRegistry::Entry& entry) const {
+    auto& json = toolCache_[entry.id];
+    if (json.empty()) {
+        JsonWriter writer(json);
+        writeTool(writer, entry.tool);
+    }
+    return json;
+}
+
+void OpenAITranslator::pruneCaches(std::size_t liveMessages, std::size_t registeredTools) const {
+    // Drop fragments of messages that were not part of this request, so the
+    // cache never outgrows the conversation it serves
+    if (messageCache_.size() > liveMessages) {
+        for (auto it = messageCache_.begin(); it != messageCache_.end();) {
+            if (it->second.lastUsed != requestCount_) {
+                it = messageCache_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    // Tools only fall out of use when replaced in the registry, or when a
+    // different registry is passed in, so starting over is cheap enough
+    if (toolCache_.size() > registeredTools) {
+        toolCache_.clear();
     }
-    
-    return request.dump();
 }
 
 std::unique_ptr<Message> OpenAITranslator::responseToMessage(const std::string& json) const {
     try {
         nlohmann::json j = nlohmann::json::parse(json);
         std::string role = j["choices"][0]["message"]["role"];
-        std::unique_ptr<Message> message = role == "assistant"
-            ? std::make_unique<Message>(Message::Type::Assistant)
-            : std::make_unique<Message>(Message::Type::System);
-
-        message->content = j["choices"][0]["message"]["content"];
-        message->created = j["created"];
-        message->finish_reason = j["choices"][0]["finish_reason"];
-        message->model = j["model"];
-        message->prompt_tokens = j["usage"]["prompt_tokens"];
-        message->completion_tokens = j["usage"]["completion_tokens"];
-        message->total_tokens = j["usage"]["total_tokens"];
+        auto message = Message::create(role == "assistant" ? Message::Type::Assistant : Message::Type::System,
+                                       memoryResource());
+
+        message->content = j["choices"][0]["message"]["content"].get_ref<const std::string&>();
+        auto metadata = std::make_shared<ResponseMetadata>();
+        metadata->created = j["created"];
+        metadata->finish_reason = j["choices"][0]["finish_reason"];
+        metadata->model = j["model"];
+        metadata->prompt_tokens = j["usage"]["prompt_tokens"];
+        metadata->completion_tokens = j["usage"]["completion_tokens"];
+        metadata->total_tokens = j["usage"]["total_tokens"];
+        message->metadata = std::move(metadata);
 
         // Tool calls processing
         const auto& messageObj = j["choices"][0]["message"];
         if (messageObj.contains("tool_calls") && !messageObj["tool_calls"].is_null()) {
             for (const auto& toolCall : messageObj["tool_calls"]) {
-                std::map<std::string, std::string> toolCallMap;
-                toolCallMap["id"] = toolCall["id"];
-                toolCallMap["name"] = toolCall["function"]["name"];
-                toolCallMap["arguments"] = toolCall["function"]["arguments"];
-                message->tool_calls.push_back(toolCallMap);
+                message->tool_calls.emplace_back(toolCall["id"].get_ref<const std::string&>(),
+                                                 toolCall["function"]["name"].get_ref<const std::string&>(),
+                                                 toolCall["function"]["arguments"].get_ref<const std::string&>());
             }
         }
 
@@ -126,57 +200,201 @@ std::unique_ptr<Message> OpenAITranslator::responseToMessage(const std::string&
     }
 }
 
+std::unique_ptr<Message> OpenAITranslator::responseToMessage(std::istream& stream) const {
+    // SAX parse straight into the Message; no DOM and no buffered copy of
+    // the body, so parsing keeps pace with the bytes as they arrive
+    OpenAIResponseHandler handler(memoryResource());
+    try {
+        nlohmann::json::sax_parse(stream, &handler);
+    } catch (const nlohmann::json::exception& e) {
+        throw llm::TranslationException(e.what());
+    }
+    return handler.takeMessage();
+}
+
+/*
+Streamed responses arrive as server-sent events, one chunk per event:
+
+data: {"id":"chatcmpl-1","created":1729376080,"model":"gpt-4o","choices":[{"index":0,"delta":{"role":"assistant","content":"Hel"},"finish_reason":null}]}
+
+data: {"id":"chatcmpl-1","created":1729376080,"model":"gpt-4o","choices":[{"index":0,"delta":{"tool_calls":[{"index":0,"id":"call_1","function":{"name":"get_weather","arguments":"{\"loc"}}]},"finish_reason":null}]}
+
+data: [DONE]
+*/
+std::unique_ptr<Message> OpenAITranslator::streamToMessage(std::istream& stream,
+                                                           const TokenCallback& onToken) const {
+    auto message = Message::create(Message::Type::Assistant, memoryResource());
+    auto metadata = std::make_shared<ResponseMetadata>();
+
+    // Tool call deltas are keyed by their "index" and arrive in pieces
+    std::map<int, ToolCall> toolCalls;
+    bool sawChunk = false;
+
+    try {
+        SSEReader reader(stream);
+        while (auto event = reader.next()) {
+            if (event->data == "[DONE]") {
+                break;
+            }
+
+            nlohmann::json chunk = nlohmann::json::parse(event->data);
+            if (chunk.contains("error")) {
+                throw llm::TranslationException("Error in response stream: " + chunk["error"].dump());
+            }
+            sawChunk = true;
+
+            if (chunk.contains("created")) { metadata->created = chunk["created"]; }
+            if (chunk.contains("model")) { metadata->model = chunk["model"]; }
+            if (chunk.contains("usage") && !chunk["usage"].is_null()) {
+                metadata->prompt_tokens = chunk["usage"]["prompt_tokens"];
+                metadata->completion_tokens = chunk["usage"]["completion_tokens"];
+                metadata->total_tokens = chunk["usage"]["total_tokens"];
+            }
+            if (!chunk.contains("choices") || chunk["choices"].empty()) {
+                continue;
+            }
+
+            const auto& choice = chunk["choices"][0];
+            if (choice.contains("finish_reason") && !choice["finish_reason"].is_null()) {
+                metadata->finish_reason = choice["finish_reason"];
+            }
+            if (!choice.contains("delta")) {
+                continue;
+            }
+
+            const auto& delta = choice["delta"];
+            if (delta.contains("content") && delta["content"].is_string()) {
+                const std::string& token = delta["content"].get_ref<const std::string&>();
+                message->content += token;
+                if (onToken && !token.empty()) {
+                    onToken(token);
+                }
+            }
+            if (delta.contains("tool_calls") && !delta["tool_calls"].is_null()) {
+                for (const auto& toolCallDelta : delta["tool_calls"]) {
+                    auto& toolCall = toolCalls.try_emplace(toolCallDelta.value("index", 0),
+                                                           message->get_allocator()).first->second;
+                    if (toolCallDelta.contains("id") && toolCallDelta["id"].is_string()) {
+                        toolCall.id = toolCallDelta["id"].get_ref<const std::string&>();
+                    }
+                    if (!toolCallDelta.contains("function")) {
+                        continue;
+                    }
+                    const auto& function = toolCallDelta["function"];
+                    if (function.contains("name") && function["name"].is_string()) {
+                        toolCall.name += function["name"].get_ref<const std::string&>();
+                    }
+                    if (function.contains("arguments") && function["arguments"].is_string()) {
+                        toolCall.arguments += function["arguments"].get_ref<const std::string&>();
+                    }
+                }
+            }
+        }
+    } catch (const nlohmann::json::exception& e) {
+        throw llm::TranslationException(e.what());
+    }
+
+    if (!sawChunk) {
+        throw llm::TranslationException("Response stream ended without any data");
+    }
+
+    message->tool_calls.reserve(toolCalls.size());
+    for (auto& [index, toolCall] : toolCalls) {
+        message->tool_calls.push_back(std::move(toolCall));
+    }
+    message->metadata = std::move(metadata);
+
+    return message;
+}
+
 std::string OpenAITranslator::toJSON(const Message& message) const {
-    return messageToJSONObject(message).dump();
+    std::string out;
+    JsonWriter writer(out);
+    writeMessage(writer, message);
+    return out;
 }
 
 std::string OpenAITranslator::toJSON(const Tool& tool) const {
-    return toolToJSONObject(tool).dump();
+    std::string out;
+    JsonWriter writer(out);
+    writeTool(writer, tool);
+    return out;
 }
 
 std::string OpenAITranslator::toJSON(const Parameter& param) const {
-    return parameterToJSONObject(param).dump();
+    std::string out;
+    JsonWriter writer(out);
+    writeParameter(writer, param);
+    return out;
 }
 
-nlohmann::json OpenAITranslator::parameterToJSONObject(const Parameter& param) const {
-    nlohmann::json j;
-    j["type"] = param.type;
-    j["description"] = param.description;
+void OpenAITranslator::writeParameter(JsonWriter& writer, const Parameter& param) const {
+    writer.beginObject();
+    writer.key("description");
+    writer.value(param.description);
     if (!param.enum_values.empty()) {
-        j["enum"] = param.enum_values;
+        writer.key("enum");
+        writer.beginArray();
+        for (const auto& value : param.enum_values) {
+            writer.value(value);
+        }
+        writer.endArray();
     }
-    return j;
+    writer.key("type");
+    writer.value(param.type);
+    writer.endObject();
 }
 
-nlohmann::json OpenAITranslator::toolToJSONObject(const Tool& tool) const {
-    nlohmann::json j;
-    j["type"] = "function";
-    j["function"]["name"] = tool.name;
-    j["function"]["description"] = tool.description;
-    j["function"]["parameters"]["type"] = "object";
-    j["function"]["parameters"]["properties"] = nlohmann::json::object();
-    
+void OpenAITranslator::writeTool(JsonWriter& writer, const Tool& tool) const {
+    writer.beginObject();
+    writer.key("function");
+    writer.beginObject();
+    writer.key("description");
+    writer.value(tool.description);
+    writer.key("name");
+    writer.value(tool.name);
+    writer.key("parameters");
+    writer.beginObject();
+
+    // Properties are keyed by parameter name: sorted, and a repeated name
+    // keeps its last definition
+    std::map<std::string_view, const Parameter*> properties;
     for (const auto& param : tool.parameters) {
-        j["function"]["parameters"]["properties"][param.name] = parameterToJSONObject(param);
+        properties[param.name] = &param;
+    }
+    writer.key("properties");
+    writer.beginObject();
+    for (const auto& [name, param] : properties) {
+        writer.key(name);
+        writeParameter(writer, *param);
     }
+    writer.endObject();
 
     // Add required parameters
-    std::vector<std::string> requiredParams;
-    for (const auto& param : tool.parameters) {
-        if (param.required) {
-            requiredParams.push_back(param.name);
+    bool anyRequired = std::any_of(tool.parameters.begin(), tool.parameters.end(),
+        [](const Parameter& param) { return param.required; });
+    if (anyRequired) {
+        writer.key("required");
+        writer.beginArray();
+        for (const auto& param : tool.parameters) {
+            if (param.required) {
+                writer.value(param.name);
+            }
         }
-    }
-    if (!requiredParams.empty()) {
-        j["function"]["parameters"]["required"] = requiredParams;
+        writer.endArray();
     }
 
-    return j;
+    writer.key("type");
+    writer.value("object");
+    writer.endObject();
+    writer.endObject();
+    writer.key("type");
+    writer.value("function");
+    writer.endObject();
 }
 
-nlohmann::json OpenAITranslator::messageToJSONObject(const Message& message) const {
-    nlohmann::json j;
-    j["role"] = [&]() {
+void OpenAITranslator::writeMessage(JsonWriter& writer, const Message& message) const {
+    const char* role = [&]() {
         switch (message.getType()) {
             case Message::Type::System: return "system";
             case Message::Type::User: return "user";
@@ -186,27 +404,44 @@ nlohmann::json OpenAITranslator::messageToJSONObject(const Message& message) con
             default: throw llm::TranslationException("Unknown message type");
         }
     }();
-    
-    j["content"] = message.content;
 
     // Only include tool-specific fields for tool results
-    if (message.getType() == Message::Type::ToolResult) {
-        if (message.tool_call_id) j["tool_call_id"] = *message.tool_call_id;
-        if (message.name) j["name"] = *message.name;
+    bool isToolResult = message.getType() == Message::Type::ToolResult;
+
+    writer.beginObject();
+    writer.key("content");
+    writer.value(message.content);
+    if (isToolResult && message.name) {
+        writer.key("name");
+        writer.value(*message.name);
+    }
+    writer.key("role");
+    writer.value(role);
+    if (isToolResult && message.tool_call_id) {
+        writer.key("tool_call_id");
+        writer.value(*message.tool_call_id);
     }
 
     // Include tool calls if present
     if (!message.tool_calls.empty()) {
-        j["tool_calls"] = nlohmann::json::array();
+        writer.key("tool_calls");
+        writer.beginArray();
         for (const auto& toolCall : message.tool_calls) {
-            nlohmann::json toolCallJSON;
-            toolCallJSON["id"] = toolCall.at("id");
-            toolCallJSON["type"] = "function";
-            toolCallJSON["function"]["name"] = toolCall.at("name");
-            toolCallJSON["function"]["arguments"] = toolCall.at("arguments");
-            j["tool_calls"].push_back(toolCallJSON);
+            writer.beginObject();
+            writer.key("function");
+            writer.beginObject();
+            writer.key("arguments");
+            writer.value(toolCall.arguments);
+            writer.key("name");
+            writer.value(toolCall.name);
+            writer.endObject();
+            writer.key("id");
+            writer.value(toolCall.id);
+            writer.key("type");
+            writer.value("function");
+            writer.endObject();
         }
+        writer.endArray();
     }
-
-    return j;
+    writer.endObject();
 }
@@ -1,14 +1,24 @@
 // src/translators/openai_translator.hpp
 #pragma once
 #include "itranslator.hpp"
+#include "json_writer.hpp"
 #include "exceptions/llm_exceptions.hpp"
 #include <nlohmann/json.hpp>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
 
 class OpenAITranslator : public ITranslator {
 public:
+    using ITranslator::createRequest;
+
     std::unique_ptr<Message> responseToMessage(const std::string& json) const override;
-    std::string createRequest(const std::vector<std::unique_ptr<Message>>& messages,
-                            const std::vector<Tool>& tools) const override;
+    std::unique_ptr<Message> responseToMessage(std::istream& stream) const override;
+    void createRequest(const std::vector<const Message*>& messages,
+                       const ToolRegistry& tools,
+                       std::string& out) const override;
+    std::unique_ptr<Message> streamToMessage(std::istream& stream,
+                                             const TokenCallback& onToken) const override;
     
     // Utility methods for converting objects to JSON
     std::string toJSON(const Parameter& param) const;
@@ -16,8 +26,26 @@ public:
     std::string toJSON(const Tool& tool) const;
 
 private:
-    // Helper methods for JSON conversion
-    nlohmann::json parameterToJSONObject(const Parameter& param) const;
-    nlohmann::json toolToJSONObject(const Tool& tool) const;
-    nlohmann::json messageToJSONObject(const Message& message) const;
+    // Helper methods for JSON conversion.  Keys are written in sorted order,
+    // matching what nlohmann::json::dump() produced for the same objects.
+    void writeParameter(JsonWriter& writer, const Parameter& param) const;
+    void writeTool(JsonWriter& writer, const Tool& tool) const;
+    void writeMessage(JsonWriter& writer, const Message& message) const;
+
+    // Cached serializations so that each request only encodes what is new.
+    // Messages are keyed by Message::getId() and tools by their registry id;
+    // both are immutable once they have an id.
+    struct CachedFragment {
+        std::string json;
+        std::uint64_t lastUsed = 0;
+    };
+
+    const std::string& serializedMessage(const Message& message) const;
+    const std::string& serializedTool(const ToolRegistry::Entry& entry) const;
+    void pruneCaches(std::size_t liveMessages, std::size_t registeredTools) const;
+
+    mutable std::mutex cacheMutex_;
+    mutable std::uint64_t requestCount_ = 0;
+    mutable std::unordered_map<std::uint64_t, CachedFragment> messageCache_;
+    mutable std::unordered_map<std::uint64_t, std::string> toolCache_;
 };
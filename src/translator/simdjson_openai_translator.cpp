@@ -0,0 +1,79 @@
+// src/translator/simdjson_openai_translator.cpp
+#include "simdjson_openai_translator.hpp"
+#include <simdjson.h>
+
+struct SimdjsonOpenAITranslator::Parser {
+    simdjson::dom::parser parser;
+};
+
+namespace {
+
+// Mirrors what nlohmann's conversions accept for the DOM path
+std::string getString(simdjson::dom::element element, const char* path) {
+    std::string_view value;
+    if (element.at_pointer(path).get(value) != simdjson::SUCCESS) {
+        throw llm::TranslationException(std::string("Expected string at ") + path);
+    }
+    return std::string(value);
+}
+
+long long getInteger(simdjson::dom::element element, const char* path) {
+    simdjson::dom::element value;
+    if (element.at_pointer(path).get(value) != simdjson::SUCCESS) {
+        throw llm::TranslationException(std::string("Expected number at ") + path);
+    }
+    switch (value.type()) {
+        case simdjson::dom::element_type::INT64: return value.get_int64().value_unsafe();
+        case simdjson::dom::element_type::UINT64: return static_cast<long long>(value.get_uint64().value_unsafe());
+        case simdjson::dom::element_type::DOUBLE: return static_cast<long long>(value.get_double().value_unsafe());
+        default: throw llm::TranslationException(std::string("Expected number at ") + path);
+    }
+}
+
+} // namespace
+
+SimdjsonOpenAITranslator::SimdjsonOpenAITranslator() : parser_(std::make_unique<Parser>()) {}
+
+SimdjsonOpenAITranslator::~SimdjsonOpenAITranslator() = default;
+
+std::unique_ptr<Message> SimdjsonOpenAITranslator::responseToMessage(const std::string& json) const {
+    std::lock_guard<std::mutex> lock(parserMutex_);
+
+    simdjson::dom::element root;
+    auto error = parser_->parser.parse(json).get(root);
+    if (error) {
+        throw llm::TranslationException(simdjson::error_message(error));
+    }
+
+    simdjson::dom::element messageObj;
+    if (root.at_pointer("/choices/0/message").get(messageObj) != simdjson::SUCCESS) {
+        throw llm::TranslationException("Expected object at /choices/0/message");
+    }
+
+    std::string role = getString(messageObj, "/role");
+    auto message = Message::create(role == "assistant" ? Message::Type::Assistant : Message::Type::System,
+                                   memoryResource());
+
+    message->content = getString(messageObj, "/content");
+    auto metadata = std::make_shared<ResponseMetadata>();
+    metadata->created = getInteger(root, "/created");
+    metadata->finish_reason = getString(root, "/choices/0/finish_reason");
+    metadata->model = getString(root, "/model");
+    metadata->prompt_tokens = static_cast<int>(getInteger(root, "/usage/prompt_tokens"));
+    metadata->completion_tokens = static_cast<int>(getInteger(root, "/usage/completion_tokens"));
+    metadata->total_tokens = static_cast<int>(getInteger(root, "/usage/total_tokens"));
+    message->metadata = std::move(metadata);
+
+    // Tool calls processing
+    simdjson::dom::array toolCalls;
+    if (messageObj["tool_calls"].get(toolCalls) == simdjson::SUCCESS) {
+        for (simdjson::dom::element toolCall : toolCalls) {
+            message->tool_calls.emplace_back(getString(toolCall, "/id"), getString(toolCall, "/function/name"),
+                                             getString(toolCall, "/function/arguments"));
+        }
+    } else if (messageObj["tool_calls"].error() == simdjson::SUCCESS && !messageObj["tool_calls"].is_null()) {
+        throw llm::TranslationException("Expected array at /choices/0/message/tool_calls");
+    }
+
+    return message;
+}
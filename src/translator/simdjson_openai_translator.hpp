@@ -0,0 +1,29 @@
+// src/translator/simdjson_openai_translator.hpp
+#pragma once
+#include "openai_translator.hpp"
+#include <memory>
+#include <mutex>
+
+/**
+ * @brief OpenAITranslator whose responseToMessage parses with simdjson
+ *
+ * Fills the same Message fields and raises the same llm::TranslationException
+ * errors as the nlohmann-based parser; request building is inherited.  Only
+ * built when simdjson is found (COLLOQUIUM_HAS_SIMDJSON), and selected with
+ * "#TRANSLATOR openai-simdjson".
+ */
+class SimdjsonOpenAITranslator : public OpenAITranslator {
+public:
+    using OpenAITranslator::responseToMessage;
+
+    SimdjsonOpenAITranslator();
+    ~SimdjsonOpenAITranslator() override;
+
+    std::unique_ptr<Message> responseToMessage(const std::string& json) const override;
+
+private:
+    // The parser reuses its buffers between calls
+    struct Parser;
+    std::unique_ptr<Parser> parser_;
+    mutable std::mutex parserMutex_;
+};
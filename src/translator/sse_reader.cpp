@@ -0,0 +1,56 @@
+// src/translator/sse_reader.cpp
+#include "sse_reader.hpp"
+
+SSEReader::SSEReader(std::istream& stream) : stream_(stream) {}
+
+std::optional<SSEEvent> SSEReader::next() {
+    SSEEvent event;
+    bool hasData = false;
+    std::string line;
+
+    while (std::getline(stream_, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+
+        // A blank line dispatches the event collected so far
+        if (line.empty()) {
+            if (hasData) {
+                return event;
+            }
+            event = SSEEvent();
+            continue;
+        }
+
+        if (line[0] == ':') {
+            continue;
+        }
+
+        auto colon = line.find(':');
+        std::string field = line.substr(0, colon);
+        std::string value;
+        if (colon != std::string::npos) {
+            size_t start = colon + 1;
+            if (start < line.size() && line[start] == ' ') {
+                ++start;
+            }
+            value = line.substr(start);
+        }
+
+        if (field == "data") {
+            if (hasData) {
+                event.data += '\n';
+            }
+            event.data += value;
+            hasData = true;
+        } else if (field == "event") {
+            event.event = value;
+        }
+    }
+
+    // Be lenient with servers that omit the final blank line
+    if (hasData) {
+        return event;
+    }
+    return std::nullopt;
+}
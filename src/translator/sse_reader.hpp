@@ -0,0 +1,28 @@
+// src/translator/sse_reader.hpp
+#pragma once
+#include <istream>
+#include <optional>
+#include <string>
+
+struct SSEEvent {
+    std::string event;
+    std::string data;
+};
+
+/**
+ * @brief Reads a text/event-stream body one event at a time
+ *
+ * Comment lines and fields other than "event" and "data" are ignored.
+ * Multiple data lines within one event are joined with '\n'.  Reads block
+ * on the underlying stream, so events are returned as soon as they arrive.
+ */
+class SSEReader {
+public:
+    explicit SSEReader(std::istream& stream);
+
+    // Returns std::nullopt once the stream is exhausted
+    std::optional<SSEEvent> next();
+
+private:
+    std::istream& stream_;
+};
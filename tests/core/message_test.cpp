@@ -21,25 +21,89 @@ TEST(MessageTest, ConstructorAndGetType) {
 TEST(MessageTest, ContentAndOptionalFields) {
     Message message(Message::Type::User);
     message.content = "Hello, World!";
-    message.created = 1729376080;
-    message.model = "gpt-3.5-turbo";
-    message.temperature = 0.7;
-    message.max_tokens = 100;
+    RequestConfig& config = message.editConfig();
+    config.model = "gpt-3.5-turbo";
+    config.temperature = 0.7;
+    config.max_tokens = 100;
 
     EXPECT_EQ(message.content, "Hello, World!");
-    EXPECT_EQ(message.created, 1729376080);
-    EXPECT_EQ(message.model.value(), "gpt-3.5-turbo");
-    EXPECT_DOUBLE_EQ(message.temperature.value(), 0.7);
-    EXPECT_EQ(message.max_tokens.value(), 100);
-
-    EXPECT_FALSE(message.finish_reason.has_value());
-    EXPECT_FALSE(message.prompt_tokens.has_value());
-    EXPECT_FALSE(message.completion_tokens.has_value());
-    EXPECT_FALSE(message.total_tokens.has_value());
-    EXPECT_FALSE(message.top_p.has_value());
-    EXPECT_FALSE(message.logprobs.has_value());
-    EXPECT_FALSE(message.stream.has_value());
-    EXPECT_FALSE(message.random_seed.has_value());
-    EXPECT_FALSE(message.response_format_type.has_value());
+    EXPECT_EQ(message.getConfig().model.value(), "gpt-3.5-turbo");
+    EXPECT_DOUBLE_EQ(message.getConfig().temperature.value(), 0.7);
+    EXPECT_EQ(message.getConfig().max_tokens.value(), 100);
+
+    EXPECT_FALSE(message.getConfig().top_p.has_value());
+    EXPECT_FALSE(message.getConfig().logprobs.has_value());
+    EXPECT_FALSE(message.getConfig().stream.has_value());
+    EXPECT_FALSE(message.getConfig().random_seed.has_value());
+    EXPECT_FALSE(message.getConfig().response_format_type.has_value());
+
+    // Only responses carry metadata
+    EXPECT_EQ(message.metadata, nullptr);
+    EXPECT_FALSE(message.getMetadata().finish_reason.has_value());
+    EXPECT_FALSE(message.getMetadata().prompt_tokens.has_value());
+    EXPECT_FALSE(message.getMetadata().completion_tokens.has_value());
+    EXPECT_FALSE(message.getMetadata().total_tokens.has_value());
+}
+
+TEST(MessageTest, CopyToSharesConfig) {
+    Message defaults(Message::Type::System);
+    defaults.editConfig().model = "gpt-4o";
+
+    Message plain(Message::Type::User);
+    defaults.copyTo(plain);
+    EXPECT_EQ(plain.config, defaults.config);
+
+    // Settings of its own win; the rest are filled in
+    Message own(Message::Type::User);
+    own.editConfig().temperature = 0.0;
+    own.editConfig().model = "gpt-4o-mini";
+    auto before = own.config;
+    defaults.editConfig().max_tokens = 64;
+    defaults.copyTo(own);
+    EXPECT_EQ(own.getConfig().model.value(), "gpt-4o-mini");
+    EXPECT_EQ(own.getConfig().max_tokens.value(), 64);
+    EXPECT_DOUBLE_EQ(own.getConfig().temperature.value(), 0.0);
+    EXPECT_FALSE(before->max_tokens.has_value());
+}
+
+TEST(MessageTest, EditingConfigLeavesSharersAlone) {
+    Message first(Message::Type::User);
+    first.editConfig().model = "gpt-4o";
+    Message second(Message::Type::User);
+    second.config = first.config;
+
+    second.editConfig().model = "gpt-4o-mini";
+    EXPECT_EQ(first.getConfig().model.value(), "gpt-4o");
+    EXPECT_EQ(second.getConfig().model.value(), "gpt-4o-mini");
+}
+
+TEST(MessageTest, CopiesGetDistinctIds) {
+    Message original(Message::Type::User);
+    Message copy(original);
+    Message assigned(Message::Type::System);
+    std::uint64_t assignedId = assigned.getId();
+    assigned = original;
+
+    EXPECT_NE(original.getId(), copy.getId());
+    EXPECT_NE(assigned.getId(), original.getId());
+    EXPECT_NE(assigned.getId(), assignedId);
 }
 
+
+TEST(MessageTest, CreateAllocatesFromResource) {
+    std::pmr::monotonic_buffer_resource arena;
+    auto message = Message::create(Message::Type::ToolResult, &arena);
+    message->content = std::string(100, 'x');
+    message->tool_call_id.emplace("call_0123456789abcdef", message->get_allocator());
+    message->tool_calls.emplace_back("call_1", "get_weather", std::string(100, 'y'));
+
+    EXPECT_EQ(message->get_allocator().resource(), &arena);
+    EXPECT_EQ(message->content.get_allocator().resource(), &arena);
+    EXPECT_EQ(message->tool_call_id->get_allocator().resource(), &arena);
+    EXPECT_EQ(message->tool_calls[0].arguments.get_allocator().resource(), &arena);
+
+    // Copies don't keep the arena
+    Message copy(*message);
+    EXPECT_EQ(copy.content, message->content);
+    EXPECT_EQ(copy.get_allocator().resource(), std::pmr::get_default_resource());
+}
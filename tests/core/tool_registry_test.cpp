@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include "core/tool_registry.hpp"
+
+namespace {
+
+Tool makeTool(const std::string& name, const std::string& description = "") {
+    Tool tool;
+    tool.name = name;
+    tool.description = description;
+    return tool;
+}
+
+} // namespace
+
+TEST(ToolRegistryTest, FindsToolsByName) {
+    ToolRegistry registry({makeTool("get_weather"), makeTool("get_time")});
+
+    ASSERT_EQ(registry.size(), 2u);
+    ASSERT_NE(registry.find("get_time"), nullptr);
+    EXPECT_EQ(registry.find("get_time")->tool.name, "get_time");
+    EXPECT_EQ(registry.find("get_date"), nullptr);
+    EXPECT_NE(registry.find("get_weather")->id, registry.find("get_time")->id);
+}
+
+TEST(ToolRegistryTest, AddingSameNameReplacesInPlaceWithNewId) {
+    ToolRegistry registry;
+    registry.add(makeTool("get_weather", "old"));
+    registry.add(makeTool("get_time"));
+    auto oldId = registry.find("get_weather")->id;
+
+    registry.add(makeTool("get_weather", "new"));
+
+    ASSERT_EQ(registry.size(), 2u);
+    EXPECT_EQ(registry.entries()[0]->tool.description, "new");
+    EXPECT_EQ(registry.entries()[1]->tool.name, "get_time");
+    EXPECT_EQ(registry.find("get_weather"), registry.entries()[0]);
+    EXPECT_NE(registry.find("get_weather")->id, oldId);
+}
+
+TEST(ToolRegistryTest, EntriesSurviveGrowthAndMoves) {
+    ToolRegistry registry;
+    registry.add(makeTool("tool_0"));
+    const ToolRegistry::Entry* first = registry.find("tool_0");
+    for (int i = 1; i < 1000; ++i) {
+        registry.add(makeTool("tool_" + std::to_string(i)));
+    }
+    EXPECT_EQ(registry.find("tool_0"), first);
+
+    ToolRegistry moved(std::move(registry));
+    EXPECT_EQ(moved.find("tool_0"), first);
+    EXPECT_EQ(moved.find("tool_999")->tool.name, "tool_999");
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include "core/typed_tool.hpp"
+
+namespace {
+
+struct SearchArgs {
+    std::string query;
+    int limit = 0;
+    double threshold = 0;
+    bool exact = false;
+    std::optional<std::string> language;
+
+    static constexpr auto toolFields() {
+        return std::make_tuple(
+            toolField("query", &SearchArgs::query, "What to search for"),
+            toolField("limit", &SearchArgs::limit, "Most results to return"),
+            toolField("threshold", &SearchArgs::threshold),
+            toolField("exact", &SearchArgs::exact),
+            toolField("language", &SearchArgs::language));
+    }
+};
+
+std::string decodeError(const std::string& json) {
+    try {
+        decodeToolArguments<SearchArgs>(json);
+    } catch (const llm::LLMException& e) {
+        return e.what();
+    }
+    return "";
+}
+
+} // namespace
+
+TEST(TypedToolTest, ParametersFollowTheArgumentStruct) {
+    auto parameters = toolParameters<SearchArgs>();
+
+    ASSERT_EQ(parameters.size(), 5u);
+    EXPECT_EQ(parameters[0].name, "query");
+    EXPECT_EQ(parameters[0].type, "string");
+    EXPECT_EQ(parameters[0].description, "What to search for");
+    EXPECT_TRUE(parameters[0].required);
+    EXPECT_EQ(parameters[1].type, "integer");
+    EXPECT_EQ(parameters[2].type, "number");
+    EXPECT_EQ(parameters[3].type, "boolean");
+    EXPECT_EQ(parameters[4].name, "language");
+    EXPECT_EQ(parameters[4].type, "string");
+    EXPECT_FALSE(parameters[4].required);
+}
+
+TEST(TypedToolTest, DecodesArgumentsIntoTheStruct) {
+    auto args = decodeToolArguments<SearchArgs>(
+        R"({"extra": {"nested": [1, {"query": "no"}]}, "query": "weather", "limit": 3,
+            "threshold": 1, "exact": true, "language": "fi"})");
+
+    EXPECT_EQ(args.query, "weather");
+    EXPECT_EQ(args.limit, 3);
+    EXPECT_DOUBLE_EQ(args.threshold, 1.0);
+    EXPECT_TRUE(args.exact);
+    EXPECT_EQ(args.language, "fi");
+
+    args = decodeToolArguments<SearchArgs>(
+        R"({"query": "q", "limit": -1, "threshold": 0.5, "exact": false, "language": null})");
+    EXPECT_EQ(args.limit, -1);
+    EXPECT_EQ(args.language, std::nullopt);
+}
+
+TEST(TypedToolTest, RejectsArgumentsThatDontMatch) {
+    EXPECT_EQ(decodeError(R"({"query": "q", "limit": 1, "threshold": 0.5})"), "missing field \"exact\"");
+    EXPECT_EQ(decodeError(R"({"query": 5})"), "field \"query\" is not of type string");
+    EXPECT_EQ(decodeError(R"({"limit": 1.5})"), "field \"limit\" is not of type integer");
+    EXPECT_EQ(decodeError(R"({"limit": 9999999999})"), "field \"limit\" is out of range");
+    EXPECT_EQ(decodeError(R"({"exact": {}})"), "field \"exact\" is an object");
+    EXPECT_EQ(decodeError(R"(["q"])"), "arguments must be a JSON object");
+    EXPECT_NE(decodeError(R"({"query": )"), "");
+    EXPECT_NE(decodeError(R"({"query": "q"} trailing)"), "");
+}
+
+TEST(TypedToolTest, ToolFunctionReceivesDecodedArguments) {
+    Tool tool = makeTypedTool<SearchArgs>("search", "Searches", [](const SearchArgs& args) {
+        return args.query + " x" + std::to_string(args.limit);
+    });
+
+    EXPECT_EQ(tool.name, "search");
+    EXPECT_EQ(tool.parameters.size(), 5u);
+    EXPECT_EQ(tool.function(R"({"query": "rain", "limit": 2, "threshold": 0, "exact": false})"), "rain x2");
+    EXPECT_EQ(tool.function(R"({"query": "rain"})"),
+              "Error: invalid arguments for tool search: missing field \"limit\"");
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include "http_client/chunk_stream.hpp"
+#include <string>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+using namespace http_client;
+
+TEST(ChunkStreamTest, ReadsChunksAcrossBoundaries) {
+    ChunkStream stream;
+    auto handler = stream.Handler();
+    handler("first li");
+    handler("ne\nsecond line\nthi");
+    handler("rd");
+    handler({});
+
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(stream, line)) {
+        lines.push_back(line);
+    }
+
+    ASSERT_EQ(lines.size(), 3u);
+    EXPECT_EQ(lines[0], "first line");
+    EXPECT_EQ(lines[1], "second line");
+    EXPECT_EQ(lines[2], "third");
+}
+
+TEST(ChunkStreamTest, ReaderBlocksUntilProducerWrites) {
+    ChunkStream stream;
+    auto handler = stream.Handler();
+
+    std::thread producer([&handler]() {
+        for (int i = 0; i < 100; ++i) {
+            handler(std::to_string(i) + "\n");
+        }
+        handler({});
+    });
+
+    int expected = 0;
+    std::string line;
+    while (std::getline(stream, line)) {
+        EXPECT_EQ(line, std::to_string(expected));
+        ++expected;
+    }
+    producer.join();
+
+    EXPECT_EQ(expected, 100);
+}
+
+TEST(ChunkStreamTest, EmptyStreamReportsEof) {
+    ChunkStream stream;
+    stream.Append({});
+
+    std::string line;
+    EXPECT_FALSE(std::getline(stream, line));
+    EXPECT_TRUE(stream.eof());
+}
+
+TEST(ChunkStreamTest, ReadsWhileProducerIsStillWriting) {
+    ChunkStream stream;
+    auto handler = stream.Handler();
+    std::string body(100000, 'x');
+
+    std::thread producer([&handler, &body]() {
+        for (size_t offset = 0; offset < body.size(); offset += 1000) {
+            handler(std::string_view(body).substr(offset, 1000));
+        }
+        handler({});
+    });
+
+    std::string received((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    producer.join();
+
+    EXPECT_EQ(received, body);
+}
@@ -3,7 +3,10 @@
 #include "http_client/ihttp_client.hpp"
 #include "exceptions/llm_exceptions.hpp"
 #include "http_client/curl_http_client.hpp"
+#include "http_client/unix_socket_uri.hpp"
+#include "local_http_server.hpp"
 #include <chrono>
+#include <unistd.h>
 
 using namespace http_client;
 using namespace testing;
@@ -56,3 +59,40 @@ TEST_F(CurlHTTPClientTest, RequestToNonexistentUrlThrowsException) {
         future.get();
     }, llm::HTTPException);
 }
+
+TEST(UnixSocketUriTest, SplitsSocketPathFromUrl) {
+    auto parsed = ParseUnixSocketUri("unix:/run/llm.sock:http://localhost/v1/chat/completions");
+    ASSERT_TRUE(parsed.has_value());
+    EXPECT_EQ(parsed->socketPath, "/run/llm.sock");
+    EXPECT_EQ(parsed->url, "http://localhost/v1/chat/completions");
+
+    auto colons = ParseUnixSocketUri("unix:/tmp/a:b.sock:https://api/v1");
+    ASSERT_TRUE(colons.has_value());
+    EXPECT_EQ(colons->socketPath, "/tmp/a:b.sock");
+    EXPECT_EQ(colons->url, "https://api/v1");
+
+    EXPECT_FALSE(ParseUnixSocketUri("http://localhost/v1").has_value());
+    EXPECT_THROW(ParseUnixSocketUri("unix:/run/llm.sock"), llm::HTTPException);
+    EXPECT_THROW(ParseUnixSocketUri("unix::http://localhost/"), llm::HTTPException);
+}
+
+TEST_F(CurlHTTPClientTest, MalformedUnixSocketUriFailsTheRequest) {
+    EXPECT_THROW(client->Post("unix:/run/llm.sock", "{}").get(), llm::HTTPException);
+}
+
+TEST(CurlHTTPClientUnixSocketTest, PostsOverUnixSocket) {
+    std::string socketPath = TempDir() + "curl_" + std::to_string(::getpid()) + ".sock";
+    std::string received;
+    LocalHTTPServer server(socketPath, [&received](const std::string& request) {
+        received = request;
+        return std::string("over the socket");
+    });
+    CurlHTTPClient client;
+
+    auto response = client.Post(server.uri("/v1/chat/completions"), "{\"x\":1}").get();
+    EXPECT_EQ(response.statusCode, 200);
+    EXPECT_EQ(response.body, "over the socket");
+    EXPECT_THAT(received, StartsWith("POST /v1/chat/completions HTTP/1.1"));
+    EXPECT_THAT(received, HasSubstr("Host: localhost"));
+    EXPECT_THAT(received, EndsWith("{\"x\":1}"));
+}
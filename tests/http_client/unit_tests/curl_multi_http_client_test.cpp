@@ -0,0 +1,240 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "http_client/ihttp_client.hpp"
+#include "exceptions/llm_exceptions.hpp"
+#include "http_client/curl_multi_http_client.hpp"
+#include "local_http_server.hpp"
+#include <chrono>
+#include <thread>
+#include <unistd.h>
+
+using namespace http_client;
+using namespace testing;
+
+class CurlMultiHTTPClientTest : public Test {
+protected:
+    void SetUp() override {
+        client = std::make_unique<CurlMultiHTTPClient>();
+    }
+
+    // Answers every request with the request itself
+    LocalHTTPServer server{[](const std::string& request) { return request; }};
+    std::unique_ptr<IHTTPClient> client;
+};
+
+TEST_F(CurlMultiHTTPClientTest, GetRequestReturnsValidResponse) {
+    auto future = client->Get(server.uri("/resource"));
+    auto response = future.get();
+
+    EXPECT_EQ(response.statusCode, 200);
+    EXPECT_THAT(response.body, StartsWith("GET /resource HTTP/1.1"));
+}
+
+TEST_F(CurlMultiHTTPClientTest, PostRequestSendsData) {
+    std::string body = "test data";
+    auto future = client->Post(server.uri("/post"), body);
+    auto response = future.get();
+
+    EXPECT_EQ(response.statusCode, 200);
+    EXPECT_THAT(response.body, StartsWith("POST /post HTTP/1.1"));
+    EXPECT_THAT(response.body, EndsWith(body));
+}
+
+TEST_F(CurlMultiHTTPClientTest, SetTimeoutChangesTimeout) {
+    auto newTimeout = std::chrono::milliseconds(5000);
+    client->SetTimeout(newTimeout);
+    EXPECT_EQ(client->GetTimeout(), newTimeout);
+}
+
+TEST_F(CurlMultiHTTPClientTest, RequestToNonexistentUrlThrowsException) {
+    EXPECT_THROW({
+        auto future = client->Get("http://thisurldoesnotexist.test");
+        future.get();
+    }, llm::HTTPException);
+}
+
+TEST_F(CurlMultiHTTPClientTest, MalformedUnixSocketUriFailsTheRequest) {
+    int endMarkers = 0;
+    auto future = client->PostStreaming("unix::http://localhost/v1", "{}", {}, [&](std::string_view chunk) {
+        endMarkers += chunk.empty();
+    });
+    EXPECT_THROW(future.get(), llm::HTTPException);
+    EXPECT_EQ(endMarkers, 1);
+}
+
+TEST_F(CurlMultiHTTPClientTest, ConcurrentRequestsAllComplete) {
+    std::vector<std::future<HTTPResponse>> futures;
+    for (int i = 0; i < 32; ++i) {
+        futures.push_back(client->Get("http://thisurldoesnotexist.test/" + std::to_string(i)));
+    }
+
+    for (auto& future : futures) {
+        EXPECT_THROW(future.get(), llm::HTTPException);
+    }
+}
+
+TEST(CurlMultiHTTPClientShutdownTest, DestructorFailsOutstandingRequests) {
+    std::future<HTTPResponse> future;
+    {
+        CurlMultiHTTPClient client;
+        client.SetTimeout(std::chrono::milliseconds(60000));
+        // Non-routable address: the connect attempt stays in flight until shutdown
+        future = client.Get("http://10.255.255.1/");
+    }
+    EXPECT_THROW(future.get(), llm::HTTPException);
+}
+
+TEST(CurlMultiHTTPClientPoolTest, SequentialRequestsReuseConnection) {
+    LocalHTTPServer server;
+    CurlMultiHTTPClient client;
+
+    for (int i = 0; i < 5; ++i) {
+        auto response = client.Post(server.uri("/v1/chat/completions"), "{}").get();
+        EXPECT_EQ(response.statusCode, 200);
+        EXPECT_EQ(response.body, "ok");
+    }
+
+    auto stats = client.GetConnectionStats();
+    EXPECT_EQ(stats.newConnections, 1u);
+    EXPECT_EQ(stats.reusedConnections, 4u);
+    EXPECT_EQ(server.acceptedConnections(), 1);
+}
+
+TEST(CurlMultiHTTPClientPoolTest, ResponsesCarryTransferTiming) {
+    LocalHTTPServer server([](const std::string&) { return std::string(1000, 'x'); });
+    CurlMultiHTTPClient client;
+
+    auto first = client.Post(server.uri("/v1/chat/completions"), "{\"q\":1}").get();
+    EXPECT_FALSE(first.timing.connectionReused);
+    EXPECT_GT(first.timing.total.count(), 0);
+    EXPECT_LE(first.timing.timeToFirstByte, first.timing.total);
+    EXPECT_EQ(first.timing.bytesUploaded, 7u);
+    EXPECT_EQ(first.timing.bytesDownloaded, 1000u);
+
+    auto second = client.Post(server.uri("/v1/chat/completions"), "{}").get();
+    EXPECT_TRUE(second.timing.connectionReused);
+}
+
+TEST(CurlMultiHTTPClientPoolTest, ResponsesCarryHeaders) {
+    LocalHTTPServer server;
+    server.setResponseHeaders({"x-ratelimit-remaining-requests: 59", "Retry-After:  2 "});
+    CurlMultiHTTPClient client;
+
+    auto response = client.Post(server.uri("/v1/chat/completions"), "{}").get();
+    EXPECT_THAT(response.headers, Contains("Content-Type: application/json"));
+    EXPECT_EQ(FindHeader(response.headers, "X-RateLimit-Remaining-Requests"), "59");
+    EXPECT_EQ(FindHeader(response.headers, "retry-after"), "2");
+    EXPECT_EQ(FindHeader(response.headers, "retry"), std::nullopt);
+    EXPECT_THAT(response.headers, Not(Contains(StartsWith("HTTP/"))));
+}
+
+TEST(CurlMultiHTTPClientPoolTest, PerHostLimitCapsConnections) {
+    LocalHTTPServer server;
+    ConnectionPoolOptions options;
+    options.maxConnectionsPerHost = 2;
+    CurlMultiHTTPClient client(options);
+
+    std::vector<std::future<HTTPResponse>> futures;
+    for (int i = 0; i < 10; ++i) {
+        futures.push_back(client.Get(server.uri()));
+    }
+    for (auto& future : futures) {
+        EXPECT_EQ(future.get().statusCode, 200);
+    }
+
+    EXPECT_LE(server.acceptedConnections(), 2);
+    auto stats = client.GetConnectionStats();
+    EXPECT_EQ(stats.newConnections + stats.reusedConnections, 10u);
+}
+
+TEST(CurlMultiHTTPClientStreamingTest, PostStreamingDeliversBodyInChunks) {
+    std::string sse = "data: {\"a\":1}\n\ndata: [DONE]\n\n";
+    LocalHTTPServer server([&sse](const std::string&) { return sse; });
+    CurlMultiHTTPClient client;
+
+    std::string received;
+    int endMarkers = 0;
+    auto future = client.PostStreaming(server.uri(), "{}", {}, [&](std::string_view chunk) {
+        if (chunk.empty()) {
+            ++endMarkers;
+        }
+        received.append(chunk);
+    });
+    auto response = future.get();
+
+    EXPECT_EQ(response.statusCode, 200);
+    EXPECT_TRUE(response.body.empty());
+    EXPECT_EQ(received, sse);
+    EXPECT_EQ(endMarkers, 1);
+}
+
+TEST(CurlMultiHTTPClientStreamingTest, PostStreamingSignalsEndOnFailure) {
+    CurlMultiHTTPClient client;
+
+    int endMarkers = 0;
+    auto future = client.PostStreaming("http://thisurldoesnotexist.test", "{}", {}, [&](std::string_view chunk) {
+        if (chunk.empty()) {
+            ++endMarkers;
+        }
+    });
+
+    EXPECT_THROW(future.get(), llm::HTTPException);
+    EXPECT_EQ(endMarkers, 1);
+}
+
+TEST(CurlMultiHTTPClientCancellationTest, CancelAbortsRequestInFlight) {
+    LocalHTTPServer server([](const std::string&) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        return std::string("late");
+    });
+    CurlMultiHTTPClient client;
+
+    RequestOptions options;
+    options.cancellation = CancellationToken();
+    auto future = client.Post(server.uri(), "{}", {}, options);
+
+    auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    options.cancellation->Cancel();
+    EXPECT_THAT([&future]() { future.get(); },
+                ThrowsMessage<llm::HTTPException>(HasSubstr("Request cancelled")));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(400));
+}
+
+TEST(CurlMultiHTTPClientCancellationTest, DeadlineEndsSlowRequest) {
+    LocalHTTPServer server([](const std::string&) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        return std::string("late");
+    });
+    CurlMultiHTTPClient client;
+
+    RequestOptions options;
+    options.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(50);
+    auto future = client.Post(server.uri(), "{}", {}, options);
+    EXPECT_THAT([&future]() { future.get(); },
+                ThrowsMessage<llm::HTTPException>(HasSubstr("Request deadline exceeded")));
+}
+
+TEST(CurlMultiHTTPClientCancellationTest, CancelledRequestIsNeverSent) {
+    LocalHTTPServer server;
+    CurlMultiHTTPClient client;
+
+    RequestOptions options;
+    options.cancellation = CancellationToken();
+    options.cancellation->Cancel();
+    EXPECT_THROW(client.Post(server.uri(), "{}", {}, options).get(), llm::HTTPException);
+    EXPECT_EQ(server.acceptedConnections(), 0);
+}
+
+TEST(CurlMultiHTTPClientUnixSocketTest, ReusesUnixSocketConnection) {
+    std::string socketPath = TempDir() + "curl_multi_" + std::to_string(::getpid()) + ".sock";
+    LocalHTTPServer server(socketPath, [](const std::string&) { return std::string("ok"); });
+    CurlMultiHTTPClient client;
+
+    for (int i = 0; i < 3; ++i) {
+        auto response = client.Post(server.uri("/v1/chat/completions"), "{}").get();
+        EXPECT_EQ(response.statusCode, 200);
+        EXPECT_EQ(response.body, "ok");
+    }
+    EXPECT_EQ(server.acceptedConnections(), 1);
+}
@@ -0,0 +1,227 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "http_client/hedging_http_client.hpp"
+#include "mock_http_client.hpp"
+#include <chrono>
+#include <thread>
+
+using namespace http_client;
+using namespace testing;
+
+namespace {
+
+const std::vector<std::string> kHeaders = {"Content-Type: application/json"};
+
+RequestOptions Idempotent() {
+    RequestOptions options;
+    options.idempotent = true;
+    return options;
+}
+
+HTTPResponse MakeResponse(std::string body, std::chrono::milliseconds total = std::chrono::milliseconds(0)) {
+    HTTPResponse response;
+    response.statusCode = 200;
+    response.body = std::move(body);
+    response.timing.total = total;
+    return response;
+}
+
+std::future<HTTPResponse> ReadyResponse(std::string body, std::chrono::milliseconds total = std::chrono::milliseconds(0)) {
+    std::promise<HTTPResponse> promise;
+    promise.set_value(MakeResponse(std::move(body), total));
+    return promise.get_future();
+}
+
+HedgingOptions HedgeAfter(std::chrono::milliseconds delay) {
+    HedgingOptions options;
+    options.minSamples = 1000;
+    options.initialDelay = delay;
+    options.maxHedgeFraction = 1.0;
+    return options;
+}
+
+} // namespace
+
+TEST(HedgingHTTPClientTest, RequestsNotMarkedIdempotentAreNotHedged) {
+    auto inner = std::make_shared<MockHTTPClient>();
+    HedgingHTTPClient client(inner, HedgeAfter(std::chrono::milliseconds(1)));
+
+    std::promise<HTTPResponse> slow;
+    EXPECT_CALL(*inner, Post("http://api/v1", "{}", _, _))
+        .WillOnce(InvokeWithoutArgs([&slow]() { return slow.get_future(); }));
+
+    auto pending = client.Post("http://api/v1", "{}", {"Content-Type: application/json"});
+    std::thread answer([&slow]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        slow.set_value(MakeResponse("primary"));
+    });
+    EXPECT_EQ(pending.get().body, "primary");
+    answer.join();
+    EXPECT_EQ(client.GetStats().eligible, 0u);
+}
+
+TEST(HedgingHTTPClientTest, FastResponseIsNotHedged) {
+    auto inner = std::make_shared<MockHTTPClient>();
+    HedgingHTTPClient client(inner, HedgeAfter(std::chrono::milliseconds(200)));
+
+    EXPECT_CALL(*inner, Post(_, _, _, _))
+        .WillOnce(InvokeWithoutArgs([]() { return ReadyResponse("primary"); }));
+
+    EXPECT_EQ(client.Post("http://api/v1", "{}", kHeaders, Idempotent()).get().body, "primary");
+    auto stats = client.GetStats();
+    EXPECT_EQ(stats.eligible, 1u);
+    EXPECT_EQ(stats.hedgesSent, 0u);
+}
+
+TEST(HedgingHTTPClientTest, HedgeAnswersWhenPrimaryStalls) {
+    auto inner = std::make_shared<MockHTTPClient>();
+    HedgingHTTPClient client(inner, HedgeAfter(std::chrono::milliseconds(10)));
+
+    std::promise<HTTPResponse> stalled;
+    RequestOptions primaryOptions;
+    EXPECT_CALL(*inner, Post("http://api/v1", "{}", kHeaders, _))
+        .WillOnce(DoAll(SaveArg<3>(&primaryOptions), InvokeWithoutArgs([&stalled]() { return stalled.get_future(); })))
+        .WillOnce(InvokeWithoutArgs([]() { return ReadyResponse("hedge"); }));
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(client.Post("http://api/v1", "{}", kHeaders, Idempotent()).get().body, "hedge");
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(10));
+
+    auto stats = client.GetStats();
+    EXPECT_EQ(stats.hedgesSent, 1u);
+    EXPECT_EQ(stats.hedgesWon, 1u);
+    EXPECT_TRUE(primaryOptions.IsCancelled());
+
+    // The abandoned request still finishes without disturbing anything
+    stalled.set_value(MakeResponse("primary"));
+}
+
+TEST(HedgingHTTPClientTest, PrimaryCanStillWinAfterHedging) {
+    auto inner = std::make_shared<MockHTTPClient>();
+    HedgingHTTPClient client(inner, HedgeAfter(std::chrono::milliseconds(5)));
+
+    std::promise<HTTPResponse> primary;
+    std::promise<HTTPResponse> hedge;
+    EXPECT_CALL(*inner, Post(_, _, _, _))
+        .WillOnce(InvokeWithoutArgs([&primary]() { return primary.get_future(); }))
+        .WillOnce(InvokeWithoutArgs([&primary, &hedge]() {
+            primary.set_value(MakeResponse("primary"));
+            return hedge.get_future();
+        }));
+
+    EXPECT_EQ(client.Post("http://api/v1", "{}", kHeaders, Idempotent()).get().body, "primary");
+    auto stats = client.GetStats();
+    EXPECT_EQ(stats.hedgesSent, 1u);
+    EXPECT_EQ(stats.hedgesWon, 0u);
+    hedge.set_value(MakeResponse("hedge"));
+}
+
+TEST(HedgingHTTPClientTest, ErrorStatusDoesNotWinTheRace) {
+    auto inner = std::make_shared<MockHTTPClient>();
+    HedgingHTTPClient client(inner, HedgeAfter(std::chrono::milliseconds(5)));
+
+    std::promise<HTTPResponse> primary;
+    std::thread answer;
+    EXPECT_CALL(*inner, Post(_, _, _, _))
+        .WillOnce(InvokeWithoutArgs([&primary]() { return primary.get_future(); }))
+        .WillOnce(InvokeWithoutArgs([&primary, &answer]() {
+            answer = std::thread([&primary]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(30));
+                primary.set_value(MakeResponse("primary"));
+            });
+            HTTPResponse throttled = MakeResponse("slow down");
+            throttled.statusCode = 429;
+            std::promise<HTTPResponse> hedge;
+            hedge.set_value(throttled);
+            return hedge.get_future();
+        }));
+
+    auto response = client.Post("http://api/v1", "{}", kHeaders, Idempotent()).get();
+    answer.join();
+    EXPECT_EQ(response.statusCode, 200);
+    EXPECT_EQ(response.body, "primary");
+    auto stats = client.GetStats();
+    EXPECT_EQ(stats.hedgesSent, 1u);
+    EXPECT_EQ(stats.hedgesWon, 0u);
+}
+
+TEST(HedgingHTTPClientTest, ErrorStatusIsReturnedWhenBothAttemptsFail) {
+    auto inner = std::make_shared<MockHTTPClient>();
+    HedgingHTTPClient client(inner, HedgeAfter(std::chrono::milliseconds(5)));
+
+    std::promise<HTTPResponse> primary;
+    EXPECT_CALL(*inner, Post(_, _, _, _))
+        .WillOnce(InvokeWithoutArgs([&primary]() { return primary.get_future(); }))
+        .WillOnce(InvokeWithoutArgs([&primary]() {
+            primary.set_exception(std::make_exception_ptr(std::runtime_error("reset")));
+            HTTPResponse throttled = MakeResponse("slow down");
+            throttled.statusCode = 429;
+            std::promise<HTTPResponse> hedge;
+            hedge.set_value(throttled);
+            return hedge.get_future();
+        }));
+
+    EXPECT_EQ(client.Post("http://api/v1", "{}", kHeaders, Idempotent()).get().statusCode, 429);
+}
+
+TEST(HedgingHTTPClientTest, DelayFollowsLatencyPercentile) {
+    auto inner = std::make_shared<MockHTTPClient>();
+    HedgingOptions options;
+    options.minSamples = 10;
+    options.percentile = 0.9;
+    HedgingHTTPClient client(inner, options);
+
+    int calls = 0;
+    EXPECT_CALL(*inner, Post(_, _, _, _))
+        .WillRepeatedly(InvokeWithoutArgs([&calls]() {
+            ++calls;
+            return ReadyResponse("ok", std::chrono::milliseconds(calls));
+        }));
+
+    for (int i = 0; i < 100; ++i) {
+        client.Post("http://api/v1", "{}", kHeaders, Idempotent()).get();
+    }
+    client.Post("http://api/v1", "{}", kHeaders, Idempotent()).get();
+
+    auto stats = client.GetStats();
+    EXPECT_EQ(stats.currentDelay, std::chrono::milliseconds(91));
+    EXPECT_EQ(stats.hedgesSent, 0u);
+}
+
+TEST(HedgingHTTPClientTest, CallerCancellationReachesEveryAttempt) {
+    auto inner = std::make_shared<MockHTTPClient>();
+    HedgingHTTPClient client(inner, HedgeAfter(std::chrono::milliseconds(200)));
+
+    std::promise<HTTPResponse> primary;
+    RequestOptions attemptOptions;
+    EXPECT_CALL(*inner, Post(_, _, _, _))
+        .WillOnce(DoAll(SaveArg<3>(&attemptOptions), InvokeWithoutArgs([&primary]() { return primary.get_future(); })));
+
+    RequestOptions options = Idempotent();
+    options.cancellation = CancellationToken();
+    auto pending = client.Post("http://api/v1", "{}", kHeaders, options);
+    EXPECT_FALSE(attemptOptions.IsCancelled());
+    options.cancellation->Cancel();
+    EXPECT_TRUE(attemptOptions.IsCancelled());
+    primary.set_value(MakeResponse("primary"));
+    EXPECT_EQ(pending.get().body, "primary");
+}
+
+TEST(HedgingHTTPClientTest, HedgesWithoutTheCallerReading) {
+    auto inner = std::make_shared<MockHTTPClient>();
+    HedgingHTTPClient client(inner, HedgeAfter(std::chrono::milliseconds(10)));
+
+    std::promise<HTTPResponse> stalled;
+    std::promise<void> hedgeSent;
+    EXPECT_CALL(*inner, Post(_, _, _, _))
+        .WillOnce(InvokeWithoutArgs([&stalled]() { return stalled.get_future(); }))
+        .WillOnce(InvokeWithoutArgs([&hedgeSent]() {
+            hedgeSent.set_value();
+            return ReadyResponse("hedge");
+        }));
+
+    auto pending = client.Post("http://api/v1", "{}", kHeaders, Idempotent());
+    EXPECT_EQ(hedgeSent.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_EQ(pending.get().body, "hedge");
+    stalled.set_value(MakeResponse("primary"));
+}
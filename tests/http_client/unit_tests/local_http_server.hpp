@@ -0,0 +1,62 @@
+#ifndef HTTP_CLIENT_LOCAL_HTTP_SERVER_HPP
+#define HTTP_CLIENT_LOCAL_HTTP_SERVER_HPP
+
+#include "loopback_server.hpp"
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace http_client {
+
+/**
+ * @brief Minimal keep-alive HTTP/1.1 server on 127.0.0.1 for tests
+ *
+ * Listens on an ephemeral loopback port, or on a Unix domain socket when
+ * constructed with a socket path; the sockets are handled by the
+ * benchmarks' bench::LoopbackServer.
+ * Every request is answered with 200 and the body returned by the handler,
+ * plus any headers given to setResponseHeaders().
+ * Connections are held open between requests so connection reuse can be
+ * observed via acceptedConnections().
+ */
+class LocalHTTPServer {
+public:
+    using Handler = std::function<std::string(const std::string& request)>;
+
+    explicit LocalHTTPServer(Handler handler = [](const std::string&) { return std::string("ok"); })
+        : LocalHTTPServer(std::string(), std::move(handler)) {}
+
+    LocalHTTPServer(std::string unixSocketPath, Handler handler)
+        : m_handler(std::move(handler)),
+          m_server(std::move(unixSocketPath),
+                   [this](const bench::LoopbackRequest& request, const bench::LoopbackServer::Send& send) {
+                       return Respond(request, send);
+                   }) {}
+
+    std::string uri(const std::string& path = "/") const { return m_server.uri(path); }
+
+    int acceptedConnections() const { return m_server.acceptedConnections(); }
+
+    // Extra "Name: value" lines sent with every response; set before use
+    void setResponseHeaders(std::vector<std::string> headers) { m_responseHeaders = std::move(headers); }
+
+private:
+    bool Respond(const bench::LoopbackRequest& request, const bench::LoopbackServer::Send& send) {
+        std::string body = m_handler(request.raw);
+        std::string response = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n";
+        for (const auto& header : m_responseHeaders) {
+            response += header + "\r\n";
+        }
+        response += "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+        return send(response);
+    }
+
+    Handler m_handler;
+    std::vector<std::string> m_responseHeaders;
+    // Declared last, so it stops serving before the members above go away
+    bench::LoopbackServer m_server;
+};
+
+} // namespace http_client
+
+#endif // HTTP_CLIENT_LOCAL_HTTP_SERVER_HPP
@@ -10,7 +10,7 @@ class MockHTTPClient : public IHTTPClient {
 public:
     MOCK_METHOD(std::future<HTTPResponse>, Get, (const std::string&, const std::vector<std::string>&), (override));
     MOCK_METHOD(std::future<HTTPResponse>, Put, (const std::string&, const std::string&, const std::vector<std::string>&), (override));
-    MOCK_METHOD(std::future<HTTPResponse>, Post, (const std::string&, const std::string&, const std::vector<std::string>&), (override));
+    MOCK_METHOD(std::future<HTTPResponse>, Post, (const std::string&, const std::string&, const std::vector<std::string>&, const RequestOptions&), (override));
     MOCK_METHOD(std::future<HTTPResponse>, Patch, (const std::string&, const std::string&, const std::vector<std::string>&), (override));
     MOCK_METHOD(std::future<HTTPResponse>, Delete, (const std::string&, const std::vector<std::string>&), (override));
     MOCK_METHOD(void, SetTimeout, (std::chrono::milliseconds), (override));
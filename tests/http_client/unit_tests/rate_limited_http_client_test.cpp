@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "http_client/rate_limited_http_client.hpp"
+#include "mock_http_client.hpp"
+#include <atomic>
+#include <chrono>
+
+using namespace http_client;
+using namespace testing;
+
+namespace {
+
+std::future<HTTPResponse> ReadyResponse(int statusCode, std::string body, std::vector<std::string> headers = {}) {
+    HTTPResponse response;
+    response.statusCode = statusCode;
+    response.headers = std::move(headers);
+    response.body = std::move(body);
+    std::promise<HTTPResponse> promise;
+    promise.set_value(std::move(response));
+    return promise.get_future();
+}
+
+RateLimitOptions FastRetries() {
+    RateLimitOptions options;
+    options.baseBackoff = std::chrono::milliseconds(1);
+    options.maxBackoff = std::chrono::milliseconds(5);
+    return options;
+}
+
+} // namespace
+
+TEST(RateLimitedHTTPClientTest, ParsesRateLimitDurations) {
+    using std::chrono::milliseconds;
+    EXPECT_EQ(RateLimitedHTTPClient::ParseDuration("20ms"), milliseconds(20));
+    EXPECT_EQ(RateLimitedHTTPClient::ParseDuration("1.5s"), milliseconds(1500));
+    EXPECT_EQ(RateLimitedHTTPClient::ParseDuration("6m0s"), milliseconds(360000));
+    EXPECT_EQ(RateLimitedHTTPClient::ParseDuration("1h2m"), milliseconds(3720000));
+    EXPECT_EQ(RateLimitedHTTPClient::ParseDuration(" 3 "), milliseconds(3000));
+    EXPECT_EQ(RateLimitedHTTPClient::ParseDuration(""), std::nullopt);
+    EXPECT_EQ(RateLimitedHTTPClient::ParseDuration("-1"), std::nullopt);
+    EXPECT_EQ(RateLimitedHTTPClient::ParseDuration("Wed, 21 Oct 2015 07:28:00 GMT"), std::nullopt);
+}
+
+TEST(RateLimitedHTTPClientTest, EndpointIsSchemeHostAndPort) {
+    EXPECT_EQ(RateLimitedHTTPClient::EndpointFor("https://api.example.com/v1/chat/completions"),
+              "https://api.example.com");
+    EXPECT_EQ(RateLimitedHTTPClient::EndpointFor("http://127.0.0.1:8080/v1"), "http://127.0.0.1:8080");
+    EXPECT_EQ(RateLimitedHTTPClient::EndpointFor("http://host"), "http://host");
+    EXPECT_EQ(RateLimitedHTTPClient::EndpointFor("unix:/run/llm.sock:http://localhost/v1"), "unix:/run/llm.sock");
+    EXPECT_EQ(RateLimitedHTTPClient::EndpointFor("unix:/run/llm.sock"), "unix:/run/llm.sock");
+}
+
+TEST(RateLimitedHTTPClientTest, TokenEstimateIncludesMaxTokens) {
+    std::string body = "{\"model\":\"m\",\"max_tokens\":100}";
+    EXPECT_DOUBLE_EQ(RateLimitedHTTPClient::EstimateTokens(body), body.size() / 4.0 + 100);
+    EXPECT_DOUBLE_EQ(RateLimitedHTTPClient::EstimateTokens("abcd"), 1.0);
+}
+
+TEST(RateLimitedHTTPClientTest, RetriesTooManyRequestsUntilSuccess) {
+    auto inner = std::make_shared<MockHTTPClient>();
+    RateLimitedHTTPClient client(inner, FastRetries());
+
+    EXPECT_CALL(*inner, Post("http://api/v1", "{}", _, _))
+        .WillOnce(InvokeWithoutArgs([]() { return ReadyResponse(429, "slow down", {"Retry-After: 0"}); }))
+        .WillOnce(InvokeWithoutArgs([]() { return ReadyResponse(503, "busy"); }))
+        .WillOnce(InvokeWithoutArgs([]() { return ReadyResponse(200, "ok"); }));
+
+    auto response = client.Post("http://api/v1", "{}").get();
+    EXPECT_EQ(response.statusCode, 200);
+    EXPECT_EQ(response.body, "ok");
+
+    auto stats = client.GetStats();
+    EXPECT_EQ(stats.requests, 1u);
+    EXPECT_EQ(stats.retries, 2u);
+}
+
+TEST(RateLimitedHTTPClientTest, GivesUpAfterMaxRetries) {
+    auto inner = std::make_shared<MockHTTPClient>();
+    auto options = FastRetries();
+    options.maxRetries = 2;
+    RateLimitedHTTPClient client(inner, options);
+
+    EXPECT_CALL(*inner, Post(_, _, _, _))
+        .Times(3)
+        .WillRepeatedly(InvokeWithoutArgs([]() { return ReadyResponse(502, "bad gateway"); }));
+
+    EXPECT_EQ(client.Post("http://api/v1", "{}").get().statusCode, 502);
+}
+
+TEST(RateLimitedHTTPClientTest, DoesNotRetryClientErrors) {
+    auto inner = std::make_shared<MockHTTPClient>();
+    RateLimitedHTTPClient client(inner, FastRetries());
+
+    EXPECT_CALL(*inner, Post(_, _, _, _))
+        .WillOnce(InvokeWithoutArgs([]() { return ReadyResponse(400, "bad request"); }));
+
+    EXPECT_EQ(client.Post("http://api/v1", "{}").get().statusCode, 400);
+    EXPECT_EQ(client.GetStats().retries, 0u);
+}
+
+TEST(RateLimitedHTTPClientTest, WaitsForResetWhenServerReportsNoneRemaining) {
+    auto inner = std::make_shared<MockHTTPClient>();
+    RateLimitedHTTPClient client(inner, FastRetries());
+
+    EXPECT_CALL(*inner, Post(_, _, _, _))
+        .WillOnce(InvokeWithoutArgs([]() {
+            return ReadyResponse(200, "first", {"x-ratelimit-limit-requests: 60",
+                                                "x-ratelimit-remaining-requests: 0",
+                                                "x-ratelimit-reset-requests: 150ms"});
+        }))
+        .WillOnce(InvokeWithoutArgs([]() { return ReadyResponse(200, "second"); }));
+
+    EXPECT_EQ(client.Post("http://api/v1", "{}").get().body, "first");
+
+    auto start = std::chrono::steady_clock::now();
+    auto pending = client.Post("http://api/v1", "{}");
+    EXPECT_EQ(pending.get().body, "second");
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(140));
+    EXPECT_EQ(client.GetStats().throttled, 1u);
+}
+
+TEST(RateLimitedHTTPClientTest, ConfiguredRateSpacesRequests) {
+    auto inner = std::make_shared<MockHTTPClient>();
+    auto options = FastRetries();
+    // Ten per second once the first minute's burst is used up
+    options.requestsPerMinute = 600;
+    RateLimitedHTTPClient client(inner, options);
+
+    EXPECT_CALL(*inner, Post(_, _, _, _))
+        .WillRepeatedly(InvokeWithoutArgs([]() { return ReadyResponse(200, "ok"); }));
+
+    for (int i = 0; i < 600; ++i) {
+        client.Post("http://api/v1", "").get();
+    }
+    EXPECT_EQ(client.GetStats().throttled, 0u);
+
+    auto start = std::chrono::steady_clock::now();
+    client.Post("http://api/v1", "").get();
+    client.Post("http://api/v1", "").get();
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(90));
+    EXPECT_GE(client.GetStats().throttled, 1u);
+}
+
+TEST(RateLimitedHTTPClientTest, ThrottledRequestIsDispatchedWithoutBeingRead) {
+    auto inner = std::make_shared<MockHTTPClient>();
+    auto options = FastRetries();
+    options.requestsPerMinute = 600;
+    RateLimitedHTTPClient client(inner, options);
+
+    std::atomic<int> sent{0};
+    EXPECT_CALL(*inner, Post(_, _, _, _))
+        .WillRepeatedly(InvokeWithoutArgs([&sent]() {
+            ++sent;
+            return ReadyResponse(200, "ok");
+        }));
+    for (int i = 0; i < 600; ++i) {
+        client.Post("http://api/v1", "").get();
+    }
+
+    auto pending = client.Post("http://api/v1", "");
+    EXPECT_EQ(pending.wait_for(std::chrono::milliseconds(1)), std::future_status::timeout);
+    ASSERT_EQ(pending.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_EQ(sent, 601);
+    EXPECT_EQ(pending.get().body, "ok");
+}
+
+TEST(RateLimitedHTTPClientTest, StreamingRetryDeliversOneEndMarker) {
+    auto inner = std::make_shared<MockHTTPClient>();
+    RateLimitedHTTPClient client(inner, FastRetries());
+
+    // The default PostStreaming goes through Post
+    EXPECT_CALL(*inner, Post(_, _, _, _))
+        .WillOnce(InvokeWithoutArgs([]() { return ReadyResponse(429, "slow down"); }))
+        .WillOnce(InvokeWithoutArgs([]() { return ReadyResponse(200, "data: streamed\n\n"); }));
+
+    std::string received;
+    int endMarkers = 0;
+    auto response = client.PostStreaming("http://api/v1", "{}", {}, [&](std::string_view chunk) {
+        if (chunk.empty()) {
+            ++endMarkers;
+        }
+        received.append(chunk);
+    }).get();
+
+    EXPECT_EQ(response.statusCode, 200);
+    EXPECT_EQ(received, "data: streamed\n\n");
+    EXPECT_EQ(endMarkers, 1);
+}
@@ -0,0 +1,207 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "http_client/recording_http_client.hpp"
+#include "http_client/replay_http_client.hpp"
+#include "exceptions/llm_exceptions.hpp"
+#include "mock_http_client.hpp"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <unistd.h>
+
+using namespace http_client;
+using namespace testing;
+
+namespace {
+
+std::future<HTTPResponse> ReadyResponse(int statusCode, std::string body) {
+    std::promise<HTTPResponse> promise;
+    HTTPResponse response;
+    response.statusCode = statusCode;
+    response.headers = {"Content-Type: application/json"};
+    response.body = std::move(body);
+    promise.set_value(std::move(response));
+    return promise.get_future();
+}
+
+class RecordReplayTest : public Test {
+protected:
+    void SetUp() override {
+        path = (std::filesystem::temp_directory_path() /
+                ("colloquium-cassette-" + std::to_string(::getpid()))).string();
+    }
+    void TearDown() override {
+        std::filesystem::remove(path);
+    }
+
+    std::string path;
+};
+
+} // namespace
+
+TEST_F(RecordReplayTest, ReplaysRecordedExchangesInOrder) {
+    auto inner = std::make_shared<MockHTTPClient>();
+    std::vector<std::string> headers = {"Content-Type: application/json", "Authorization: Bearer secret"};
+    EXPECT_CALL(*inner, Post("http://api/v1", "{\"q\":1}", headers, _))
+        .WillOnce(InvokeWithoutArgs([]() { return ReadyResponse(200, "first"); }))
+        .WillOnce(InvokeWithoutArgs([]() { return ReadyResponse(200, "second"); }));
+    EXPECT_CALL(*inner, Get("http://api/models", _))
+        .WillOnce(InvokeWithoutArgs([]() { return ReadyResponse(404, "missing"); }));
+    {
+        RecordingHTTPClient recorder(inner, path);
+        EXPECT_EQ(recorder.Post("http://api/v1", "{\"q\":1}", headers).get().body, "first");
+        EXPECT_EQ(recorder.Post("http://api/v1", "{\"q\":1}", headers).get().body, "second");
+        EXPECT_EQ(recorder.Get("http://api/models").get().statusCode, 404);
+    }
+
+    ReplayHTTPClient replay(path);
+    EXPECT_EQ(replay.RecordCount(), 3u);
+    EXPECT_EQ(replay.Post("http://api/v1", "{\"q\":1}").get().body, "first");
+    EXPECT_EQ(replay.Post("http://api/v1", "{\"q\":1}").get().body, "second");
+    EXPECT_EQ(replay.Post("http://api/v1", "{\"q\":1}").get().body, "second");
+    auto missing = replay.Get("http://api/models").get();
+    EXPECT_EQ(missing.statusCode, 404);
+    EXPECT_EQ(missing.headers, std::vector<std::string>{"Content-Type: application/json"});
+
+    EXPECT_THROW(replay.Post("http://api/v1", "{\"q\":2}").get(), llm::HTTPException);
+}
+
+TEST_F(RecordReplayTest, RecordsWhenTheTransportCompletes) {
+    auto inner = std::make_shared<MockHTTPClient>();
+    // A transport that does its work before returning the future is timed too
+    EXPECT_CALL(*inner, Post(_, _, _, _)).WillOnce(InvokeWithoutArgs([]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        return ReadyResponse(200, "ok");
+    }));
+    RecordingHTTPClient recorder(inner, path);
+
+    // Not deferred, so it can be waited on with a timeout, and recorded
+    // without anyone calling get()
+    auto pending = recorder.Post("http://api/v1", "{}");
+    ASSERT_EQ(pending.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    CassetteReader cassette(path);
+    ASSERT_EQ(cassette.Records().size(), 1u);
+    EXPECT_GE(cassette.Records()[0].totalTime, std::chrono::milliseconds(50));
+}
+
+TEST_F(RecordReplayTest, NeverRecordsCredentials) {
+    auto inner = std::make_shared<MockHTTPClient>();
+    EXPECT_CALL(*inner, Post(_, _, _, _)).WillOnce(InvokeWithoutArgs([]() { return ReadyResponse(200, "ok"); }));
+    {
+        RecordingHTTPClient recorder(inner, path);
+        recorder.Post("http://api/v1", "{}", {"authorization: Bearer sk-secret", "X-Api-Key: sk-other"}).get();
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(contents.find("sk-secret"), std::string::npos);
+    EXPECT_EQ(contents.find("sk-other"), std::string::npos);
+}
+
+TEST_F(RecordReplayTest, StreamingReplayHonoursContractAndLatency) {
+    auto inner = std::make_shared<MockHTTPClient>();
+    EXPECT_CALL(*inner, Post(_, _, _, _)).WillOnce(InvokeWithoutArgs([]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        return ReadyResponse(200, "data: {}\n\n");
+    }));
+    {
+        RecordingHTTPClient recorder(inner, path);
+        std::string received;
+        recorder.PostStreaming("http://api/v1", "{}", {}, [&](std::string_view chunk) { received.append(chunk); }).get();
+        EXPECT_EQ(received, "data: {}\n\n");
+    }
+
+    ReplayHTTPClient replay(path, true);
+    std::string received;
+    int endMarkers = 0;
+    auto start = std::chrono::steady_clock::now();
+    auto response = replay.PostStreaming("http://api/v1", "{}", {}, [&](std::string_view chunk) {
+        endMarkers += chunk.empty();
+        received.append(chunk);
+    }).get();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_EQ(response.statusCode, 200);
+    EXPECT_TRUE(response.body.empty());
+    EXPECT_EQ(received, "data: {}\n\n");
+    EXPECT_EQ(endMarkers, 1);
+    EXPECT_GE(elapsed, std::chrono::milliseconds(40));
+}
+
+TEST_F(RecordReplayTest, CancellingEndsReplayedLatencyEarly) {
+    auto inner = std::make_shared<MockHTTPClient>();
+    EXPECT_CALL(*inner, Post(_, _, _, _)).WillOnce(InvokeWithoutArgs([]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        return ReadyResponse(200, "slow");
+    }));
+    RecordingHTTPClient(inner, path).Post("http://api/v1", "{}").get();
+
+    ReplayHTTPClient replay(path, true);
+    auto cancelSoon = [](const CancellationToken& token) {
+        return std::thread([token]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            token.Cancel();
+        });
+    };
+
+    RequestOptions options;
+    options.cancellation = CancellationToken();
+    auto start = std::chrono::steady_clock::now();
+    auto canceller = cancelSoon(*options.cancellation);
+    EXPECT_THROW(replay.Post("http://api/v1", "{}", {}, options).get(), llm::HTTPException);
+    canceller.join();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(400));
+
+    options.cancellation = CancellationToken();
+    int endMarkers = 0;
+    start = std::chrono::steady_clock::now();
+    canceller = cancelSoon(*options.cancellation);
+    auto streamed = replay.PostStreaming("http://api/v1", "{}", {}, [&](std::string_view chunk) {
+        endMarkers += chunk.empty();
+    }, options);
+    EXPECT_THROW(streamed.get(), llm::HTTPException);
+    canceller.join();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(400));
+    EXPECT_EQ(endMarkers, 1);
+}
+
+TEST_F(RecordReplayTest, ReplayedLatencyCanBeWaitedOnWithATimeout) {
+    auto inner = std::make_shared<MockHTTPClient>();
+    EXPECT_CALL(*inner, Post(_, _, _, _)).WillOnce(InvokeWithoutArgs([]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        return ReadyResponse(200, "slow");
+    }));
+    RecordingHTTPClient(inner, path).Post("http://api/v1", "{}").get();
+
+    ReplayHTTPClient replay(path, true);
+    auto pending = replay.Post("http://api/v1", "{}");
+    EXPECT_EQ(pending.wait_for(std::chrono::milliseconds(0)), std::future_status::timeout);
+    EXPECT_EQ(pending.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_EQ(pending.get().body, "slow");
+}
+
+TEST_F(RecordReplayTest, RejectsMissingOrCorruptCassette) {
+    EXPECT_THROW(ReplayHTTPClient("/nonexistent/cassette"), llm::HTTPException);
+
+    std::ofstream(path, std::ios::binary) << "CQCASS2\n\x05\x00";
+    EXPECT_THROW(ReplayHTTPClient{path}, llm::HTTPException);
+}
+
+TEST_F(RecordReplayTest, KeepsRecordsBeforeATruncatedOne) {
+    auto inner = std::make_shared<MockHTTPClient>();
+    EXPECT_CALL(*inner, Post(_, _, _, _))
+        .WillOnce(InvokeWithoutArgs([]() { return ReadyResponse(200, "first"); }))
+        .WillOnce(InvokeWithoutArgs([]() { return ReadyResponse(200, "second"); }));
+    {
+        RecordingHTTPClient recorder(inner, path);
+        recorder.Post("http://api/v1", "{\"q\":1}").get();
+        recorder.Post("http://api/v1", "{\"q\":2}").get();
+    }
+    // As if the run had crashed while writing the second response body
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 20);
+
+    ReplayHTTPClient replay(path);
+    EXPECT_EQ(replay.RecordCount(), 1u);
+    EXPECT_EQ(replay.Post("http://api/v1", "{\"q\":1}").get().body, "first");
+}
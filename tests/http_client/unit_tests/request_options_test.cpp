@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include "http_client/request_options.hpp"
+#include "exceptions/llm_exceptions.hpp"
+#include <chrono>
+#include <thread>
+
+using namespace http_client;
+
+TEST(CancellationTokenTest, CopiesShareState) {
+    CancellationToken token;
+    CancellationToken copy = token;
+    EXPECT_FALSE(copy.IsCancelled());
+    token.Cancel();
+    EXPECT_TRUE(copy.IsCancelled());
+}
+
+TEST(CancellationTokenTest, CallbacksRunOnceAndCanBeUnregistered) {
+    CancellationToken token;
+    int kept = 0;
+    int removed = 0;
+    token.OnCancel([&kept]() { ++kept; });
+    auto id = token.OnCancel([&removed]() { ++removed; });
+    token.Unregister(id);
+
+    token.Cancel();
+    token.Cancel();
+    EXPECT_EQ(kept, 1);
+    EXPECT_EQ(removed, 0);
+
+    // Registering after the fact runs the callback at once
+    int late = 0;
+    EXPECT_EQ(token.OnCancel([&late]() { ++late; }), 0u);
+    EXPECT_EQ(late, 1);
+}
+
+TEST(RequestOptionsTest, TimeLeftIsBoundedByDeadline) {
+    using std::chrono::milliseconds;
+    RequestOptions options;
+    EXPECT_EQ(options.TimeLeft(milliseconds(30000)), milliseconds(30000));
+
+    options.deadline = std::chrono::steady_clock::now() + milliseconds(1000);
+    EXPECT_LE(options.TimeLeft(milliseconds(30000)), milliseconds(1000));
+    EXPECT_GT(options.TimeLeft(milliseconds(0)), milliseconds(0));
+    EXPECT_EQ(options.TimeLeft(milliseconds(10)), milliseconds(10));
+
+    // Never zero, which curl would read as no timeout at all
+    options.deadline = std::chrono::steady_clock::now() - milliseconds(1000);
+    EXPECT_GT(options.TimeLeft(milliseconds(30000)), milliseconds(0));
+    EXPECT_TRUE(options.IsExpired());
+}
+
+TEST(RequestOptionsTest, SleepUntilWakesOnCancel) {
+    RequestOptions options;
+    options.cancellation = CancellationToken();
+    std::thread canceller([token = *options.cancellation]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        token.Cancel();
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_THROW(options.SleepUntil(start + std::chrono::seconds(10)), llm::HTTPException);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+    canceller.join();
+}
+
+TEST(RequestOptionsTest, SleepUntilStopsAtDeadline) {
+    RequestOptions options;
+    options.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(20);
+    EXPECT_THROW(options.SleepUntil(std::chrono::steady_clock::now() + std::chrono::seconds(10)),
+                 llm::HTTPException);
+}
@@ -0,0 +1,228 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "http_client/caching_http_client.hpp"
+#include "http_client/response_cache.hpp"
+#include "mock_http_client.hpp"
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+#include <thread>
+
+using namespace http_client;
+using namespace testing;
+
+namespace {
+
+HTTPResponse MakeResponse(int statusCode, std::string body) {
+    HTTPResponse response;
+    response.statusCode = statusCode;
+    response.headers = {"Content-Type: application/json"};
+    response.body = std::move(body);
+    return response;
+}
+
+std::future<HTTPResponse> ReadyResponse(int statusCode, std::string body) {
+    std::promise<HTTPResponse> promise;
+    promise.set_value(MakeResponse(statusCode, std::move(body)));
+    return promise.get_future();
+}
+
+RequestOptions Idempotent() {
+    RequestOptions options;
+    options.idempotent = true;
+    return options;
+}
+
+std::filesystem::path TemporaryDirectory(const std::string& name) {
+    auto path = std::filesystem::temp_directory_path() / (name + "-" + std::to_string(::getpid()));
+    std::filesystem::remove_all(path);
+    return path;
+}
+
+} // namespace
+
+TEST(ResponseCacheTest, KeyDependsOnUriAndBody) {
+    auto key = ResponseCache::KeyFor("http://a/v1", "{\"x\":1}");
+    EXPECT_EQ(key, ResponseCache::KeyFor("http://a/v1", "{\"x\":1}"));
+    EXPECT_NE(key, ResponseCache::KeyFor("http://b/v1", "{\"x\":1}"));
+    EXPECT_NE(key, ResponseCache::KeyFor("http://a/v1", "{\"x\":2}"));
+}
+
+TEST(ResponseCacheTest, EvictsLeastRecentlyUsed) {
+    ResponseCacheOptions options;
+    options.maxEntries = 2;
+    ResponseCache cache(options);
+
+    cache.Store("http://a", "{}", MakeResponse(200, "A"));
+    cache.Store("http://b", "{}", MakeResponse(200, "B"));
+    ASSERT_TRUE(cache.Lookup("http://a", "{}"));  // a is now the most recent
+    cache.Store("http://c", "{}", MakeResponse(200, "C"));
+
+    EXPECT_TRUE(cache.Lookup("http://a", "{}"));
+    EXPECT_FALSE(cache.Lookup("http://b", "{}"));
+    EXPECT_EQ(cache.Lookup("http://c", "{}")->body, "C");
+
+    auto stats = cache.GetStats();
+    EXPECT_EQ(stats.hits, 3u);
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.evictions, 1u);
+}
+
+TEST(ResponseCacheTest, ExpiredEntriesMiss) {
+    ResponseCacheOptions options;
+    options.ttl = std::chrono::seconds(1);
+    ResponseCache cache(options);
+
+    cache.Store("http://a", "{}", MakeResponse(200, "A"));
+    EXPECT_TRUE(cache.Lookup("http://a", "{}"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    EXPECT_FALSE(cache.Lookup("http://a", "{}"));
+}
+
+TEST(ResponseCacheTest, DiskTierSurvivesRestart) {
+    auto directory = TemporaryDirectory("colloquium-cache-test");
+    ResponseCacheOptions options;
+    options.diskDirectory = directory.string();
+    {
+        ResponseCache cache(options);
+        cache.Store("http://api/v1", "{}", MakeResponse(200, "persisted"));
+    }
+
+    ResponseCache reopened(options);
+    auto response = reopened.Lookup("http://api/v1", "{}");
+    ASSERT_TRUE(response);
+    EXPECT_EQ(response->statusCode, 200);
+    EXPECT_EQ(response->body, "persisted");
+    EXPECT_EQ(response->headers, std::vector<std::string>{"Content-Type: application/json"});
+    EXPECT_EQ(reopened.GetStats().diskHits, 1u);
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST(ResponseCacheTest, DiskEntryForAnotherRequestMisses) {
+    auto directory = TemporaryDirectory("colloquium-cache-mismatch-test");
+    ResponseCacheOptions options;
+    options.diskDirectory = directory.string();
+    {
+        ResponseCache cache(options);
+        cache.Store("http://api/v1", "{\"x\":1}", MakeResponse(200, "one"));
+    }
+    // As if the other request's key had collided with this one's
+    std::filesystem::rename(directory / ResponseCache::KeyFor("http://api/v1", "{\"x\":1}"),
+                            directory / ResponseCache::KeyFor("http://api/v1", "{\"x\":2}"));
+
+    ResponseCache reopened(options);
+    EXPECT_FALSE(reopened.Lookup("http://api/v1", "{\"x\":2}"));
+    EXPECT_EQ(reopened.GetStats().misses, 1u);
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST(ResponseCacheTest, CorruptDiskEntriesMiss) {
+    auto directory = TemporaryDirectory("colloquium-cache-corrupt-test");
+    ResponseCacheOptions options;
+    options.diskDirectory = directory.string();
+    {
+        ResponseCache cache(options);
+        cache.Store("http://api/v1", "{}", MakeResponse(200, std::string(100, 'x')));
+    }
+    auto path = directory / ResponseCache::KeyFor("http://api/v1", "{}");
+    auto size = std::filesystem::file_size(path);
+
+    // Cut off mid-body
+    std::filesystem::resize_file(path, size - 10);
+    ResponseCache truncated(options);
+    EXPECT_FALSE(truncated.Lookup("http://api/v1", "{}"));
+
+    // An absurd header count right after the request
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write("CQRC2\n", 6);
+        std::int64_t storedSeconds = 0;
+        std::int32_t statusCode = 200;
+        out.write(reinterpret_cast<const char*>(&storedSeconds), sizeof(storedSeconds));
+        out.write(reinterpret_cast<const char*>(&statusCode), sizeof(statusCode));
+        for (std::string_view value : {std::string_view("http://api/v1"), std::string_view("{}")}) {
+            std::uint64_t length = value.size();
+            out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+            out.write(value.data(), static_cast<std::streamsize>(value.size()));
+        }
+        std::uint64_t headerCount = ~0ull;
+        out.write(reinterpret_cast<const char*>(&headerCount), sizeof(headerCount));
+    }
+    options.ttl = std::chrono::seconds(0);
+    ResponseCache corrupt(options);
+    EXPECT_FALSE(corrupt.Lookup("http://api/v1", "{}"));
+    EXPECT_EQ(corrupt.GetStats().misses, 1u);
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST(CachingHTTPClientTest, RepeatedIdempotentPostIsServedFromCache) {
+    auto inner = std::make_shared<MockHTTPClient>();
+    CachingHTTPClient client(inner, std::make_shared<ResponseCache>());
+
+    EXPECT_CALL(*inner, Post("http://api/v1", "{}", std::vector<std::string>{}, _))
+        .WillOnce(InvokeWithoutArgs([]() { return ReadyResponse(200, "answer"); }));
+
+    EXPECT_EQ(client.Post("http://api/v1", "{}", {}, Idempotent()).get().body, "answer");
+    EXPECT_EQ(client.Post("http://api/v1", "{}", {}, Idempotent()).get().body, "answer");
+    EXPECT_EQ(client.GetCache()->GetStats().hits, 1u);
+}
+
+TEST(CachingHTTPClientTest, StoresResponseTheCallerNeverReads) {
+    auto inner = std::make_shared<MockHTTPClient>();
+    CachingHTTPClient client(inner, std::make_shared<ResponseCache>());
+
+    EXPECT_CALL(*inner, Post("http://api/v1", "{}", std::vector<std::string>{}, _))
+        .WillOnce(InvokeWithoutArgs([]() { return ReadyResponse(200, "answer"); }));
+
+    client.Post("http://api/v1", "{}", {}, Idempotent());
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (client.GetCache()->GetStats().stores == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(client.GetCache()->GetStats().stores, 1u);
+    EXPECT_EQ(client.Post("http://api/v1", "{}", {}, Idempotent()).get().body, "answer");
+}
+
+TEST(CachingHTTPClientTest, DoesNotCacheUnlessIdempotentOrOnError) {
+    auto inner = std::make_shared<MockHTTPClient>();
+    CachingHTTPClient client(inner, std::make_shared<ResponseCache>());
+
+    EXPECT_CALL(*inner, Post("http://api/v1", "{}", std::vector<std::string>{}, _))
+        .Times(2)
+        .WillRepeatedly(InvokeWithoutArgs([]() { return ReadyResponse(200, "answer"); }));
+    client.Post("http://api/v1", "{}").get();
+    client.Post("http://api/v1", "{}").get();
+
+    EXPECT_CALL(*inner, Post("http://api/v1", "[]", std::vector<std::string>{}, _))
+        .Times(2)
+        .WillRepeatedly(InvokeWithoutArgs([]() { return ReadyResponse(500, "oops"); }));
+    client.Post("http://api/v1", "[]", {}, Idempotent()).get();
+    client.Post("http://api/v1", "[]", {}, Idempotent()).get();
+}
+
+TEST(CachingHTTPClientTest, StreamingHitReplaysBody) {
+    auto inner = std::make_shared<MockHTTPClient>();
+    CachingHTTPClient client(inner, std::make_shared<ResponseCache>());
+    std::vector<std::string> headers = {"Content-Type: application/json"};
+
+    // The default PostStreaming goes through Post, so one upstream call
+    EXPECT_CALL(*inner, Post("http://api/v1", "{}", headers, _))
+        .WillOnce(InvokeWithoutArgs([]() { return ReadyResponse(200, "streamed body"); }));
+
+    for (int i = 0; i < 2; ++i) {
+        std::string received;
+        int endMarkers = 0;
+        auto response = client.PostStreaming("http://api/v1", "{}", headers, [&](std::string_view chunk) {
+            if (chunk.empty()) {
+                ++endMarkers;
+            }
+            received.append(chunk);
+        }, Idempotent()).get();
+        EXPECT_EQ(response.statusCode, 200);
+        EXPECT_EQ(received, "streamed body");
+        EXPECT_EQ(endMarkers, 1);
+    }
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include "session/context_policy.hpp"
+
+namespace {
+
+std::unique_ptr<Message> makeMessage(Message::Type type, std::string content) {
+    auto message = std::make_unique<Message>(type);
+    message->content = std::move(content);
+    return message;
+}
+
+std::unique_ptr<Message> makeToolCall(const std::string& id) {
+    auto message = makeMessage(Message::Type::Assistant, "");
+    message->tool_calls.emplace_back(id, "get_weather", "{}");
+    return message;
+}
+
+std::unique_ptr<Message> makeToolResult(const std::string& id, std::string content) {
+    auto message = makeMessage(Message::Type::ToolResult, std::move(content));
+    message->tool_call_id = id;
+    message->name = "get_weather";
+    return message;
+}
+
+} // namespace
+
+TEST(TokenBudgetPolicyTest, SendsEverythingUnderBudget) {
+    std::vector<std::unique_ptr<Message>> conversation;
+    conversation.push_back(makeMessage(Message::Type::System, "Be brief."));
+    conversation.push_back(makeMessage(Message::Type::User, "Hi"));
+
+    TokenBudgetPolicy policy(1000);
+    auto selected = policy.select(conversation);
+    ASSERT_EQ(selected.size(), 2u);
+    EXPECT_EQ(selected[0], conversation[0].get());
+    EXPECT_EQ(selected[1], conversation[1].get());
+}
+
+TEST(TokenBudgetPolicyTest, DropsOldestTurnsButKeepsSystemAndCurrentTurn) {
+    std::vector<std::unique_ptr<Message>> conversation;
+    conversation.push_back(makeMessage(Message::Type::System, "Be brief."));
+    conversation.push_back(makeMessage(Message::Type::User, std::string(400, 'a')));
+    conversation.push_back(makeMessage(Message::Type::Assistant, std::string(400, 'b')));
+    conversation.push_back(makeMessage(Message::Type::User, std::string(40, 'c')));
+    conversation.push_back(makeMessage(Message::Type::Assistant, std::string(40, 'd')));
+    conversation.push_back(makeMessage(Message::Type::User, "Latest"));
+
+    TokenBudgetPolicy policy(100);
+    auto selected = policy.select(conversation);
+    ASSERT_EQ(selected.size(), 4u);
+    EXPECT_EQ(selected[0], conversation[0].get());
+    EXPECT_EQ(selected[1], conversation[3].get());
+    EXPECT_EQ(selected[2], conversation[4].get());
+    EXPECT_EQ(selected[3], conversation[5].get());
+}
+
+TEST(TokenBudgetPolicyTest, DropsToolCallsTogetherWithTheirResults) {
+    std::vector<std::unique_ptr<Message>> conversation;
+    conversation.push_back(makeMessage(Message::Type::User, "Weather?"));
+    conversation.push_back(makeToolCall("call_1"));
+    conversation.push_back(makeToolResult("call_1", std::string(400, 'x')));
+    conversation.push_back(makeMessage(Message::Type::Assistant, "Sunny"));
+    conversation.push_back(makeMessage(Message::Type::User, "Thanks"));
+
+    TokenBudgetPolicy policy(30);
+    auto selected = policy.select(conversation);
+    ASSERT_EQ(selected.size(), 2u);
+    EXPECT_EQ(selected[0], conversation[3].get());
+    EXPECT_EQ(selected[1], conversation[4].get());
+}
+
+TEST(TokenBudgetPolicyTest, TruncatesOversizedToolResultsAndReusesCopies) {
+    std::vector<std::unique_ptr<Message>> conversation;
+    conversation.push_back(makeMessage(Message::Type::User, "Weather?"));
+    conversation.push_back(makeToolCall("call_1"));
+    conversation.push_back(makeToolResult("call_1", std::string(1000, 'x')));
+
+    TokenBudgetPolicy policy(0, 10);
+    auto selected = policy.select(conversation);
+    ASSERT_EQ(selected.size(), 3u);
+    EXPECT_NE(selected[2], conversation[2].get());
+    EXPECT_EQ(std::string_view(selected[2]->content).substr(0, 40), std::string(40, 'x'));
+    EXPECT_NE(selected[2]->content.find("[truncated 960 bytes]"), std::string::npos);
+    EXPECT_EQ(selected[2]->tool_call_id, conversation[2]->tool_call_id);
+
+    auto again = policy.select(conversation);
+    EXPECT_EQ(again[2], selected[2]);
+}
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include "session/endpoint_pool.hpp"
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::unique_ptr<EndpointPool> makePool(std::size_t endpoints, EndpointPool::Options options = EndpointPool::Options()) {
+    auto pool = std::make_unique<EndpointPool>(options);
+    for (std::size_t i = 0; i < endpoints; ++i) {
+        pool->add({"http://replica" + std::to_string(i) + "/v1", std::nullopt});
+    }
+    return pool;
+}
+
+} // namespace
+
+TEST(EndpointPoolTest, LeastOutstandingSpreadsConcurrentRequests) {
+    auto pool = makePool(3);
+    std::vector<EndpointPool::Lease> leases;
+    for (int i = 0; i < 6; ++i) {
+        leases.push_back(pool->acquire());
+    }
+    for (const auto& endpoint : pool->stats()) {
+        EXPECT_EQ(endpoint.outstanding, 2u);
+    }
+    leases.clear();
+    for (const auto& endpoint : pool->stats()) {
+        EXPECT_EQ(endpoint.outstanding, 0u);
+    }
+}
+
+TEST(EndpointPoolTest, EwmaPrefersTheFasterEndpoint) {
+    EndpointPool::Options options;
+    options.strategy = EndpointPool::Strategy::Ewma;
+    auto pool = makePool(2, options);
+
+    // Give each endpoint one latency sample; replica1 is the slow one
+    {
+        auto fast = pool->acquire();
+        auto slow = pool->acquire();
+        ASSERT_EQ(fast.index(), 0u);
+        ASSERT_EQ(slow.index(), 1u);
+        fast.succeeded();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        slow.succeeded();
+    }
+
+    for (int i = 0; i < 5; ++i) {
+        auto lease = pool->acquire();
+        EXPECT_EQ(lease.index(), 0u);
+        lease.succeeded();
+    }
+}
+
+TEST(EndpointPoolTest, FailingEndpointIsEjectedAndReadmitted) {
+    EndpointPool::Options options;
+    options.failureThreshold = 2;
+    options.ejection = std::chrono::milliseconds(50);
+    auto pool = makePool(2, options);
+
+    for (int i = 0; i < 2; ++i) {
+        auto lease = pool->acquire({1});
+        ASSERT_EQ(lease.index(), 0u);
+        lease.failed();
+    }
+    EXPECT_TRUE(pool->stats()[0].ejected);
+    for (int i = 0; i < 4; ++i) {
+        auto lease = pool->acquire();
+        EXPECT_EQ(lease.index(), 1u);
+        lease.succeeded();
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    EXPECT_FALSE(pool->stats()[0].ejected);
+    // On probation: a single failure ejects it again
+    auto probe = pool->acquire({1});
+    ASSERT_EQ(probe.index(), 0u);
+    probe.failed();
+    EXPECT_TRUE(pool->stats()[0].ejected);
+}
+
+TEST(EndpointPoolTest, AllEjectedStillPicksAnEndpoint) {
+    EndpointPool::Options options;
+    options.failureThreshold = 1;
+    auto pool = makePool(2, options);
+    pool->acquire({1}).failed();
+    pool->acquire({0}).failed();
+
+    auto lease = pool->acquire();
+    EXPECT_EQ(lease.index(), 0u);
+}
+
+TEST(EndpointPoolTest, TriedEndpointsAreAvoided) {
+    auto pool = makePool(3);
+    auto first = pool->acquire();
+    auto second = pool->acquire({first.index()});
+    auto third = pool->acquire({first.index(), second.index()});
+    EXPECT_NE(first.index(), second.index());
+    EXPECT_NE(third.index(), first.index());
+    EXPECT_NE(third.index(), second.index());
+}
+
+TEST(EndpointPoolTest, LeaseFromBeforeAClearLeavesNewEndpointsAlone) {
+    auto pool = makePool(1);
+    auto stale = pool->acquire();
+    pool->clear();
+    pool->add({"http://replica0/v1", std::nullopt});
+
+    stale.failed();
+    auto endpoint = pool->stats().at(0);
+    EXPECT_EQ(endpoint.outstanding, 0u);
+    EXPECT_EQ(endpoint.failures, 0u);
+
+    auto fresh = pool->acquire();
+    EXPECT_EQ(pool->stats().at(0).outstanding, 1u);
+}
+
+TEST(EndpointPoolTest, ParsesStrategyNames) {
+    EXPECT_EQ(EndpointPool::parseStrategy("ewma"), EndpointPool::Strategy::Ewma);
+    EXPECT_EQ(EndpointPool::parseStrategy("least-outstanding"), EndpointPool::Strategy::LeastOutstanding);
+    EXPECT_EQ(EndpointPool::parseStrategy("random"), std::nullopt);
+}
@@ -0,0 +1,248 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "session/llm_session.hpp"
+#include "core/streamsource.hpp"
+#include "exceptions/llm_exceptions.hpp"
+#include "../http_client/unit_tests/mock_http_client.hpp"
+#include <map>
+#include <sstream>
+
+using namespace testing;
+
+namespace {
+
+const char* kCompletion = R"({"id":"c1","created":1729376080,"model":"gpt-4o","choices":[{"index":0,)"
+                          R"("message":{"role":"assistant","content":"Sunny."},"finish_reason":"stop"}],)"
+                          R"("usage":{"prompt_tokens":12,"completion_tokens":3,"total_tokens":15}})";
+
+std::future<http_client::HTTPResponse> Completion() {
+    http_client::HTTPResponse response{200, {}, kCompletion, {}};
+    response.timing.timeToFirstByte = std::chrono::microseconds(900);
+    response.timing.total = std::chrono::microseconds(1000);
+    response.timing.connectionReused = true;
+    std::promise<http_client::HTTPResponse> promise;
+    promise.set_value(std::move(response));
+    return promise.get_future();
+}
+
+const char* kToolCallCompletion =
+    R"({"id":"c0","created":1729376079,"model":"gpt-4o","choices":[{"index":0,"message":{"role":"assistant",)"
+    R"("content":"","tool_calls":[{"id":"call_1","type":"function","function":{"name":"get_weather",)"
+    R"("arguments":"{\"location\":\"Paris\"}"}}]},"finish_reason":"tool_calls"}],)"
+    R"("usage":{"prompt_tokens":10,"completion_tokens":8,"total_tokens":18}})";
+
+std::future<http_client::HTTPResponse> ToolCallCompletion() {
+    std::promise<http_client::HTTPResponse> promise;
+    promise.set_value(http_client::HTTPResponse{200, {}, kToolCallCompletion, {}});
+    return promise.get_future();
+}
+
+class LLMSessionTest : public Test {
+protected:
+    void SetUp() override {
+        client = std::make_shared<http_client::MockHTTPClient>();
+        session = std::make_unique<LLMSession>(client);
+        session->setOutput(output);
+        session->setApiKeyResolver([](const std::string&) { return std::string("test-key"); });
+    }
+
+    void run(const std::string& script) {
+        std::istringstream input(script);
+        StreamSource source(input);
+        session->processMessages(source);
+    }
+
+    std::shared_ptr<http_client::MockHTTPClient> client;
+    std::unique_ptr<LLMSession> session;
+    std::ostringstream output;
+};
+
+const std::string kHeader = "#URI http://llm/v1/chat/completions\n#API_KEY_NAME KEY\n#MODEL gpt-4o\n#TRANSLATOR openai\n";
+
+} // namespace
+
+TEST_F(LLMSessionTest, RecordsMetricsForEachTurn) {
+    EXPECT_CALL(*client, Post("http://llm/v1/chat/completions", _, _, _))
+        .Times(2)
+        .WillRepeatedly(InvokeWithoutArgs(Completion));
+
+    run(kHeader + "Weather?\nAnd tomorrow?\n");
+
+    const auto& metrics = session->getTurnMetrics();
+    ASSERT_EQ(metrics.size(), 2u);
+    EXPECT_EQ(metrics[0].conversationIndex, 1u);
+    EXPECT_EQ(metrics[1].conversationIndex, 3u);
+    EXPECT_EQ(metrics[0].promptTokens, 12);
+    EXPECT_EQ(metrics[0].completionTokens, 3);
+    EXPECT_EQ(metrics[0].transfer.total, std::chrono::microseconds(1000));
+    EXPECT_TRUE(metrics[0].transfer.connectionReused);
+    EXPECT_FALSE(metrics[0].streamed);
+}
+
+TEST_F(LLMSessionTest, RequestTimeoutAndRunCancellationReachTransport) {
+    http_client::RequestOptions sent;
+    EXPECT_CALL(*client, Post(_, _, _, _))
+        .WillOnce(DoAll(SaveArg<3>(&sent), InvokeWithoutArgs(Completion)));
+
+    http_client::RequestOptions runOptions;
+    runOptions.cancellation = http_client::CancellationToken();
+    std::istringstream input(kHeader + "#REQUEST_TIMEOUT 5000\nWeather?\n");
+    StreamSource source(input);
+    auto before = std::chrono::steady_clock::now();
+    session->processMessages(source, runOptions);
+
+    ASSERT_TRUE(sent.deadline.has_value());
+    EXPECT_LE(*sent.deadline, std::chrono::steady_clock::now() + std::chrono::milliseconds(5000));
+    EXPECT_GE(*sent.deadline, before + std::chrono::milliseconds(5000));
+    ASSERT_TRUE(sent.cancellation.has_value());
+    runOptions.cancellation->Cancel();
+    EXPECT_TRUE(sent.IsCancelled());
+}
+
+TEST_F(LLMSessionTest, CacheableRequestsAreMarkedIdempotentWithoutAHeader) {
+    std::vector<std::string> headers;
+    http_client::RequestOptions sent;
+    EXPECT_CALL(*client, Post(_, _, _, _))
+        .WillOnce(DoAll(SaveArg<2>(&headers), SaveArg<3>(&sent), InvokeWithoutArgs(Completion)));
+
+    run(kHeader + "#CACHE on\nWeather?\n");
+
+    EXPECT_TRUE(sent.idempotent);
+    EXPECT_THAT(headers, Not(Contains(StartsWith("Idempotency-Key"))));
+}
+
+TEST_F(LLMSessionTest, EndpointPoolFailsOverWithEachEndpointsKey) {
+    std::map<std::string, std::string> keys = {{"KEY_A", "a-key"}, {"KEY_B", "b-key"}};
+    session->setApiKeyResolver([&keys](const std::string& name) { return keys.at(name); });
+
+    EXPECT_CALL(*client, Post("http://a/v1/chat/completions", _, Contains("Authorization: Bearer a-key"), _))
+        .WillOnce(InvokeWithoutArgs([]() {
+            std::promise<http_client::HTTPResponse> promise;
+            promise.set_value(http_client::HTTPResponse{503, {}, "overloaded", {}});
+            return promise.get_future();
+        }));
+    EXPECT_CALL(*client, Post("http://b/v1/chat/completions", _, Contains("Authorization: Bearer b-key"), _))
+        .WillOnce(InvokeWithoutArgs(Completion));
+
+    run("#ENDPOINT http://a/v1/chat/completions KEY_A\n#ENDPOINT http://b/v1/chat/completions KEY_B\n"
+        "#MODEL gpt-4o\n#TRANSLATOR openai\nWeather?\n");
+
+    const auto& metrics = session->getTurnMetrics();
+    ASSERT_EQ(metrics.size(), 1u);
+    EXPECT_EQ(metrics[0].uri, "http://b/v1/chat/completions");
+}
+
+TEST_F(LLMSessionTest, EndpointDirectivesLeaveASharedPoolAlone) {
+    auto shared = std::make_shared<EndpointPool>();
+    shared->add({"http://shared/v1/chat/completions", std::nullopt});
+    session->setEndpointPool(shared);
+
+    EXPECT_CALL(*client, Post("http://local/v1/chat/completions", _, _, _))
+        .WillOnce(InvokeWithoutArgs(Completion));
+
+    run("#API_KEY_NAME KEY\n#ENDPOINT clear\n#ENDPOINT http://local/v1/chat/completions\n#BALANCE ewma\n"
+        "#MODEL gpt-4o\n#TRANSLATOR openai\nWeather?\n");
+
+    auto stats = shared->stats();
+    ASSERT_EQ(stats.size(), 1u);
+    EXPECT_EQ(stats[0].endpoint.uri, "http://shared/v1/chat/completions");
+    EXPECT_EQ(stats[0].requests, 0u);
+}
+
+TEST_F(LLMSessionTest, ClientErrorsAreNotRetriedOnAnotherEndpoint) {
+    EXPECT_CALL(*client, Post(_, _, _, _))
+        .WillOnce(InvokeWithoutArgs([]() {
+            std::promise<http_client::HTTPResponse> promise;
+            promise.set_value(http_client::HTTPResponse{400, {}, "bad request", {}});
+            return promise.get_future();
+        }));
+
+    EXPECT_THROW(run("#API_KEY_NAME KEY\n#ENDPOINT http://a/v1\n#ENDPOINT http://b/v1\n"
+                     "#MODEL gpt-4o\n#TRANSLATOR openai\nWeather?\n"),
+                 llm::HTTPException);
+}
+
+TEST_F(LLMSessionTest, MessagesShareRequestConfigUntilItChanges) {
+    EXPECT_CALL(*client, Post(_, _, _, _))
+        .Times(3)
+        .WillRepeatedly(InvokeWithoutArgs(Completion));
+
+    run(kHeader + "Weather?\nAnd tomorrow?\n#MODEL gpt-4o-mini\nAnd Monday?\n");
+
+    const auto& conversation = session->getConversation();
+    ASSERT_EQ(conversation.size(), 6u);
+    EXPECT_EQ(conversation[0]->config, conversation[2]->config);
+    EXPECT_NE(conversation[2]->config, conversation[4]->config);
+    EXPECT_EQ(conversation[0]->getConfig().model.value(), "gpt-4o");
+    EXPECT_EQ(conversation[4]->getConfig().model.value(), "gpt-4o-mini");
+    EXPECT_EQ(conversation[1]->getMetadata().total_tokens.value(), 15);
+}
+
+TEST_F(LLMSessionTest, ArenaBacksMessagesOnceEnabled) {
+    EXPECT_CALL(*client, Post(_, _, _, _))
+        .Times(2)
+        .WillRepeatedly(InvokeWithoutArgs(Completion));
+
+    run(kHeader + "Weather?\n#ARENA on\nAnd tomorrow?\n");
+
+    const auto& conversation = session->getConversation();
+    ASSERT_EQ(conversation.size(), 4u);
+    auto* heap = std::pmr::get_default_resource();
+    EXPECT_EQ(conversation[0]->get_allocator().resource(), heap);
+    EXPECT_EQ(conversation[1]->get_allocator().resource(), heap);
+    auto* arena = conversation[2]->get_allocator().resource();
+    EXPECT_NE(arena, heap);
+    EXPECT_EQ(conversation[3]->get_allocator().resource(), arena);
+    EXPECT_EQ(conversation[3]->content, "Sunny.");
+}
+
+TEST_F(LLMSessionTest, RunsRequestedToolAndAnswersWithItsResult) {
+    std::string requestBody;
+    EXPECT_CALL(*client, Post(_, _, _, _))
+        .WillOnce(InvokeWithoutArgs(ToolCallCompletion))
+        .WillOnce(DoAll(SaveArg<1>(&requestBody), InvokeWithoutArgs(Completion)));
+
+    Tool tool;
+    tool.name = "get_weather";
+    std::string received;
+    tool.function = [&received](const std::string& arguments) {
+        received = arguments;
+        return std::string("sunny");
+    };
+    session->addTool(tool);
+
+    run(kHeader + "Weather?\n");
+
+    EXPECT_EQ(received, "{\"location\":\"Paris\"}");
+    const auto& conversation = session->getConversation();
+    ASSERT_EQ(conversation.size(), 4u);
+    ASSERT_EQ(conversation[1]->tool_calls.size(), 1u);
+    EXPECT_EQ(conversation[1]->tool_calls[0], ToolCall("call_1", "get_weather", "{\"location\":\"Paris\"}"));
+    EXPECT_EQ(conversation[2]->getType(), ::Message::Type::ToolResult);
+    EXPECT_EQ(conversation[2]->content, "sunny");
+    EXPECT_EQ(conversation[2]->tool_call_id.value(), "call_1");
+    EXPECT_NE(requestBody.find("\"tool_call_id\":\"call_1\""), std::string::npos);
+    EXPECT_EQ(conversation[3]->content, "Sunny.");
+}
+
+TEST_F(LLMSessionTest, ToolsDirectiveNarrowsOfferedTools) {
+    std::vector<std::string> bodies;
+    EXPECT_CALL(*client, Post(_, _, _, _))
+        .Times(3)
+        .WillRepeatedly(DoAll(WithArg<1>([&bodies](const std::string& body) { bodies.push_back(body); }),
+                              InvokeWithoutArgs(Completion)));
+
+    for (const char* name : {"get_weather", "get_time"}) {
+        Tool tool;
+        tool.name = name;
+        session->addTool(tool);
+    }
+
+    run(kHeader + "Weather?\n#TOOLS get_time\nTime?\n#TOOLS all\nBoth?\n");
+
+    ASSERT_EQ(bodies.size(), 3u);
+    EXPECT_NE(bodies[0].find("\"get_weather\""), std::string::npos);
+    EXPECT_EQ(bodies[1].find("\"get_weather\""), std::string::npos);
+    EXPECT_NE(bodies[1].find("\"get_time\""), std::string::npos);
+    EXPECT_NE(bodies[2].find("\"get_weather\""), std::string::npos);
+}
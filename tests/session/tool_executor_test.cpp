@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include "session/tool_executor.hpp"
+#include "exceptions/llm_exceptions.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace {
+
+Tool makeTool(const std::string& name, std::function<std::string(const std::string&)> function) {
+    Tool tool;
+    tool.name = name;
+    tool.function = std::move(function);
+    return tool;
+}
+
+} // namespace
+
+TEST(ToolExecutorTest, RunsCallsConcurrentlyAndKeepsOrder) {
+    ToolExecutor executor(4);
+    Tool slow = makeTool("slow", [](const std::string& args) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        return "slow:" + args;
+    });
+    Tool fast = makeTool("fast", [](const std::string& args) { return "fast:" + args; });
+
+    auto start = std::chrono::steady_clock::now();
+    auto results = executor.run({{&slow, "1"}, {&fast, "2"}, {&slow, "3"}, {&slow, "4"}});
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    std::vector<std::string> expected = {"slow:1", "fast:2", "slow:3", "slow:4"};
+    EXPECT_EQ(results, expected);
+    EXPECT_LT(elapsed, std::chrono::milliseconds(500));
+}
+
+TEST(ToolExecutorTest, RespectsPerToolConcurrencyLimit) {
+    ToolExecutor executor(4);
+    std::atomic<int> running{0};
+    std::atomic<int> peak{0};
+    Tool limited = makeTool("limited", [&](const std::string&) {
+        int now = ++running;
+        int seen = peak.load();
+        while (now > seen && !peak.compare_exchange_weak(seen, now)) {}
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        --running;
+        return std::string("done");
+    });
+    limited.max_concurrency = 1;
+
+    auto results = executor.run({{&limited, ""}, {&limited, ""}, {&limited, ""}});
+    EXPECT_EQ(results.size(), 3u);
+    EXPECT_EQ(peak.load(), 1);
+}
+
+TEST(ToolExecutorTest, TimedOutCallYieldsErrorResult) {
+    ToolExecutor executor(2);
+    Tool hanging = makeTool("hanging", [](const std::string&) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        return std::string("late");
+    });
+    hanging.timeout = std::chrono::milliseconds(20);
+    Tool quick = makeTool("quick", [](const std::string&) { return std::string("ok"); });
+
+    auto results = executor.run({{&hanging, ""}, {&quick, ""}});
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_NE(results[0].find("timed out"), std::string::npos);
+    EXPECT_EQ(results[1], "ok");
+}
+
+TEST(ToolExecutorTest, RethrowsToolException) {
+    ToolExecutor executor(2);
+    Tool failing = makeTool("failing", [](const std::string&) -> std::string {
+        throw llm::LLMException("tool failed");
+    });
+    Tool quick = makeTool("quick", [](const std::string&) { return std::string("ok"); });
+
+    EXPECT_THROW(executor.run({{&quick, ""}, {&failing, ""}}), llm::LLMException);
+}
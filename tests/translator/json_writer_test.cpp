@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include "translator/json_writer.hpp"
+#include "exceptions/llm_exceptions.hpp"
+#include <nlohmann/json.hpp>
+#include <limits>
+
+TEST(JsonWriterTest, EscapesStringsLikeNlohmann) {
+    std::vector<std::string> samples = {
+        "plain",
+        "quote \" and backslash \\",
+        "controls \b\f\n\r\t and \x01\x1f\x7f",
+        "unicode: caf\xc3\xa9, \xe2\x82\xac, \xf0\x9f\x98\x80",
+        "",
+    };
+
+    for (const auto& sample : samples) {
+        std::string out;
+        JsonWriter::appendEscaped(out, sample);
+        EXPECT_EQ(out, nlohmann::json(sample).dump()) << sample;
+    }
+}
+
+TEST(JsonWriterTest, FormatsDoublesLikeNlohmann) {
+    std::vector<double> samples = {
+        0.0, -0.0, 0.7, 0.1, 1.0, -2.5, 3.14159, 100.0, 1e15, 1e16, 1e21,
+        123456789012345680.0, 0.001, 0.0001, 1e-5, 2.2250738585072014e-308,
+        5e-324, 1.7976931348623157e308, 1.0 / 3.0,
+    };
+
+    for (double sample : samples) {
+        std::string out;
+        JsonWriter::appendDouble(out, sample);
+        EXPECT_EQ(out, nlohmann::json(sample).dump()) << sample;
+    }
+
+    std::string out;
+    JsonWriter::appendDouble(out, std::numeric_limits<double>::quiet_NaN());
+    EXPECT_EQ(out, "null");
+}
+
+TEST(JsonWriterTest, WritesNestedStructures) {
+    std::string out = "stale contents";
+    out.clear();
+    JsonWriter writer(out);
+    writer.beginObject();
+    writer.key("a");
+    writer.beginArray();
+    writer.value(1);
+    writer.value(true);
+    writer.value("x");
+    writer.beginObject();
+    writer.endObject();
+    writer.endArray();
+    writer.key("b");
+    writer.raw("{\"c\":null}");
+    writer.endObject();
+
+    EXPECT_EQ(out, R"({"a":[1,true,"x",{}],"b":{"c":null}})");
+}
+
+TEST(JsonWriterTest, RejectsInvalidUtf8) {
+    std::string out;
+    EXPECT_THROW(JsonWriter::appendEscaped(out, "bad \xc3"), llm::TranslationException);
+    EXPECT_THROW(JsonWriter::appendEscaped(out, "overlong \xc0\xaf"), llm::TranslationException);
+    EXPECT_THROW(JsonWriter::appendEscaped(out, "surrogate \xed\xa0\x80"), llm::TranslationException);
+}
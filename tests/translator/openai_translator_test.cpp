@@ -1,6 +1,10 @@
 #include <gtest/gtest.h>
 #include "translator/openai_translator.hpp"
+#ifdef COLLOQUIUM_HAS_SIMDJSON
+#include "translator/simdjson_openai_translator.hpp"
+#endif
 #include <nlohmann/json.hpp>
+#include <sstream>
 
 class OpenAITranslatorTest : public ::testing::Test {
 protected:
@@ -10,7 +14,6 @@ protected:
 TEST_F(OpenAITranslatorTest, MessageToJSON) {
     Message message(Message::Type::User);
     message.content = "Hello, AI!";
-    message.created = 1729376080;
 
     std::string json = translator.toJSON(message);
     auto parsed = nlohmann::json::parse(json);
@@ -67,8 +70,8 @@ TEST_F(OpenAITranslatorTest, CreateRequest) {
     messages.back()->content = "You are a helpful assistant.";
     messages.push_back(std::make_unique<Message>(Message::Type::User));
     messages.back()->content = "What's the weather like?";
-    messages.back()->model = "gpt-3.5-turbo";
-    messages.back()->temperature = 0.7;
+    messages.back()->editConfig().model = "gpt-3.5-turbo";
+    messages.back()->editConfig().temperature = 0.7;
 
     Tool weatherTool;
     weatherTool.name = "get_weather";
@@ -79,7 +82,7 @@ TEST_F(OpenAITranslatorTest, CreateRequest) {
     location.description = "The city and state, e.g. San Francisco, CA";
     weatherTool.parameters = {location};
 
-    std::vector<Tool> tools = {weatherTool};
+    ToolRegistry tools({weatherTool});
 
     std::string json = translator.createRequest(messages, tools);
     auto parsed = nlohmann::json::parse(json);
@@ -96,3 +99,319 @@ TEST_F(OpenAITranslatorTest, CreateRequest) {
     EXPECT_EQ(parsed["tools"][0]["function"]["name"], "get_weather");
 }
 
+TEST_F(OpenAITranslatorTest, StreamToMessageAssemblesContent) {
+    std::istringstream stream(
+        "data: {\"id\":\"c1\",\"created\":1729376080,\"model\":\"gpt-4o\",\"choices\":[{\"index\":0,\"delta\":{\"role\":\"assistant\",\"content\":\"Hel\"},\"finish_reason\":null}]}\n\n"
+        "data: {\"id\":\"c1\",\"created\":1729376080,\"model\":\"gpt-4o\",\"choices\":[{\"index\":0,\"delta\":{\"content\":\"lo!\"},\"finish_reason\":null}]}\n\n"
+        "data: {\"id\":\"c1\",\"created\":1729376080,\"model\":\"gpt-4o\",\"choices\":[{\"index\":0,\"delta\":{},\"finish_reason\":\"stop\"}],"
+        "\"usage\":{\"prompt_tokens\":5,\"completion_tokens\":2,\"total_tokens\":7}}\n\n"
+        "data: [DONE]\n\n");
+
+    std::vector<std::string> tokens;
+    auto message = translator.streamToMessage(stream, [&tokens](const std::string& token) {
+        tokens.push_back(token);
+    });
+
+    EXPECT_EQ(message->getType(), Message::Type::Assistant);
+    EXPECT_EQ(message->content, "Hello!");
+    EXPECT_EQ(message->getMetadata().created, 1729376080);
+    EXPECT_EQ(message->getMetadata().model.value(), "gpt-4o");
+    EXPECT_EQ(message->getMetadata().finish_reason.value(), "stop");
+    EXPECT_EQ(message->getMetadata().total_tokens.value(), 7);
+    std::vector<std::string> expected_tokens = {"Hel", "lo!"};
+    EXPECT_EQ(tokens, expected_tokens);
+}
+
+TEST_F(OpenAITranslatorTest, StreamToMessageAssemblesToolCallDeltas) {
+    std::istringstream stream(
+        "data: {\"created\":1,\"model\":\"m\",\"choices\":[{\"index\":0,\"delta\":{\"role\":\"assistant\",\"content\":null,"
+        "\"tool_calls\":[{\"index\":0,\"id\":\"call_1\",\"type\":\"function\",\"function\":{\"name\":\"get_weather\",\"arguments\":\"\"}}]},\"finish_reason\":null}]}\n\n"
+        "data: {\"created\":1,\"model\":\"m\",\"choices\":[{\"index\":0,\"delta\":{"
+        "\"tool_calls\":[{\"index\":0,\"function\":{\"arguments\":\"{\\\"location\\\":\"}}]},\"finish_reason\":null}]}\n\n"
+        "data: {\"created\":1,\"model\":\"m\",\"choices\":[{\"index\":0,\"delta\":{"
+        "\"tool_calls\":[{\"index\":0,\"function\":{\"arguments\":\"\\\"Paris\\\"}\"}},"
+        "{\"index\":1,\"id\":\"call_2\",\"function\":{\"name\":\"get_time\",\"arguments\":\"{}\"}}]},\"finish_reason\":null}]}\n\n"
+        "data: {\"created\":1,\"model\":\"m\",\"choices\":[{\"index\":0,\"delta\":{},\"finish_reason\":\"tool_calls\"}]}\n\n"
+        "data: [DONE]\n\n");
+
+    auto message = translator.streamToMessage(stream, nullptr);
+
+    EXPECT_EQ(message->getMetadata().finish_reason.value(), "tool_calls");
+    ASSERT_EQ(message->tool_calls.size(), 2u);
+    EXPECT_EQ(message->tool_calls[0].id, "call_1");
+    EXPECT_EQ(message->tool_calls[0].name, "get_weather");
+    EXPECT_EQ(message->tool_calls[0].arguments, "{\"location\":\"Paris\"}");
+    EXPECT_EQ(message->tool_calls[1].id, "call_2");
+    EXPECT_EQ(message->tool_calls[1].name, "get_time");
+}
+
+TEST_F(OpenAITranslatorTest, StreamToMessageRejectsEmptyStream) {
+    std::istringstream stream("");
+    EXPECT_THROW(translator.streamToMessage(stream, nullptr), llm::TranslationException);
+}
+
+TEST_F(OpenAITranslatorTest, CreateRequestMatchesDOMSerialization) {
+    std::vector<std::unique_ptr<Message>> messages;
+    messages.push_back(std::make_unique<Message>(Message::Type::System));
+    messages.back()->content = "You are a helpful assistant.";
+    messages.push_back(std::make_unique<Message>(Message::Type::User));
+    messages.back()->content = "Weather in \"Paris\"?\n";
+    messages.back()->editConfig().model = "gpt-4o";
+    messages.back()->editConfig().temperature = 0.0;
+    messages.back()->editConfig().max_tokens = 256;
+    messages.back()->editConfig().random_seed = 42;
+    messages.back()->editConfig().tool_choice = "auto";
+    messages.back()->editConfig().response_format_type = "text";
+
+    Tool weatherTool;
+    weatherTool.name = "get_weather";
+    weatherTool.description = "Get the current weather for a location";
+    Parameter location;
+    location.name = "location";
+    location.type = "string";
+    location.description = "The city";
+    location.required = true;
+    weatherTool.parameters = {location};
+    ToolRegistry tools({weatherTool});
+
+    nlohmann::json expected;
+    expected["model"] = "gpt-4o";
+    expected["temperature"] = 0.0;
+    expected["max_tokens"] = 256;
+    expected["seed"] = 42;
+    expected["response_format"]["type"] = "text";
+    expected["tool_choice"] = "auto";
+    expected["messages"] = nlohmann::json::array();
+    for (const auto& message : messages) {
+        expected["messages"].push_back(nlohmann::json::parse(translator.toJSON(*message)));
+    }
+    expected["tools"] = nlohmann::json::array({nlohmann::json::parse(translator.toJSON(weatherTool))});
+
+    EXPECT_EQ(translator.createRequest(messages, tools), expected.dump());
+}
+
+TEST_F(OpenAITranslatorTest, CreateRequestReusesCachedMessagesAcrossTurns) {
+    std::vector<std::unique_ptr<Message>> messages;
+    messages.push_back(std::make_unique<Message>(Message::Type::User));
+    messages.back()->content = "first";
+    messages.back()->editConfig().model = "gpt-4o";
+    std::string firstRequest = translator.createRequest(messages, {});
+
+    messages.push_back(std::make_unique<Message>(Message::Type::Assistant));
+    messages.back()->content = "reply";
+    messages.push_back(std::make_unique<Message>(Message::Type::User));
+    messages.back()->content = "second";
+    messages.back()->editConfig().model = "gpt-4o";
+    std::string secondRequest = translator.createRequest(messages, {});
+
+    OpenAITranslator freshTranslator;
+    EXPECT_EQ(secondRequest, freshTranslator.createRequest(messages, {}));
+
+    // A copied message is a new instance and is serialized on its own
+    messages.push_back(std::make_unique<Message>(*messages[1]));
+    messages.back()->content = "edited copy";
+    auto parsed = nlohmann::json::parse(translator.createRequest(messages, {}));
+    EXPECT_EQ(parsed["messages"][1]["content"], "reply");
+    EXPECT_EQ(parsed["messages"][3]["content"], "edited copy");
+}
+
+TEST_F(OpenAITranslatorTest, CreateRequestMatchesDOMForToolsAndToolCalls) {
+    std::vector<std::unique_ptr<Message>> messages;
+    messages.push_back(std::make_unique<Message>(Message::Type::User));
+    messages.back()->content = "Convert 72\xc2\xb0" "F";
+    messages.back()->editConfig().model = "gpt-4o";
+    messages.back()->editConfig().top_p = 0.9;
+    messages.back()->editConfig().stream = false;
+    messages.back()->editConfig().logprobs = 2;
+    messages.push_back(std::make_unique<Message>(Message::Type::Assistant));
+    messages.back()->tool_calls.emplace_back("call_1", "convert", "{\"f\":72}");
+    messages.push_back(std::make_unique<Message>(Message::Type::ToolResult));
+    messages.back()->content = "22.2";
+    messages.back()->name = "convert";
+    messages.back()->tool_call_id = "call_1";
+
+    Tool tool;
+    tool.name = "convert";
+    tool.description = "Unit \"conversion\"";
+    Parameter unit;
+    unit.name = "unit";
+    unit.type = "string";
+    unit.description = "Target unit";
+    unit.enum_values = {"C", "K"};
+    unit.required = true;
+    Parameter fahrenheit;
+    fahrenheit.name = "f";
+    fahrenheit.type = "number";
+    fahrenheit.description = "Degrees";
+    fahrenheit.required = true;
+    tool.parameters = {unit, fahrenheit};
+
+    nlohmann::json expected;
+    expected["model"] = "gpt-4o";
+    expected["top_p"] = 0.9;
+    expected["stream"] = false;
+    expected["logprobs"] = 2;
+    expected["messages"] = nlohmann::json::array();
+    expected["messages"].push_back({{"role", "user"}, {"content", messages[0]->content}});
+    nlohmann::json call;
+    call["id"] = "call_1";
+    call["type"] = "function";
+    call["function"]["name"] = "convert";
+    call["function"]["arguments"] = "{\"f\":72}";
+    expected["messages"].push_back({{"role", "assistant"}, {"content", ""}, {"tool_calls", {call}}});
+    expected["messages"].push_back({{"role", "tool"}, {"content", "22.2"}, {"name", "convert"}, {"tool_call_id", "call_1"}});
+    nlohmann::json toolJSON;
+    toolJSON["type"] = "function";
+    toolJSON["function"]["name"] = "convert";
+    toolJSON["function"]["description"] = tool.description;
+    toolJSON["function"]["parameters"]["type"] = "object";
+    toolJSON["function"]["parameters"]["properties"]["unit"] = {{"type", "string"}, {"description", "Target unit"}, {"enum", {"C", "K"}}};
+    toolJSON["function"]["parameters"]["properties"]["f"] = {{"type", "number"}, {"description", "Degrees"}};
+    toolJSON["function"]["parameters"]["required"] = {"unit", "f"};
+    expected["tools"] = {toolJSON};
+
+    ToolRegistry tools({tool});
+    std::string buffer;
+    translator.createRequest(messages, tools, buffer);
+    EXPECT_EQ(buffer, expected.dump());
+    EXPECT_EQ(translator.createRequest(messages, tools), expected.dump());
+}
+
+namespace {
+const char* kToolCallResponse = R"({
+    "id": "chatcmpl-1",
+    "object": "chat.completion",
+    "created": 1729376080,
+    "model": "gpt-4o",
+    "choices": [{
+        "index": 0,
+        "message": {
+            "role": "assistant",
+            "content": "",
+            "tool_calls": [
+                {"id": "call_1", "type": "function", "function": {"name": "get_weather", "arguments": "{\"location\":\"Paris\"}"}},
+                {"id": "call_2", "type": "function", "function": {"name": "get_time", "arguments": "{}"}}
+            ]
+        },
+        "logprobs": null,
+        "finish_reason": "tool_calls"
+    }],
+    "usage": {"prompt_tokens": 82, "completion_tokens": 17, "total_tokens": 99, "details": {"cached_tokens": 0}}
+})";
+}
+
+TEST_F(OpenAITranslatorTest, StreamedResponseMatchesStringResponse) {
+    auto expected = translator.responseToMessage(std::string(kToolCallResponse));
+
+    std::istringstream stream(kToolCallResponse);
+    auto message = translator.responseToMessage(stream);
+
+    EXPECT_EQ(message->getType(), expected->getType());
+    EXPECT_EQ(message->content, expected->content);
+    EXPECT_EQ(message->getMetadata().created, expected->getMetadata().created);
+    EXPECT_EQ(message->getMetadata().finish_reason, expected->getMetadata().finish_reason);
+    EXPECT_EQ(message->getMetadata().model, expected->getMetadata().model);
+    EXPECT_EQ(message->getMetadata().prompt_tokens, expected->getMetadata().prompt_tokens);
+    EXPECT_EQ(message->getMetadata().completion_tokens, expected->getMetadata().completion_tokens);
+    EXPECT_EQ(message->getMetadata().total_tokens, expected->getMetadata().total_tokens);
+    EXPECT_EQ(message->tool_calls, expected->tool_calls);
+    ASSERT_EQ(message->tool_calls.size(), 2u);
+    EXPECT_EQ(message->tool_calls[0].arguments, "{\"location\":\"Paris\"}");
+}
+
+TEST_F(OpenAITranslatorTest, StreamedResponseRejectsMissingAndMistypedFields) {
+    std::istringstream truncated(R"({"created": 1, "model": "m", "choices": [{"message": {"role": "assistant", "content": "x"})");
+    EXPECT_THROW(translator.responseToMessage(truncated), llm::TranslationException);
+
+    std::istringstream missingUsage(R"({"created": 1, "model": "m", "choices": [{"message": {"role": "assistant", "content": "x"}, "finish_reason": "stop"}]})");
+    EXPECT_THROW(translator.responseToMessage(missingUsage), llm::TranslationException);
+
+    std::istringstream nullContent(R"({"created": 1, "model": "m", "choices": [{"message": {"role": "assistant", "content": null}, "finish_reason": "stop"}],
+        "usage": {"prompt_tokens": 1, "completion_tokens": 1, "total_tokens": 2}})");
+    EXPECT_THROW(translator.responseToMessage(nullContent), llm::TranslationException);
+    EXPECT_THROW(translator.responseToMessage(std::string(nullContent.str())), llm::TranslationException);
+}
+
+
+#ifdef COLLOQUIUM_HAS_SIMDJSON
+TEST_F(OpenAITranslatorTest, SimdjsonResponseMatchesDOMResponse) {
+    SimdjsonOpenAITranslator simdjsonTranslator;
+    auto expected = translator.responseToMessage(std::string(kToolCallResponse));
+    auto message = simdjsonTranslator.responseToMessage(std::string(kToolCallResponse));
+
+    EXPECT_EQ(message->getType(), expected->getType());
+    EXPECT_EQ(message->content, expected->content);
+    EXPECT_EQ(message->getMetadata().created, expected->getMetadata().created);
+    EXPECT_EQ(message->getMetadata().finish_reason, expected->getMetadata().finish_reason);
+    EXPECT_EQ(message->getMetadata().model, expected->getMetadata().model);
+    EXPECT_EQ(message->getMetadata().prompt_tokens, expected->getMetadata().prompt_tokens);
+    EXPECT_EQ(message->getMetadata().completion_tokens, expected->getMetadata().completion_tokens);
+    EXPECT_EQ(message->getMetadata().total_tokens, expected->getMetadata().total_tokens);
+    EXPECT_EQ(message->tool_calls, expected->tool_calls);
+
+    // The parser is reused between calls
+    auto again = simdjsonTranslator.responseToMessage(std::string(kToolCallResponse));
+    EXPECT_EQ(again->tool_calls, expected->tool_calls);
+}
+
+TEST_F(OpenAITranslatorTest, SimdjsonResponseRejectsMissingAndMistypedFields) {
+    SimdjsonOpenAITranslator simdjsonTranslator;
+    EXPECT_THROW(simdjsonTranslator.responseToMessage(std::string(R"({"created": 1, "model": "m")")),
+                 llm::TranslationException);
+    EXPECT_THROW(simdjsonTranslator.responseToMessage(std::string(
+        R"({"created": 1, "model": "m", "choices": [{"message": {"role": "assistant", "content": "x"}, "finish_reason": "stop"}]})")),
+        llm::TranslationException);
+    EXPECT_THROW(simdjsonTranslator.responseToMessage(std::string(
+        R"({"created": 1, "model": "m", "choices": [{"message": {"role": "assistant", "content": null}, "finish_reason": "stop"}],
+            "usage": {"prompt_tokens": 1, "completion_tokens": 1, "total_tokens": 2}})")),
+        llm::TranslationException);
+}
+#endif
+
+TEST_F(OpenAITranslatorTest, OffersOnlyTheToolsTheMessageNames) {
+    Tool weather;
+    weather.name = "get_weather";
+    Tool time;
+    time.name = "get_time";
+    ToolRegistry tools({weather, time});
+
+    std::vector<std::unique_ptr<Message>> messages;
+    messages.push_back(std::make_unique<Message>(Message::Type::User));
+    messages.back()->content = "What time is it?";
+    messages.back()->editConfig().tool_choice = "auto";
+
+    auto all = nlohmann::json::parse(translator.createRequest(messages, tools));
+    ASSERT_EQ(all["tools"].size(), 2u);
+
+    messages.back()->editConfig().tools = std::vector<std::string>{"get_time"};
+    auto subset = nlohmann::json::parse(translator.createRequest(messages, tools));
+    ASSERT_EQ(subset["tools"].size(), 1u);
+    EXPECT_EQ(subset["tools"][0]["function"]["name"], "get_time");
+
+    // No tools at all means no tool_choice either
+    messages.back()->editConfig().tools = std::vector<std::string>{};
+    auto none = nlohmann::json::parse(translator.createRequest(messages, tools));
+    EXPECT_FALSE(none.contains("tools"));
+    EXPECT_FALSE(none.contains("tool_choice"));
+
+    messages.back()->editConfig().tools = std::vector<std::string>{"get_date"};
+    EXPECT_THROW(translator.createRequest(messages, tools), llm::TranslationException);
+}
+
+TEST_F(OpenAITranslatorTest, OffersARepeatedToolOnce) {
+    Tool weather;
+    weather.name = "get_weather";
+    Tool time;
+    time.name = "get_time";
+    ToolRegistry tools({weather, time});
+
+    std::vector<std::unique_ptr<Message>> messages;
+    messages.push_back(std::make_unique<Message>(Message::Type::User));
+    messages.back()->content = "What time is it?";
+    messages.back()->editConfig().tools = std::vector<std::string>{"get_time", "get_weather", "get_time"};
+
+    auto request = nlohmann::json::parse(translator.createRequest(messages, tools));
+    ASSERT_EQ(request["tools"].size(), 2u);
+    EXPECT_EQ(request["tools"][0]["function"]["name"], "get_time");
+    EXPECT_EQ(request["tools"][1]["function"]["name"], "get_weather");
+}
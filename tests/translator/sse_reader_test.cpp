@@ -0,0 +1,38 @@
+#include <gtest/gtest.h>
+#include "translator/sse_reader.hpp"
+#include <sstream>
+
+TEST(SSEReaderTest, ReadsDataEvents) {
+    std::istringstream stream("data: first\n\ndata: second\r\n\r\n");
+    SSEReader reader(stream);
+
+    auto first = reader.next();
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(first->data, "first");
+
+    auto second = reader.next();
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(second->data, "second");
+
+    EXPECT_FALSE(reader.next().has_value());
+}
+
+TEST(SSEReaderTest, JoinsMultiLineDataAndSkipsComments) {
+    std::istringstream stream(": keep-alive\n\nevent: message\ndata: line one\ndata:line two\nid: 7\n\n");
+    SSEReader reader(stream);
+
+    auto event = reader.next();
+    ASSERT_TRUE(event.has_value());
+    EXPECT_EQ(event->event, "message");
+    EXPECT_EQ(event->data, "line one\nline two");
+    EXPECT_FALSE(reader.next().has_value());
+}
+
+TEST(SSEReaderTest, ReturnsTrailingEventWithoutBlankLine) {
+    std::istringstream stream("data: [DONE]");
+    SSEReader reader(stream);
+
+    auto event = reader.next();
+    ASSERT_TRUE(event.has_value());
+    EXPECT_EQ(event->data, "[DONE]");
+}